@@ -28,12 +28,18 @@
 #define MQTT_TOPIC_STATUS   "/esp32cam/status"
 #define MQTT_TOPIC_TELEM    "/esp32cam/telemetry"
 #define MQTT_TOPIC_VERBOSE  "/esp32cam/status_verbose"
+#define MQTT_TOPIC_BASE     "/esp32cam"  // <base>/<key>/set commands, <base>/state, <base>/availability, <base>/boot
+// #define HA_DISCOVERY_PREFIX "homeassistant"  // Home Assistant discovery prefix (default)
+// #define MQTT_TOPIC_PERF  "/esp32cam/perf"   // optional: /api/perf report with each telemetry update
 
 // ---- RTSP ----
 #define RTSP_PORT           8554
 #define RTSP_USER           ""
 #define RTSP_PASSWD         ""
 
+// ---- MJPEG (browser preview) ----
+#define MJPEG_PORT          81
+
 // ---- OTA (ArduinoOTA) ----
 #define OTA_HOSTNAME        DEVICE_NAME // Default is DEVICE_NAME
 #define OTA_PASSWORD        ""
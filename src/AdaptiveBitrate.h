@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Closed-loop JPEG quality / framesize controller.
+ *
+ * Pure logic: the caller feeds cumulative stream counters plus the current
+ * backlog, send time and RSSI, and applies whatever quality/framesize the
+ * controller asks for. Samples are folded into fixed windows; a window is
+ * either congested, clear or neutral, and the controller only moves after
+ * several consecutive windows agree (stepping down reacts faster than
+ * stepping back up). Quality is degraded first; framesize only drops once
+ * quality has hit its ceiling, and is restored first on recovery.
+ *
+ * Quality uses the sensor's scale: lower numbers are better JPEG quality.
+ * Framesizes are the esp_camera framesize_t values, kept as ints here.
+ */
+class AdaptiveBitrate {
+public:
+    static const uint32_t WINDOW_MS          = 2000;
+    static const int      QUALITY_STEP       = 5;
+    static const int      QUALITY_CEILING    = 40;   // worst quality we'll go to
+    static const uint8_t  DOWN_AFTER_WINDOWS = 2;    // congested windows before degrading
+    static const uint8_t  UP_AFTER_WINDOWS   = 5;    // clear windows before improving
+    static const int      RSSI_POOR_DBM      = -80;
+    static const int      RSSI_GOOD_DBM      = -72;
+
+    // Framesize ladder (framesize_t values) used when quality alone isn't
+    // enough: QVGA, VGA, SVGA, XGA, HD, SXGA, UXGA.
+    static const size_t LADDER_LEN = 7;
+
+    struct Sample {
+        uint32_t frames_sent;        // cumulative
+        uint32_t frames_dropped;     // cumulative
+        uint32_t backlog_frames;     // worst per-viewer queue depth right now
+        uint32_t send_ms;            // worst queue-to-last-byte time of a frame
+        uint32_t frame_interval_ms;  // 0 if unknown
+        int      rssi_dbm;
+    };
+
+    enum Reason { NONE, DROPS, BACKLOG, SLOW_SEND, WEAK_SIGNAL, RECOVERED };
+
+    AdaptiveBitrate() { setBase(10, 8); }
+
+    // User-chosen settings; the controller never goes better than these.
+    void setBase(int quality, int framesize) {
+        mBaseQuality   = quality;
+        mBaseFramesize = framesize;
+        mQuality       = quality;
+        mFramesize     = framesize;
+        mCongested     = 0;
+        mClear         = 0;
+        mWindowStart   = 0;
+        mHaveWindow    = false;
+        mReason        = NONE;
+    }
+
+    // Returns true when quality() or framesize() changed and should be applied.
+    bool update(uint32_t now_ms, const Sample& s) {
+        if (!mHaveWindow) startWindow(now_ms, s);
+        // Track the worst instantaneous readings inside the window
+        if (s.backlog_frames > mMaxBacklog) mMaxBacklog = s.backlog_frames;
+        if (s.send_ms > mMaxSendMs)         mMaxSendMs  = s.send_ms;
+        if (s.rssi_dbm < mMinRssi)          mMinRssi    = s.rssi_dbm;
+        if (now_ms - mWindowStart < WINDOW_MS) return false;
+
+        uint32_t sent    = s.frames_sent - mSent0;
+        uint32_t dropped = s.frames_dropped - mDropped0;
+        Reason why = classify(sent, dropped, s.frame_interval_ms);
+        startWindow(now_ms, s);
+
+        if (why == NONE) {                              // neutral window
+            mCongested = 0;
+            mClear = 0;
+            return false;
+        }
+        if (why == RECOVERED) {
+            mCongested = 0;
+            if (++mClear < UP_AFTER_WINDOWS) return false;
+            mClear = 0;
+            return stepUp();
+        }
+        mClear = 0;
+        if (++mCongested < DOWN_AFTER_WINDOWS) return false;
+        mCongested = 0;
+        mReason = why;
+        return stepDown();
+    }
+
+    int    baseQuality()   const { return mBaseQuality; }
+    int    baseFramesize() const { return mBaseFramesize; }
+    int    quality()   const { return mQuality; }
+    int    framesize() const { return mFramesize; }
+    Reason reason()    const { return mReason; }
+
+    // Steps below the base settings, one per stepDown(). The last quality
+    // step may be short (clamped at the ceiling) and still counts, and a
+    // base framesize between ladder sizes counts its first drop.
+    int level() const {
+        int steps = (mQuality - mBaseQuality + QUALITY_STEP - 1) / QUALITY_STEP;
+        for (size_t i = 0; i < LADDER_LEN; ++i) {
+            if (ladder(i) >= mFramesize && ladder(i) < mBaseFramesize) steps++;
+        }
+        return steps;
+    }
+
+    static const char* reasonName(Reason r) {
+        switch (r) {
+        case DROPS:       return "drops";
+        case BACKLOG:     return "backlog";
+        case SLOW_SEND:   return "slow_send";
+        case WEAK_SIGNAL: return "weak_signal";
+        case RECOVERED:   return "recovered";
+        default:          return "none";
+        }
+    }
+
+private:
+    static int ladder(size_t i) {
+        static const int kLadder[LADDER_LEN] = { 5, 8, 9, 10, 11, 12, 13 };
+        return kLadder[i];
+    }
+
+    // Highest ladder entry not above fs
+    static int ladderIndex(int fs) {
+        int idx = 0;
+        for (size_t i = 0; i < LADDER_LEN; ++i) {
+            if (ladder(i) <= fs) idx = (int)i;
+        }
+        return idx;
+    }
+
+    void startWindow(uint32_t now_ms, const Sample& s) {
+        mHaveWindow  = true;
+        mWindowStart = now_ms;
+        mSent0       = s.frames_sent;
+        mDropped0    = s.frames_dropped;
+        // The sample that closed the last window belongs to it alone, or
+        // one congested reading on a boundary would count twice.
+        mMaxBacklog  = 0;
+        mMaxSendMs   = 0;
+        mMinRssi     = 0;
+    }
+
+    Reason classify(uint32_t sent, uint32_t dropped, uint32_t interval_ms) const {
+        uint32_t total = sent + dropped;
+        if (total && dropped * 20 > total)                    return DROPS;       // >5%
+        if (mMaxBacklog >= 2)                                 return BACKLOG;
+        if (interval_ms && mMaxSendMs > interval_ms)          return SLOW_SEND;
+        if (mMinRssi < RSSI_POOR_DBM)                         return WEAK_SIGNAL;
+
+        bool calm = dropped == 0 && mMaxBacklog <= 1 &&
+                    (!interval_ms || mMaxSendMs * 2 < interval_ms) &&
+                    mMinRssi > RSSI_GOOD_DBM;
+        return calm ? RECOVERED : NONE;
+    }
+
+    bool stepDown() {
+        if (mQuality < QUALITY_CEILING) {
+            mQuality += QUALITY_STEP;
+            if (mQuality > QUALITY_CEILING) mQuality = QUALITY_CEILING;
+            return true;
+        }
+        // Next ladder size strictly below the current one
+        for (size_t i = LADDER_LEN; i-- > 0;) {
+            if (ladder(i) < mFramesize) {
+                mFramesize = ladder(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool stepUp() {
+        if (mFramesize < mBaseFramesize) {
+            int idx = ladderIndex(mFramesize);
+            int next = (size_t)(idx + 1) < LADDER_LEN ? ladder(idx + 1) : mBaseFramesize;
+            mFramesize = next > mBaseFramesize ? mBaseFramesize : next;
+            mReason = RECOVERED;
+            return true;
+        }
+        if (mQuality > mBaseQuality) {
+            mQuality -= QUALITY_STEP;
+            if (mQuality < mBaseQuality) mQuality = mBaseQuality;
+            mReason = mQuality == mBaseQuality ? NONE : RECOVERED;
+            return true;
+        }
+        return false;
+    }
+
+    int      mBaseQuality;
+    int      mBaseFramesize;
+    int      mQuality;
+    int      mFramesize;
+    uint8_t  mCongested;
+    uint8_t  mClear;
+    Reason   mReason;
+
+    bool     mHaveWindow;
+    uint32_t mWindowStart;
+    uint32_t mSent0;
+    uint32_t mDropped0;
+    uint32_t mMaxBacklog;
+    uint32_t mMaxSendMs;
+    int      mMinRssi;
+};
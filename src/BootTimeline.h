@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * When each boot phase finished, in ms since reset.
+ *
+ * setup() marks most phases; the capture and control tasks mark the ones
+ * that happen after it returns. Each phase has one writer and is marked
+ * once (later marks are ignored), so plain word stores are enough. Phases
+ * overlap, e.g. WiFi associates while the camera initialises, so the marks
+ * are not in phase order.
+ */
+enum BootPhase {
+    BOOT_SETUP,             // setup() entered
+    BOOT_CONFIG,            // settings blob loaded
+    BOOT_WIFI_START,        // association started
+    BOOT_CAMERA,            // sensor up with the saved settings
+    BOOT_WIFI_UP,           // got an IP address
+    BOOT_SERVICES,          // servers and tasks running, setup() done
+    BOOT_MQTT,              // first broker connection
+    BOOT_FIRST_FRAME,       // first frame in the capture ring
+    BOOT_PHASE_COUNT
+};
+
+static inline const char* boot_phase_name(int phase) {
+    static const char* const names[BOOT_PHASE_COUNT] = {
+        "setup", "config", "wifi_start", "camera", "wifi_up", "services", "mqtt", "first_frame",
+    };
+    return (phase >= 0 && phase < BOOT_PHASE_COUNT) ? names[phase] : "?";
+}
+
+class BootTimeline {
+public:
+    BootTimeline() {
+        for (int i = 0; i < BOOT_PHASE_COUNT; ++i) mAt[i] = 0;
+    }
+
+    void mark(BootPhase p, uint32_t now_ms) {
+        if (p < 0 || p >= BOOT_PHASE_COUNT || mAt[p]) return;
+        mAt[p] = now_ms ? now_ms : 1;
+    }
+
+    bool     has(BootPhase p) const { return mAt[p] != 0; }
+    uint32_t at(BootPhase p)  const { return mAt[p]; }
+
+    // {"setup":312,"config":318,...} in phase order, unmarked phases left
+    // out. Returns the length, or 0 if cap is too small.
+    size_t toJson(char* out, size_t cap) const {
+        size_t n = 0;
+        if (cap < 3) return 0;
+        out[n++] = '{';
+        for (int i = 0; i < BOOT_PHASE_COUNT; ++i) {
+            uint32_t at = mAt[i];
+            if (!at) continue;
+            int w = snprintf(out + n, cap - n, "%s\"%s\":%lu", n > 1 ? "," : "",
+                             boot_phase_name(i), (unsigned long)at);
+            if (w < 0 || (size_t)w >= cap - n) return 0;
+            n += (size_t)w;
+        }
+        if (n + 2 > cap) return 0;
+        out[n++] = '}';
+        out[n] = '\0';
+        return n;
+    }
+
+private:
+    volatile uint32_t mAt[BOOT_PHASE_COUNT];
+};
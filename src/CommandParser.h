@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "JsonDelta.h"
+
+/**
+ * Allocation-free reader for MQTT command payloads.
+ *
+ * One payload holds one or more key/value fields, either as a flat JSON
+ * object or in a compact form:
+ *
+ *   {"brightness":1,"stream":"ON"}
+ *   brightness=1, stream=on          (key=value or key:value; separated by
+ *                                     commas, semicolons, '&' or whitespace)
+ *   start                            (a bare key with an empty value)
+ *
+ * The payload is copied into a caller-owned buffer (MQTT payloads aren't
+ * NUL-terminated) and fields point into that copy; quotes around JSON
+ * strings are stripped. Nested JSON values come through as-is and fail
+ * cmd_int()/cmd_bool().
+ */
+struct CommandField {
+    const char* key;
+    size_t      key_len;
+    const char* value;
+    size_t      value_len;
+};
+
+static inline bool cmd_is(const char* s, size_t len, const char* word) {
+    return strlen(word) == len && strncasecmp(s, word, len) == 0;
+}
+
+// Drops surrounding whitespace and one pair of double quotes.
+static inline void cmd_trim(const char*& s, size_t& len) {
+    while (len && (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n')) { ++s; --len; }
+    while (len && (s[len - 1] == ' ' || s[len - 1] == '\t' || s[len - 1] == '\r' || s[len - 1] == '\n')) --len;
+    if (len >= 2 && s[0] == '"' && s[len - 1] == '"') { ++s; len -= 2; }
+}
+
+// Integer with optional sign; a fractional part ("3.0", as some UIs send
+// numbers) is truncated. False on anything else or overflow.
+static inline bool cmd_int(const char* s, size_t len, long& out) {
+    cmd_trim(s, len);
+    size_t i = 0;
+    bool neg = false;
+    if (i < len && (s[i] == '-' || s[i] == '+')) neg = s[i++] == '-';
+    if (i == len || s[i] < '0' || s[i] > '9') return false;
+    long v = 0;
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; ++i) {
+        if (v > 100000000L) return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    if (i < len && s[i] == '.') {
+        for (++i; i < len && s[i] >= '0' && s[i] <= '9'; ++i) {}
+    }
+    if (i != len) return false;
+    out = neg ? -v : v;
+    return true;
+}
+
+// 1/0, true/false, on/off (any case).
+static inline bool cmd_bool(const char* s, size_t len, bool& out) {
+    cmd_trim(s, len);
+    if (cmd_is(s, len, "1") || cmd_is(s, len, "true") || cmd_is(s, len, "on")) {
+        out = true;
+        return true;
+    }
+    if (cmd_is(s, len, "0") || cmd_is(s, len, "false") || cmd_is(s, len, "off")) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+class CommandReader {
+public:
+    CommandReader(char* buf, size_t buf_len, const uint8_t* payload, size_t len)
+        : mPos(buf), mJson(false), mOk(buf_len > len) {
+        if (!mOk) {
+            if (buf_len) buf[0] = '\0';
+            return;
+        }
+        memcpy(buf, payload, len);
+        buf[len] = '\0';
+        mPos = json_skip_space(buf);
+        if (*mPos == '{') {
+            mJson = true;
+            ++mPos;
+        }
+    }
+
+    // False if the payload didn't fit the buffer (nothing is read then).
+    bool ok() const { return mOk; }
+
+    bool next(CommandField& f) {
+        if (!mOk) return false;
+        return mJson ? nextJson(f) : nextCompact(f);
+    }
+
+private:
+    bool nextJson(CommandField& f) {
+        JsonSpan key, value;
+        if (!json_next_member(mPos, key, value)) return false;
+        f.key = key.p;
+        f.key_len = key.len;
+        f.value = value.p;
+        f.value_len = value.len;
+        cmd_trim(f.key, f.key_len);
+        cmd_trim(f.value, f.value_len);
+        return true;
+    }
+
+    static bool separator(char c) {
+        return c == ',' || c == ';' || c == '&' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool nextCompact(CommandField& f) {
+        while (*mPos && separator(*mPos)) ++mPos;
+        if (!*mPos) return false;
+
+        f.key = mPos;
+        while (*mPos && *mPos != '=' && *mPos != ':' && !separator(*mPos)) ++mPos;
+        f.key_len = (size_t)(mPos - f.key);
+        f.value = mPos;
+        f.value_len = 0;
+        if (*mPos != '=' && *mPos != ':') return true;
+
+        f.value = ++mPos;
+        if (*mPos == '"') {
+            mPos = json_skip_value(mPos);
+        } else {
+            while (*mPos && !separator(*mPos)) ++mPos;
+        }
+        f.value_len = (size_t)(mPos - f.value);
+        cmd_trim(f.value, f.value_len);
+        return true;
+    }
+
+    const char* mPos;
+    bool        mJson;
+    bool        mOk;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * A plain struct stored as one versioned, CRC-checked blob.
+ *
+ * Layout: 12-byte header (magic, version, payload size, CRC-32 of the
+ * payload) followed by the struct's bytes, so all settings come back with
+ * a single NVS read instead of one lookup per key.
+ *
+ * Versioning is append-only: new fields go at the end of T and bump the
+ * version. unpack() copies as much of the stored payload as both sides
+ * have, so an older blob fills the front of T and the new fields keep
+ * whatever the caller initialised them to (the defaults); a newer, longer
+ * blob loads its prefix. The stored version is handed back for anything
+ * that needs converting beyond that.
+ *
+ * T must be trivially copyable and is stored in native byte order. It must
+ * not end in padding: sizeof(T) is what gets stored, so a field appended
+ * where the old T had tail padding would load the old padding bytes
+ * instead of its default. Pad explicitly with reserved fields.
+ */
+template <class T>
+class ConfigBlob {
+public:
+    static const uint32_t MAGIC = 0x47464345;   // "ECFG"
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        uint32_t crc;
+    };
+
+    static const size_t SIZE = sizeof(Header) + sizeof(T);
+
+    enum Result : uint8_t {
+        OK,          // same version and size
+        MIGRATED,    // another version or size; T partly defaults
+        MISSING,     // nothing stored
+        CORRUPT,     // bad magic, size or CRC; T untouched
+    };
+
+    // Writes SIZE bytes to out.
+    static size_t pack(const T& value, uint16_t version, uint8_t* out) {
+        Header h;
+        h.magic   = MAGIC;
+        h.version = version;
+        h.size    = (uint16_t)sizeof(T);
+        h.crc     = crc32(&value, sizeof(T));
+        memcpy(out, &h, sizeof(h));
+        memcpy(out + sizeof(h), &value, sizeof(T));
+        return SIZE;
+    }
+
+    // value holds the defaults on entry. stored_version (optional) gets the
+    // blob's version when the result is OK or MIGRATED.
+    static Result unpack(const uint8_t* in, size_t len, uint16_t version, T& value,
+                         uint16_t* stored_version = nullptr) {
+        if (len == 0) return MISSING;
+        Header h;
+        if (len < sizeof(h)) return CORRUPT;
+        memcpy(&h, in, sizeof(h));
+        if (h.magic != MAGIC || sizeof(h) + h.size != len) return CORRUPT;
+        if (crc32(in + sizeof(h), h.size) != h.crc) return CORRUPT;
+
+        size_t n = h.size < sizeof(T) ? h.size : sizeof(T);
+        memcpy(&value, in + sizeof(h), n);
+        if (stored_version) *stored_version = h.version;
+        return (h.version == version && h.size == sizeof(T)) ? OK : MIGRATED;
+    }
+
+    static const char* resultName(Result r) {
+        switch (r) {
+            case OK:       return "ok";
+            case MIGRATED: return "migrated";
+            case MISSING:  return "missing";
+            case CORRUPT:  return "corrupt";
+        }
+        return "?";
+    }
+
+    // CRC-32 (IEEE), bitwise: a few hundred bytes once per boot/save.
+    static uint32_t crc32(const void* data, size_t len) {
+        const uint8_t* p = (const uint8_t*)data;
+        uint32_t crc = 0xFFFFFFFFu;
+        while (len--) {
+            crc ^= *p++;
+            for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+        return ~crc;
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Frame-rate governor on a monotonic microsecond clock.
+ *
+ * Decides when the next frame should be grabbed for a target rate. Deadlines
+ * advance by whole periods from the previous deadline rather than from the
+ * actual grab time, so the long-run rate doesn't drift with loop latency;
+ * if a grab is more than a period late the schedule restarts from now
+ * instead of bursting to catch up. A target of 0 means "as fast as frames
+ * come".
+ *
+ * Inter-frame interval statistics (min/avg/max) are collected over fixed
+ * windows; the last complete window is what gets reported.
+ */
+class FrameGovernor {
+public:
+    static const uint16_t MAX_FPS         = 60;
+    static const uint64_t STATS_WINDOW_US = 10ULL * 1000 * 1000;
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t min_us;
+        uint32_t avg_us;
+        uint32_t max_us;
+    };
+
+    FrameGovernor() : mTargetFps(0), mPeriodUs(0), mNextUs(0), mLastUs(0) {
+        resetWindow(0);
+        mLast.frames = mLast.min_us = mLast.avg_us = mLast.max_us = 0;
+    }
+
+    void setTargetFps(uint16_t fps) {
+        if (fps > MAX_FPS) fps = MAX_FPS;
+        mTargetFps = fps;
+        mPeriodUs  = fps ? 1000000UL / fps : 0;
+        mNextUs    = 0;                     // take the next frame immediately
+    }
+
+    uint16_t targetFps() const { return mTargetFps; }
+
+    // True when a frame should be grabbed now.
+    bool due(uint64_t now_us) const {
+        return mPeriodUs == 0 || now_us >= mNextUs;
+    }
+
+    // Microseconds until the next frame is due (0 if due now).
+    uint32_t waitUs(uint64_t now_us) const {
+        if (due(now_us)) return 0;
+        return (uint32_t)(mNextUs - now_us);
+    }
+
+    // Record a grabbed frame and schedule the next one.
+    void taken(uint64_t now_us) {
+        if (mPeriodUs) {
+            mNextUs += mPeriodUs;
+            if (mNextUs <= now_us) mNextUs = now_us + mPeriodUs;   // fell a whole period behind
+        }
+
+        if (mLastUs) {
+            uint32_t dt = (uint32_t)(now_us - mLastUs);
+            if (dt < mWin.min_us) mWin.min_us = dt;
+            if (dt > mWin.max_us) mWin.max_us = dt;
+            mWinSumUs += dt;
+            mWin.frames++;
+        }
+        mLastUs = now_us;
+
+        if (now_us - mWinStartUs >= STATS_WINDOW_US) {
+            mLast = mWin;
+            mLast.avg_us = mWin.frames ? (uint32_t)(mWinSumUs / mWin.frames) : 0;
+            if (!mWin.frames) mLast.min_us = 0;
+            resetWindow(now_us);
+        }
+    }
+
+    // Last complete stats window
+    const Stats& stats() const { return mLast; }
+
+    // Achieved rate over the last window, in hundredths of a frame/s
+    uint32_t actualFpsX100() const {
+        return mLast.avg_us ? (uint32_t)(100000000ULL / mLast.avg_us) : 0;
+    }
+
+private:
+    void resetWindow(uint64_t now_us) {
+        mWinStartUs  = now_us;
+        mWinSumUs    = 0;
+        mWin.frames  = 0;
+        mWin.min_us  = UINT32_MAX;
+        mWin.avg_us  = 0;
+        mWin.max_us  = 0;
+    }
+
+    uint16_t mTargetFps;
+    uint32_t mPeriodUs;
+    uint64_t mNextUs;
+    uint64_t mLastUs;
+
+    uint64_t mWinStartUs;
+    uint64_t mWinSumUs;
+    Stats    mWin;
+    Stats    mLast;
+};
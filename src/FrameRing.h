@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Single-producer / multi-consumer ring of refcounted frame handles.
+ *
+ * The capture task is the only producer: it publishes each frame it pulls
+ * from the driver and the ring keeps one reference on the most recent one.
+ * Consumers (RTSP, /snapshot.jpg, ...) take a Ref on the latest frame and
+ * never call the driver themselves. The last Ref to go away hands the frame
+ * back through the release callback, so a slow consumer only pins the frame
+ * it is reading. If every slot is still pinned when a new frame arrives, the
+ * new frame is dropped and counted.
+ *
+ * No locks and no driver types: Frame is opaque, so the same ring builds on
+ * the host with any fake frame type.
+ */
+template <typename Frame, size_t N>
+class FrameRing {
+public:
+    typedef void (*ReleaseFn)(Frame*);
+
+    // Move-only handle on one published frame.
+    class Ref {
+    public:
+        Ref() : mRing(nullptr), mSlot(0) {}
+        Ref(Ref&& other) : mRing(other.mRing), mSlot(other.mSlot) { other.mRing = nullptr; }
+        Ref& operator=(Ref&& other) {
+            if (this != &other) {
+                reset();
+                mRing = other.mRing;
+                mSlot = other.mSlot;
+                other.mRing = nullptr;
+            }
+            return *this;
+        }
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+        ~Ref() { reset(); }
+
+        explicit operator bool() const { return mRing != nullptr; }
+        Frame*   get()     const { return mRing ? mRing->mSlots[mSlot].frame : nullptr; }
+        Frame*   operator->() const { return get(); }
+        uint32_t seq()     const { return mRing ? mRing->mSlots[mSlot].seq : 0; }
+        uint32_t stampMs() const { return mRing ? mRing->mSlots[mSlot].stamp_ms : 0; }
+
+        void reset() {
+            if (mRing) {
+                mRing->unref(mSlot);
+                mRing = nullptr;
+            }
+        }
+
+    private:
+        friend class FrameRing;
+        Ref(FrameRing* ring, size_t slot) : mRing(ring), mSlot(slot) {}
+
+        FrameRing* mRing;
+        size_t     mSlot;
+    };
+
+    explicit FrameRing(ReleaseFn release)
+        : mRelease(release), mLatest(NONE), mNextSeq(1), mPublished(0), mDropped(0)
+    {
+        for (size_t i = 0; i < N; ++i) {
+            mSlots[i].refs.store(0);
+            mSlots[i].frame    = nullptr;
+            mSlots[i].seq      = 0;
+            mSlots[i].stamp_ms = 0;
+        }
+    }
+
+    // ---- Producer side (capture task only) ----
+
+    // Publish a new frame. Ownership passes to the ring either way: when no
+    // slot is free the frame is released immediately and counted as dropped.
+    bool publish(Frame* frame, uint32_t stamp_ms) {
+        size_t slot = N;
+        for (size_t i = 0; i < N; ++i) {
+            int32_t expected = 0;
+            if (mSlots[i].refs.compare_exchange_strong(expected, CLAIMED)) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == N) {
+            mRelease(frame);
+            mDropped.fetch_add(1);
+            return false;
+        }
+
+        Slot& s = mSlots[slot];
+        s.frame    = frame;
+        s.seq      = mNextSeq++;
+        s.stamp_ms = stamp_ms;
+        s.refs.store(1, std::memory_order_release);  // the ring's own reference
+
+        size_t prev = mLatest.exchange(slot);
+        if (prev != NONE) unref(prev);
+        mPublished.fetch_add(1);
+        return true;
+    }
+
+    // Drop the ring's reference on the latest frame (e.g. when capture idles)
+    // so a stale frame is never handed out and the driver gets its buffer back.
+    void clear() {
+        size_t prev = mLatest.exchange(NONE);
+        if (prev != NONE) unref(prev);
+    }
+
+    // ---- Consumer side (any task) ----
+
+    Ref acquireLatest() {
+        for (;;) {
+            size_t slot = mLatest.load();
+            if (slot == NONE) return Ref();
+
+            // Only pin a slot that is still live; 0 means it was just retired
+            // and CLAIMED means the producer is refilling it.
+            int32_t refs = mSlots[slot].refs.load();
+            while (refs > 0) {
+                if (mSlots[slot].refs.compare_exchange_weak(refs, refs + 1,
+                                                            std::memory_order_acquire)) {
+                    return Ref(this, slot);
+                }
+            }
+        }
+    }
+
+    uint32_t latestSeq() const {
+        size_t slot = mLatest.load();
+        return slot == NONE ? 0 : mSlots[slot].seq;
+    }
+
+    uint32_t published() const { return mPublished.load(); }
+    uint32_t dropped()   const { return mDropped.load(); }
+
+private:
+    static const size_t  NONE    = (size_t)-1;
+    static const int32_t CLAIMED = -1;
+
+    struct Slot {
+        std::atomic<int32_t> refs;
+        Frame*   frame;
+        uint32_t seq;
+        uint32_t stamp_ms;
+    };
+
+    void unref(size_t slot) {
+        // Read the frame while still holding a reference; once the count hits
+        // zero the producer may reclaim the slot.
+        Frame* frame = mSlots[slot].frame;
+        if (mSlots[slot].refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            mRelease(frame);
+        }
+    }
+
+    ReleaseFn           mRelease;
+    Slot                mSlots[N];
+    std::atomic<size_t> mLatest;
+    uint32_t            mNextSeq;    // producer-only
+    std::atomic<uint32_t> mPublished;
+    std::atomic<uint32_t> mDropped;
+};
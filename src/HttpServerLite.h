@@ -0,0 +1,724 @@
+#pragma once
+#include <WiFi.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#if defined(ARDUINO)
+#include <HTTP_Method.h>
+#include <lwip/sockets.h>
+#else
+#include <sys/socket.h>
+// Same names and values as http_parser's enum, which HTTP_Method.h uses
+enum HTTPMethod : int { HTTP_DELETE = 0, HTTP_GET = 1, HTTP_HEAD = 2, HTTP_POST = 3, HTTP_PUT = 4 };
+#define HTTP_ANY ((HTTPMethod)255)
+#endif
+
+/**
+ * Non-blocking HTTP/1.1 server with a WebServer-style route API.
+ *
+ * Several connections are served at once from a fixed table: poll() reads
+ * requests and writes responses a bounded number of bytes per connection
+ * and never blocks, so a slow download doesn't hold up the other clients
+ * (or the task that polls). When the table is full, new connections wait in
+ * the listen backlog.
+ *
+ * Handlers run inside poll() and answer with send() like they would with
+ * WebServer. Response headers and bodies up to BODY_MAX are copied into the
+ * connection; send_P() bodies (flash, or buffers that outlive the response)
+ * and sendBorrowed() bodies are sent in place. Every response closes the
+ * connection.
+ *
+ * A handler can instead turn its connection into a Server-Sent Events
+ * stream with beginEvents(); broadcast() then queues an event for every
+ * such subscriber. Each subscriber's queue is its BODY_MAX body buffer: one
+ * that falls that far behind is disconnected (EventSource reconnects and
+ * starts over) rather than buffered for.
+ *
+ * A handler that can't answer yet (e.g. it waits for a camera frame) parks
+ * the request with park() and returns; the polling task later answers it
+ * with resume(), which runs a handler for it as if it had just arrived.
+ * A parked request keeps its method, path and collected headers, not its
+ * args. Meanwhile poll() only watches the connection for the client
+ * leaving, and drops it after RESPONSE_TIMEOUT_MS.
+ *
+ * Not thread-safe: on() before begin(), everything else from the polling task.
+ */
+class HttpServerLite {
+public:
+    typedef void (*Handler)();
+    typedef void (*ReleaseFn)(const uint8_t* data);
+    typedef uint32_t Ticket;                                // a parked request, 0 = none
+
+    static const int      MAX_CLIENTS         = 6;
+    static const int      MAX_EVENT_CLIENTS   = 3;          // leaves room for plain requests
+    static const int      MAX_ROUTES          = 40;
+    static const int      MAX_ARGS            = 12;
+    static const int      MAX_HEADERS         = 4;          // collectHeaders()
+    static const size_t   REQUEST_MAX         = 1536;       // request line, headers and body
+    static const size_t   HEAD_MAX            = 512;        // status line and headers
+    static const size_t   BODY_MAX            = 1536;       // bodies copied by send()
+    static const size_t   BYTES_PER_POLL      = 8 * 1024;   // per client, keeps the others moving
+    static const uint32_t REQUEST_TIMEOUT_MS  = 5000;
+    static const uint32_t RESPONSE_TIMEOUT_MS = 10000;      // without any progress
+    static const uint32_t EVENT_KEEPALIVE_MS  = 15000;      // comment line on idle streams
+
+    explicit HttpServerLite(int port)
+        : mServer(port), mRouteCount(0), mNotFound(nullptr), mHeaderCount(0), mCur(nullptr),
+          mMethod(HTTP_GET), mMethodKnown(false), mPath(""), mArgCount(0), mExtraLen(0),
+          mNextTicket(0), mRequests(0), mTimeouts(0), mRejected(0), mEventsSent(0), mEventDrops(0)
+    {
+        mExtra[0] = '\0';
+        memset(mRoutes, 0, sizeof(mRoutes));
+        memset(mHeaderNames, 0, sizeof(mHeaderNames));
+        memset(mHeaderValues, 0, sizeof(mHeaderValues));
+    }
+
+    ~HttpServerLite() {
+        for (int i = 0; i < MAX_CLIENTS; ++i) closeClient(mClients[i]);
+    }
+
+    HttpServerLite(const HttpServerLite&) = delete;
+    HttpServerLite& operator=(const HttpServerLite&) = delete;
+
+    void on(const char* uri, HTTPMethod method, Handler fn) {
+        if (mRouteCount == MAX_ROUTES) return;
+        mRoutes[mRouteCount].uri    = uri;
+        mRoutes[mRouteCount].method = method;
+        mRoutes[mRouteCount].fn     = fn;
+        mRouteCount++;
+    }
+    void on(const char* uri, Handler fn) { on(uri, HTTP_ANY, fn); }
+
+    void onNotFound(Handler fn) { mNotFound = fn; }
+
+    // Request headers handlers may read with header()
+    void collectHeaders(const char* names[], size_t count) {
+        mHeaderCount = count < (size_t)MAX_HEADERS ? (int)count : MAX_HEADERS;
+        for (int i = 0; i < mHeaderCount; ++i) mHeaderNames[i] = names[i];
+    }
+
+    void begin() {
+        mServer.begin();
+        mServer.setNoDelay(true);
+    }
+
+    // Bounded, non-blocking service of all clients.
+    void poll() {
+        acceptAll();
+        uint32_t now = millis();
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (!c.active) continue;
+            bool ok = c.events  ? serviceEvents(c, now)
+                    : c.sending ? serviceResponse(c, now)
+                    : c.parked  ? serviceParked(c, now)
+                    : readRequest(c, now);
+            if (!ok) closeClient(c);
+        }
+    }
+
+    // ---- Request, valid inside a handler ----
+    HTTPMethod  method() const { return mMethod; }
+    const char* uri()    const { return mPath; }
+
+    bool hasArg(const char* name) const { return findArg(name) >= 0; }
+
+    // Decoded query/form value, "plain" for a non-form body; "" when absent.
+    const char* argValue(const char* name) const {
+        int i = findArg(name);
+        return i >= 0 ? mArgValues[i] : "";
+    }
+
+    bool hasHeader(const char* name) const { return headerValue(name)[0] != '\0'; }
+
+    // A collected request header; "" when absent or not collected.
+    const char* headerValue(const char* name) const {
+        for (int i = 0; i < mHeaderCount; ++i) {
+            if (strcasecmp(mHeaderNames[i], name) == 0) return mHeaderValues[i] ? mHeaderValues[i] : "";
+        }
+        return "";
+    }
+
+    // ---- Response, inside a handler ----
+    void sendHeader(const char* name, const char* value) {
+        int n = snprintf(mExtra + mExtraLen, sizeof(mExtra) - mExtraLen, "%s: %s\r\n", name, value);
+        if (n > 0 && (size_t)n < sizeof(mExtra) - mExtraLen) mExtraLen += (size_t)n;
+        else mExtra[mExtraLen] = '\0';                  // doesn't fit: dropped
+    }
+
+    void send(int code, const char* type = nullptr, const char* content = nullptr) {
+        send(code, type, content, content ? strlen(content) : 0);
+    }
+
+    // Copies the body; anything over BODY_MAX is answered with a 500.
+    void send(int code, const char* type, const char* content, size_t len) {
+        if (!mCur || mCur->sending) return;
+        if (len > BODY_MAX) {
+            mExtraLen = 0;
+            mExtra[0] = '\0';
+            static const char msg[] = "Response too large";
+            respond(500, "text/plain", (const uint8_t*)msg, sizeof(msg) - 1);
+            return;
+        }
+        if (len) memcpy(mCur->body, content, len);
+        respond(code, type, (const uint8_t*)mCur->body, len);
+    }
+
+    // The body is sent in place and must stay valid until the connection
+    // is done with it (flash, or a buffer that is never rewritten).
+    void send_P(int code, const char* type, const char* content, size_t len) {
+        if (!mCur || mCur->sending) return;
+        respond(code, type, (const uint8_t*)content, len);
+    }
+    void send_P(int code, const char* type, const char* content) {
+        send_P(code, type, content, strlen(content));
+    }
+
+    // send_P() for a buffer the caller keeps pinned: release(data) runs
+    // once the body is out or the connection is dropped.
+    void sendBorrowed(int code, const char* type, const uint8_t* data, size_t len, ReleaseFn release) {
+        if (!mCur || mCur->sending) {
+            if (release) release(data);
+            return;
+        }
+        respond(code, type, data, len);
+        mCur->release = release;
+    }
+
+    // Answer with a text/event-stream and keep the connection as an event
+    // subscriber, queueing `event` with `data` (one line) for it first.
+    // Returns false when MAX_EVENT_CLIENTS are already subscribed.
+    bool beginEvents(const char* event = nullptr, const char* data = nullptr) {
+        if (!mCur || mCur->sending || eventClientCount() >= MAX_EVENT_CLIENTS) return false;
+        Client& c = *mCur;
+        c.head_len = (size_t)snprintf(c.head, sizeof(c.head),
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/event-stream\r\n"
+            "Cache-Control: no-cache\r\n"
+            "%s"
+            "Connection: keep-alive\r\n"
+            "\r\n"
+            "retry: 3000\n\n", mExtra);
+        c.head_off    = 0;
+        c.q_start     = 0;
+        c.q_len       = 0;
+        c.sending     = true;
+        c.events      = true;
+        c.progress_ms = millis();
+        c.event_ms    = c.progress_ms;
+        if (event && data) queueEvent(c, event, data, strlen(data));
+        return true;
+    }
+
+    // Queue one event for every subscriber.
+    void broadcast(const char* event, const char* data) {
+        size_t len = strlen(data);
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (c.active && c.events && !queueEvent(c, event, data, len)) {
+                mEventDrops++;
+                closeClient(c);
+            }
+        }
+    }
+
+    // Hold the current request unanswered; see resume(). 0 outside a
+    // handler or once it has answered.
+    Ticket park() {
+        if (!mCur || mCur->sending) return 0;
+        Client& c = *mCur;
+        if (++mNextTicket == 0) ++mNextTicket;
+        c.parked       = true;
+        c.ticket       = mNextTicket;
+        c.parked_ms    = millis();
+        c.method       = mMethod;
+        c.method_known = mMethodKnown;
+        c.path         = mPath;
+        for (int i = 0; i < mHeaderCount; ++i) c.headers[i] = mHeaderValues[i];
+        return c.ticket;
+    }
+
+    // Answer a parked request: fn runs as its handler (and may park it
+    // again). False if it is gone: the client left or it timed out.
+    bool resume(Ticket t, Handler fn) {
+        if (!t || mCur) return false;
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (!c.active || !c.parked || c.ticket != t) continue;
+            c.parked     = false;
+            mCur         = &c;
+            mMethod      = c.method;
+            mMethodKnown = c.method_known;
+            mPath        = c.path;
+            mArgCount    = 0;
+            for (int h = 0; h < mHeaderCount; ++h) mHeaderValues[h] = c.headers[h];
+            runHandler(c, fn);
+            if (!c.parked && !serviceResponse(c, millis())) closeClient(c);
+            return true;
+        }
+        return false;
+    }
+
+    int eventClientCount() const {
+        int n = 0;
+        for (int i = 0; i < MAX_CLIENTS; ++i) n += mClients[i].active && mClients[i].events ? 1 : 0;
+        return n;
+    }
+
+#if defined(ARDUINO)
+    // WebServer-compatible accessors
+    String arg(const String& name) const    { return String(argValue(name.c_str())); }
+    String header(const String& name) const { return String(headerValue(name.c_str())); }
+    void send(int code, const char* type, const String& content) {
+        send(code, type, content.c_str(), content.length());
+    }
+#endif
+
+    int clientCount() const {
+        int n = 0;
+        for (int i = 0; i < MAX_CLIENTS; ++i) n += mClients[i].active ? 1 : 0;
+        return n;
+    }
+    uint32_t requests() const { return mRequests; }
+    uint32_t timeouts() const { return mTimeouts; }
+    uint32_t rejected() const { return mRejected; }    // malformed or oversized requests
+    uint32_t eventsSent() const { return mEventsSent; }
+    uint32_t eventDrops() const { return mEventDrops; } // subscribers dropped for falling behind
+
+private:
+    struct Route {
+        const char* uri;
+        HTTPMethod  method;
+        Handler     fn;
+    };
+
+    struct Client {
+        bool           active;
+        bool           sending;       // request handled, response going out
+        bool           events;        // event stream: body[] is a ring of queued events
+        bool           parked;        // request handled, answer deferred (park())
+        WiFiClient     client;
+        int            fd;
+        uint32_t       opened_ms;
+        uint32_t       progress_ms;   // last byte sent
+        char           req[REQUEST_MAX + 1];
+        size_t         req_len;
+        char           head[HEAD_MAX];
+        size_t         head_len;
+        size_t         head_off;
+        char           body[BODY_MAX];
+        const uint8_t* body_ptr;      // body, or borrowed data
+        size_t         body_len;
+        size_t         body_off;
+        ReleaseFn      release;
+        size_t         q_start;
+        size_t         q_len;
+        uint32_t       event_ms;      // last event queued
+        Ticket         ticket;        // parked request: what resume() restores
+        uint32_t       parked_ms;
+        HTTPMethod     method;
+        bool           method_known;
+        const char*    path;          // into req[]
+        const char*    headers[MAX_HEADERS];
+
+        Client() : active(false), sending(false), events(false), parked(false), fd(-1), opened_ms(0),
+                   progress_ms(0), req_len(0), head_len(0), head_off(0), body_ptr(nullptr), body_len(0),
+                   body_off(0), release(nullptr), q_start(0), q_len(0), event_ms(0), ticket(0),
+                   parked_ms(0), method(HTTP_GET), method_known(false), path("") {}
+    };
+
+    // >0 bytes written, 0 when the socket buffer is full, -1 on error.
+    static int sendSome(int fd, const void* data, size_t len) {
+        int n = ::send(fd, data, len, MSG_DONTWAIT);
+        if (n >= 0) return n;
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    static const char* reason(int code) {
+        switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "";
+        }
+    }
+
+    void acceptAll() {
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (c.active) continue;
+            WiFiClient client = mServer.available();
+            if (!client) return;
+            c.active      = true;
+            c.sending     = false;
+            c.events      = false;
+            c.parked      = false;
+            c.client      = client;
+            c.fd          = client.fd();
+            c.opened_ms   = millis();
+            c.progress_ms = c.opened_ms;
+            c.req_len     = 0;
+            c.head_len    = 0;
+            c.head_off    = 0;
+            c.body_ptr    = nullptr;
+            c.body_len    = 0;
+            c.body_off    = 0;
+            c.release     = nullptr;
+        }
+    }
+
+    void closeClient(Client& c) {
+        if (!c.active) return;
+        if (c.release) c.release(c.body_ptr);
+        c.release = nullptr;
+        c.client.stop();
+        c.fd = -1;
+        c.active = false;
+        c.sending = false;
+        c.events = false;
+        c.parked = false;
+    }
+
+    // Collect one request, then dispatch it. Returns false to close.
+    bool readRequest(Client& c, uint32_t now) {
+        int n = ::recv(c.fd, c.req + c.req_len, REQUEST_MAX - c.req_len, MSG_DONTWAIT);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            if (now - c.opened_ms < REQUEST_TIMEOUT_MS) return true;
+            mTimeouts++;
+            return false;
+        }
+        c.req_len += (size_t)n;
+        c.req[c.req_len] = '\0';
+
+        char* end = strstr(c.req, "\r\n\r\n");
+        if (!end) {
+            if (c.req_len < REQUEST_MAX) return true;
+            return reject(c, 431);
+        }
+        size_t head_end = (size_t)(end - c.req) + 4;
+        size_t content_length = 0;
+        const char* cl = strcasestr(c.req, "\r\nContent-Length:");
+        if (cl && cl < end) content_length = strtoul(cl + 17, nullptr, 10);
+        if (head_end + content_length > REQUEST_MAX) return reject(c, 413);
+        if (c.req_len < head_end + content_length) return true;
+
+        c.req[head_end + content_length] = '\0';
+        end[2] = '\0';                                  // header block ends at its last CRLF
+        if (!parse(c, c.req + head_end, content_length)) return reject(c, 400);
+        dispatch(c);
+        if (c.parked) return true;
+        return c.events ? serviceEvents(c, now) : serviceResponse(c, now);
+    }
+
+    bool reject(Client& c, int code) {
+        mRejected++;
+        mCur = &c;
+        mMethodKnown = false;
+        mExtraLen = 0;
+        mExtra[0] = '\0';
+        respond(code, nullptr, nullptr, 0);
+        mCur = nullptr;
+        return serviceResponse(c, millis());
+    }
+
+    // Split the request in place: method, path, decoded args, collected headers.
+    bool parse(Client& c, char* body, size_t body_len) {
+        char* line_end = strstr(c.req, "\r\n");
+        *line_end = '\0';
+        char* sp1 = strchr(c.req, ' ');
+        if (!sp1) return false;
+        *sp1 = '\0';
+        char* target = sp1 + 1;
+        char* sp2 = strchr(target, ' ');
+        if (!sp2) return false;
+        *sp2 = '\0';
+
+        mMethodKnown = true;
+        if      (!strcmp(c.req, "GET"))    mMethod = HTTP_GET;
+        else if (!strcmp(c.req, "POST"))   mMethod = HTTP_POST;
+        else if (!strcmp(c.req, "HEAD"))   mMethod = HTTP_HEAD;
+        else if (!strcmp(c.req, "PUT"))    mMethod = HTTP_PUT;
+        else if (!strcmp(c.req, "DELETE")) mMethod = HTTP_DELETE;
+        else                               mMethodKnown = false;
+
+        mArgCount = 0;
+        char* query = strchr(target, '?');
+        if (query) {
+            *query = '\0';
+            parseArgs(query + 1);
+        }
+        urlDecode(target);
+        mPath = target;
+
+        bool form = false;
+        for (int i = 0; i < mHeaderCount; ++i) mHeaderValues[i] = nullptr;
+        char* line = line_end + 2;
+        while (*line) {
+            char* next = strstr(line, "\r\n");
+            if (!next) break;
+            *next = '\0';
+            char* colon = strchr(line, ':');
+            if (colon) {
+                *colon = '\0';
+                char* value = colon + 1;
+                while (*value == ' ' || *value == '\t') ++value;
+                if (!strcasecmp(line, "Content-Type") &&
+                    !strncasecmp(value, "application/x-www-form-urlencoded", 33)) {
+                    form = true;
+                }
+                for (int i = 0; i < mHeaderCount; ++i) {
+                    if (!strcasecmp(line, mHeaderNames[i])) mHeaderValues[i] = value;
+                }
+            }
+            line = next + 2;
+        }
+
+        if (body_len) {
+            if (form) {
+                parseArgs(body);
+            } else if (mArgCount < MAX_ARGS) {
+                mArgNames[mArgCount]  = "plain";
+                mArgValues[mArgCount] = body;
+                mArgCount++;
+            }
+        }
+        return true;
+    }
+
+    void parseArgs(char* s) {
+        while (*s && mArgCount < MAX_ARGS) {
+            char* amp = strchr(s, '&');
+            if (amp) *amp = '\0';
+            char* eq = strchr(s, '=');
+            if (eq) *eq = '\0';
+            if (*s) {
+                urlDecode(s);
+                mArgNames[mArgCount] = s;
+                mArgValues[mArgCount] = eq ? eq + 1 : s + strlen(s);
+                if (eq) urlDecode(eq + 1);
+                mArgCount++;
+            }
+            if (!amp) break;
+            s = amp + 1;
+        }
+    }
+
+    static int hexValue(char h) {
+        if (h >= '0' && h <= '9') return h - '0';
+        h = (char)tolower((unsigned char)h);
+        return (h >= 'a' && h <= 'f') ? h - 'a' + 10 : -1;
+    }
+
+    static void urlDecode(char* s) {
+        char* out = s;
+        for (; *s; ++s) {
+            int hi, lo;
+            if (*s == '+') {
+                *out++ = ' ';
+            } else if (*s == '%' && (hi = hexValue(s[1])) >= 0 && (lo = hexValue(s[2])) >= 0) {
+                *out++ = (char)(hi * 16 + lo);
+                s += 2;
+            } else {
+                *out++ = *s;
+            }
+        }
+        *out = '\0';
+    }
+
+    int findArg(const char* name) const {
+        if (!mCur) return -1;
+        for (int i = 0; i < mArgCount; ++i) {
+            if (!strcmp(mArgNames[i], name)) return i;
+        }
+        return -1;
+    }
+
+    void dispatch(Client& c) {
+        mRequests++;
+        mCur = &c;
+
+        Handler fn = mNotFound;
+        for (int i = 0; i < mRouteCount; ++i) {
+            const Route& r = mRoutes[i];
+            if (strcmp(r.uri, mPath) != 0) continue;
+            if (r.method != HTTP_ANY && (!mMethodKnown || r.method != mMethod)) continue;
+            fn = r.fn;
+            break;
+        }
+        runHandler(c, fn);
+    }
+
+    // Run fn for mCur's request (404 without one); it must answer or park.
+    void runHandler(Client& c, Handler fn) {
+        mExtraLen = 0;
+        mExtra[0] = '\0';
+        if (fn) fn();
+        else    send(404, "text/plain", "Not found");
+        if (!c.sending && !c.parked) send(500, "text/plain", "No response");
+
+        mCur = nullptr;
+        mArgCount = 0;
+    }
+
+    void respond(int code, const char* type, const uint8_t* body, size_t len) {
+        Client& c = *mCur;
+        int n = snprintf(c.head, sizeof(c.head), "HTTP/1.1 %d %s\r\n", code, reason(code));
+        if (type && n > 0 && (size_t)n < sizeof(c.head)) {
+            n += snprintf(c.head + n, sizeof(c.head) - n, "Content-Type: %s\r\n", type);
+        }
+        if (n > 0 && (size_t)n < sizeof(c.head)) {
+            n += snprintf(c.head + n, sizeof(c.head) - n,
+                          "Content-Length: %u\r\n%sConnection: close\r\n\r\n", (unsigned)len, mExtra);
+        }
+        if (n < 0 || (size_t)n >= sizeof(c.head)) {
+            // Oversized extra headers: answer without them
+            n = snprintf(c.head, sizeof(c.head),
+                         "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            len = 0;
+        }
+        c.head_len    = (size_t)n;
+        c.head_off    = 0;
+        c.body_ptr    = body;
+        c.body_len    = (mMethodKnown && mMethod == HTTP_HEAD) ? 0 : len;
+        c.body_off    = 0;
+        c.sending     = true;
+        c.parked      = false;
+        c.progress_ms = millis();
+    }
+
+    // Returns false once the response is out (or on error) to close.
+    bool serviceResponse(Client& c, uint32_t now) {
+        size_t budget = BYTES_PER_POLL;
+        while (c.head_off < c.head_len) {
+            int n = sendSome(c.fd, c.head + c.head_off, c.head_len - c.head_off);
+            if (n < 0) return false;
+            if (n == 0) return stalled(c, now);
+            c.head_off += (size_t)n;
+            c.progress_ms = now;
+        }
+        while (c.body_off < c.body_len) {
+            if (!budget) return true;
+            size_t left = c.body_len - c.body_off;
+            if (left > budget) left = budget;
+            int n = sendSome(c.fd, c.body_ptr + c.body_off, left);
+            if (n < 0) return false;
+            if (n == 0) return stalled(c, now);
+            c.body_off += (size_t)n;
+            budget -= (size_t)n;
+            c.progress_ms = now;
+        }
+        return false;                                   // done: close
+    }
+
+    void queueBytes(Client& c, const char* data, size_t len) {
+        size_t tail = (c.q_start + c.q_len) % BODY_MAX;
+        size_t first = BODY_MAX - tail < len ? BODY_MAX - tail : len;
+        memcpy(c.body + tail, data, first);
+        memcpy(c.body, data + first, len - first);
+        c.q_len += len;
+    }
+
+    // False when the event doesn't fit in what's left of the queue.
+    bool queueEvent(Client& c, const char* event, const char* data, size_t len) {
+        char head[40];
+        int n = snprintf(head, sizeof(head), "event: %s\ndata: ", event);
+        if (n < 0 || (size_t)n >= sizeof(head)) return false;
+        if (c.q_len + (size_t)n + len + 2 > BODY_MAX) return false;
+        queueBytes(c, head, (size_t)n);
+        queueBytes(c, data, len);
+        queueBytes(c, "\n\n", 2);
+        c.event_ms = millis();
+        mEventsSent++;
+        return true;
+    }
+
+    // Returns false to close: the subscriber left, errored or stalled.
+    bool serviceEvents(Client& c, uint32_t now) {
+        // Subscribers never send anything after the request; 0 means they left.
+        char scratch[64];
+        int r = ::recv(c.fd, scratch, sizeof(scratch), MSG_DONTWAIT);
+        if (r == 0) return false;
+        if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+        while (c.head_off < c.head_len) {
+            int n = sendSome(c.fd, c.head + c.head_off, c.head_len - c.head_off);
+            if (n < 0) return false;
+            if (n == 0) return stalled(c, now);
+            c.head_off += (size_t)n;
+            c.progress_ms = now;
+        }
+        if (!c.q_len && now - c.event_ms >= EVENT_KEEPALIVE_MS) {
+            queueBytes(c, ":\n\n", 3);
+            c.event_ms = now;
+        }
+        while (c.q_len) {
+            size_t chunk = BODY_MAX - c.q_start < c.q_len ? BODY_MAX - c.q_start : c.q_len;
+            int n = sendSome(c.fd, c.body + c.q_start, chunk);
+            if (n < 0) return false;
+            if (n == 0) return stalled(c, now);
+            c.q_start = (c.q_start + (size_t)n) % BODY_MAX;
+            c.q_len -= (size_t)n;
+            c.progress_ms = now;
+        }
+        c.progress_ms = now;                            // nothing pending isn't a stall
+        return true;
+    }
+
+    // Returns false to close: the client left or nobody answered in time.
+    bool serviceParked(Client& c, uint32_t now) {
+        char probe;
+        int r = ::recv(c.fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (r == 0) return false;
+        if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+        if (now - c.parked_ms < RESPONSE_TIMEOUT_MS) return true;
+        mTimeouts++;
+        return false;
+    }
+
+    bool stalled(Client& c, uint32_t now) {
+        if (now - c.progress_ms < RESPONSE_TIMEOUT_MS) return true;
+        mTimeouts++;
+        return false;
+    }
+
+    WiFiServer  mServer;
+    Client      mClients[MAX_CLIENTS];
+    Route       mRoutes[MAX_ROUTES];
+    int         mRouteCount;
+    Handler     mNotFound;
+    const char* mHeaderNames[MAX_HEADERS];
+    int         mHeaderCount;
+
+    // Current request, parsed in place in its client's buffer
+    Client*     mCur;
+    HTTPMethod  mMethod;
+    bool        mMethodKnown;
+    const char* mPath;
+    const char* mArgNames[MAX_ARGS];
+    const char* mArgValues[MAX_ARGS];
+    int         mArgCount;
+    const char* mHeaderValues[MAX_HEADERS];
+    char        mExtra[256];                            // sendHeader() lines
+    size_t      mExtraLen;
+    Ticket      mNextTicket;
+
+    uint32_t    mRequests;
+    uint32_t    mTimeouts;
+    uint32_t    mRejected;
+    uint32_t    mEventsSent;
+    uint32_t    mEventDrops;
+};
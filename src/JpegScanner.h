@@ -0,0 +1,256 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * JPEG header scanning for RTP/JPEG (RFC 2435).
+ *
+ * jpeg_parse() makes one forward pass over the marker segments up to SOS,
+ * collecting frame size, sampling, restart interval and quant tables, then
+ * locates EOI. The entropy-coded data can only contain 0xFF as a stuffed
+ * FF 00 or an RSTn marker, so EOI is found by looking at the last two bytes
+ * and, only when the frame carries trailing padding, by a word-at-a-time
+ * search for 0xFF bytes.
+ */
+
+// Everything the RTP/JPEG header needs, pointing into the source JPEG.
+struct JpegInfo {
+    uint16_t       width;
+    uint16_t       height;
+    uint8_t        type;               // RFC 2435 type: 0 = 4:2:2, 1 = 4:2:0, +64 with restart markers
+    uint16_t       restart_interval;
+    const uint8_t* qtables[2];         // 8-bit luma / chroma tables, 64 bytes each
+    uint8_t        qtable_count;
+    const uint8_t* scan;               // entropy-coded data after SOS, up to EOI
+    size_t         scan_len;
+};
+
+static inline uint16_t jpeg_be16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// First byte in [p, end) equal to 0xFF, or end. Reads whole aligned words
+// and only drops to bytes for the word that contains a match.
+static inline const uint8_t* jpeg_find_ff(const uint8_t* p, const uint8_t* end) {
+    typedef size_t word_t;
+    const word_t ones = (word_t)-1 / 0xFF;         // 0x0101...01
+    const word_t high = ones << 7;                 // 0x8080...80
+
+    while (p < end && ((uintptr_t)p & (sizeof(word_t) - 1))) {
+        if (*p == 0xFF) return p;
+        ++p;
+    }
+    while ((size_t)(end - p) >= sizeof(word_t)) {
+        word_t w;
+        memcpy(&w, p, sizeof(w));                  // aligned: a single load
+        w = ~w;                                    // 0xFF bytes become zero bytes
+        if ((w - ones) & ~w & high) break;
+        p += sizeof(word_t);
+    }
+    while (p < end && *p != 0xFF) ++p;
+    return p;
+}
+
+// Offset of the EOI marker in buf[start, len), or len when there is none.
+static inline size_t jpeg_find_eoi(const uint8_t* buf, size_t start, size_t len) {
+    // EOI is normally the last two bytes.
+    if (len >= start + 2 && buf[len - 2] == 0xFF && buf[len - 1] == 0xD9) return len - 2;
+
+    const uint8_t* end = buf + len;
+    const uint8_t* p = buf + start;
+    while ((p = jpeg_find_ff(p, end)) + 1 < end) {
+        if (p[1] == 0xD9) return (size_t)(p - buf);
+        p += (p[1] == 0xFF) ? 1 : 2;               // FF FF is fill; anything else is FF 00 / RSTn
+    }
+    return len;
+}
+
+// Walk the JPEG markers up to SOS. Returns false for anything RFC 2435 can't
+// carry (progressive, 16-bit tables, odd sampling). On success *sos_offset
+// and *sof_offset, if given, receive the offsets of the SOS and SOF markers.
+static inline bool jpeg_parse(const uint8_t* buf, size_t len, JpegInfo& out, size_t* sos_offset = nullptr,
+                              size_t* sof_offset = nullptr) {
+    memset(&out, 0, sizeof(out));
+    if (len < 4 || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+
+    bool have_sof = false;
+    size_t sof = 0;
+    size_t i = 2;
+    while (i + 4 <= len) {
+        if (buf[i] != 0xFF) return false;
+        uint8_t marker = buf[i + 1];
+        if (marker == 0xFF) { ++i; continue; }          // fill byte
+        if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7)) { i += 2; continue; }
+
+        size_t seg_len = jpeg_be16(buf + i + 2);
+        const uint8_t* seg = buf + i + 4;
+        if (seg_len < 2 || i + 2 + seg_len > len) return false;
+        size_t body = seg_len - 2;
+
+        switch (marker) {
+        case 0xDB: {                                    // DQT, may hold several tables
+            size_t off = 0;
+            while (off < body) {
+                uint8_t pq = seg[off] >> 4;
+                uint8_t tq = seg[off] & 0x0F;
+                if (pq != 0 || tq > 1 || off + 65 > body) return false;
+                out.qtables[tq] = seg + off + 1;
+                if (tq + 1 > out.qtable_count) out.qtable_count = tq + 1;
+                off += 65;
+            }
+            break;
+        }
+        case 0xC0:                                      // SOF0 baseline
+        case 0xC1: {                                    // SOF1 extended, same layout
+            if (body < 6 + 3 * 3 || seg[5] != 3) return false;
+            out.height = jpeg_be16(seg + 1);
+            out.width  = jpeg_be16(seg + 3);
+            uint8_t y_sampling = seg[7];
+            if (y_sampling == 0x21)      out.type = 0;
+            else if (y_sampling == 0x22) out.type = 1;
+            else return false;
+            have_sof = true;
+            sof = i;
+            break;
+        }
+        case 0xC2:                                      // progressive: not supported by RFC 2435
+            return false;
+        case 0xDD:                                      // DRI
+            if (body < 2) return false;
+            out.restart_interval = jpeg_be16(seg);
+            break;
+        case 0xDA: {                                    // SOS: scan data follows
+            if (!have_sof || out.qtable_count == 0) return false;
+            size_t start = i + 2 + seg_len;
+            out.scan = buf + start;
+            out.scan_len = jpeg_find_eoi(buf, start, len) - start;
+            if (out.restart_interval) out.type |= 64;
+            if (sos_offset) *sos_offset = i;
+            if (sof_offset) *sof_offset = sof;
+            return true;
+        }
+        default:
+            break;
+        }
+        i += 2 + seg_len;
+    }
+    return false;
+}
+
+/**
+ * jpeg_parse() with a small cache of header layouts keyed by the sensor's
+ * quality and frame size.
+ *
+ * The camera emits an identical header for every frame at a given
+ * quality/framesize, so on a key hit only the SOS position, the frame
+ * dimensions in SOF and the quant table bytes are compared against the
+ * cached layout (a frame captured just before a settings change still
+ * carries the old tables or size) and the marker walk is skipped. Tables
+ * are kept in the cache itself, in internal RAM, rather than pointing into
+ * the PSRAM frame buffer. Key 0 disables caching.
+ *
+ * Not thread-safe; owned by the packetizer.
+ */
+class JpegScanner {
+public:
+    static const int ENTRIES = 4;
+
+    static uint16_t key(int quality, int framesize) {
+        return (uint16_t)(((quality & 0xFF) << 8) | (framesize & 0xFF) | 0x8000);
+    }
+
+    JpegScanner() : mNext(0), mHits(0), mMisses(0), mStale(0) {
+        memset(mEntries, 0, sizeof(mEntries));
+    }
+
+    JpegScanner(const JpegScanner&) = delete;
+    JpegScanner& operator=(const JpegScanner&) = delete;
+
+    bool scan(const uint8_t* buf, size_t len, JpegInfo& out, uint16_t key = 0) {
+        if (!key) return jpeg_parse(buf, len, out);
+
+        Entry* e = find(key);
+        if (e) {
+            if (matches(*e, buf, len)) {
+                mHits++;
+                out = e->info;
+                size_t start = e->sos_offset + 2 + jpeg_be16(buf + e->sos_offset + 2);
+                out.scan = buf + start;
+                out.scan_len = jpeg_find_eoi(buf, start, len) - start;
+                return true;
+            }
+            mStale++;
+        }
+        mMisses++;
+
+        size_t sos_offset = 0, sof_offset = 0;
+        if (!jpeg_parse(buf, len, out, &sos_offset, &sof_offset)) return false;
+        remember(e ? *e : mEntries[mNext++ % ENTRIES], key, buf, out, sos_offset, sof_offset);
+        return true;
+    }
+
+    void clear() { memset(mEntries, 0, sizeof(mEntries)); }
+
+    uint32_t hits()   const { return mHits; }
+    uint32_t misses() const { return mMisses; }
+    uint32_t stale()  const { return mStale; }
+
+private:
+    struct Entry {
+        uint16_t key;
+        uint16_t table_offset[2];      // where each 64-byte table sits in the frame
+        uint16_t sos_offset;           // SOS marker
+        uint16_t sos_length;           // SOS segment length field
+        uint16_t sof_offset;           // SOF marker; height and width follow at +5
+        JpegInfo info;                 // qtables point at tables[], scan unused
+        uint8_t  tables[2][64];
+    };
+
+    Entry* find(uint16_t key) {
+        for (int i = 0; i < ENTRIES; ++i) {
+            if (mEntries[i].key == key) return &mEntries[i];
+        }
+        return nullptr;
+    }
+
+    static bool matches(const Entry& e, const uint8_t* buf, size_t len) {
+        size_t sos = e.sos_offset;
+        if (len < sos + 2 + e.sos_length || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+        if (buf[sos] != 0xFF || buf[sos + 1] != 0xDA || jpeg_be16(buf + sos + 2) != e.sos_length) return false;
+        const uint8_t* sof = buf + e.sof_offset;         // before SOS, so in bounds
+        if (sof[0] != 0xFF || (sof[1] != 0xC0 && sof[1] != 0xC1)) return false;
+        if (jpeg_be16(sof + 5) != e.info.height || jpeg_be16(sof + 7) != e.info.width) return false;
+        for (uint8_t t = 0; t < 2; ++t) {
+            if (!e.info.qtables[t]) continue;
+            if (memcmp(buf + e.table_offset[t], e.tables[t], 64) != 0) return false;
+        }
+        return true;
+    }
+
+    static void remember(Entry& e, uint16_t key, const uint8_t* buf, const JpegInfo& info,
+                         size_t sos_offset, size_t sof_offset) {
+        e.key = 0;
+        if (sos_offset > 0xFFFF) return;
+        e.info = info;
+        e.info.scan = nullptr;
+        e.info.scan_len = 0;
+        for (uint8_t t = 0; t < 2; ++t) {
+            if (!info.qtables[t]) continue;
+            e.table_offset[t] = (uint16_t)(info.qtables[t] - buf);
+            memcpy(e.tables[t], info.qtables[t], 64);
+            e.info.qtables[t] = e.tables[t];
+        }
+        e.sos_offset = (uint16_t)sos_offset;
+        e.sos_length = jpeg_be16(buf + sos_offset + 2);
+        e.sof_offset = (uint16_t)sof_offset;
+        e.key = key;
+    }
+
+    Entry    mEntries[ENTRIES];
+    uint32_t mNext;
+    uint32_t mHits;
+    uint32_t mMisses;
+    uint32_t mStale;
+};
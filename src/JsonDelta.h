@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Top-level delta between two JSON objects, for pushing status updates.
+ *
+ * json_delta() emits the members of `cur` whose value differs from (or is
+ * missing in) `prev`, as a JSON object; the receiver merges it into its copy
+ * with Object.assign(). Nested objects and arrays are compared and sent as a
+ * whole. Both inputs are scanned in place: no parsing into a tree, no heap.
+ * Members removed from `cur` are not reported.
+ */
+
+struct JsonSpan {
+    const char* p;
+    size_t      len;
+};
+
+// Span of the value starting at p (string, object, array or literal).
+static inline const char* json_skip_value(const char* p) {
+    if (*p == '"') {
+        for (++p; *p && *p != '"'; ++p) {
+            if (*p == '\\' && p[1]) ++p;
+        }
+        return *p ? p + 1 : p;
+    }
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        for (; *p; ++p) {
+            if (*p == '"') {
+                p = json_skip_value(p) - 1;
+            } else if (*p == '{' || *p == '[') {
+                depth++;
+            } else if (*p == '}' || *p == ']') {
+                if (--depth == 0) return p + 1;
+            }
+        }
+        return p;
+    }
+    while (*p && *p != ',' && *p != '}' && *p != ']' && *p != ' ') ++p;
+    return p;
+}
+
+static inline const char* json_skip_space(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+    return p;
+}
+
+// Next "key":value of the object being walked; p starts just after '{'.
+// Returns false at the closing brace or on malformed input.
+static inline bool json_next_member(const char*& p, JsonSpan& key, JsonSpan& value) {
+    p = json_skip_space(p);
+    if (*p == ',') p = json_skip_space(p + 1);
+    if (*p != '"') return false;
+    key.p = p;
+    p = json_skip_value(p);
+    key.len = (size_t)(p - key.p);
+    p = json_skip_space(p);
+    if (*p != ':') return false;
+    p = json_skip_space(p + 1);
+    value.p = p;
+    p = json_skip_value(p);
+    value.len = (size_t)(p - value.p);
+    return value.len != 0;
+}
+
+// Value of `key` (with its quotes) in the object `obj`, or false.
+static inline bool json_find_member(const char* obj, const JsonSpan& key, JsonSpan& value) {
+    const char* p = json_skip_space(obj);
+    if (*p != '{') return false;
+    ++p;
+    JsonSpan k;
+    while (json_next_member(p, k, value)) {
+        if (k.len == key.len && memcmp(k.p, key.p, k.len) == 0) return true;
+    }
+    return false;
+}
+
+// Writes the delta object and returns its length: 2 ("{}") when nothing
+// changed, 0 if `out` is too small or `cur` isn't an object.
+static inline size_t json_delta(const char* prev, const char* cur, char* out, size_t out_len) {
+    const char* p = json_skip_space(cur);
+    if (*p != '{' || out_len < 3) return 0;
+    ++p;
+
+    size_t n = 0;
+    out[n++] = '{';
+    JsonSpan key, value, old;
+    while (json_next_member(p, key, value)) {
+        if (prev && json_find_member(prev, key, old) &&
+            old.len == value.len && memcmp(old.p, value.p, value.len) == 0) {
+            continue;
+        }
+        size_t need = (n > 1 ? 1 : 0) + key.len + 1 + value.len;
+        if (n + need + 2 > out_len) return 0;
+        if (n > 1) out[n++] = ',';
+        memcpy(out + n, key.p, key.len);
+        n += key.len;
+        out[n++] = ':';
+        memcpy(out + n, value.p, value.len);
+        n += value.len;
+    }
+    out[n++] = '}';
+    out[n] = '\0';
+    return n;
+}
@@ -0,0 +1,330 @@
+#pragma once
+#include <WiFi.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <esp32-hal-psram.h>
+#include <lwip/sockets.h>
+#else
+#include <sys/socket.h>
+#endif
+
+/**
+ * One JPEG shared by every MJPEG viewer. Copied out of the camera buffer
+ * once per frame so slow viewers never hold camera frame buffers. The
+ * buffer belongs to MjpegServer's frame pool; refs == 0 means it is free.
+ */
+struct MjpegFrame {
+    uint16_t refs;
+    uint32_t seq;
+    size_t   len;
+    uint8_t* data;
+
+    static void release(MjpegFrame* f) {
+        if (f) --f->refs;
+    }
+};
+
+/**
+ * Non-blocking multipart/x-mixed-replace (MJPEG) HTTP server.
+ *
+ * Each viewer keeps one connection open and is sent the newest frame
+ * whenever it has finished the previous one, so a slow viewer simply sees
+ * fewer frames. poll() writes a bounded number of bytes per viewer and never
+ * blocks; publish() and poll() must be called from the same task.
+ *
+ * Frames are copied into a few buffers allocated once, each big enough for
+ * the largest JPEG the camera produces, so publishing never touches the
+ * heap. When every buffer is still being sent, the new frame is skipped
+ * and counted; viewers just get the next one.
+ */
+class MjpegServer {
+public:
+    static const int      MAX_CLIENTS          = 4;
+    static const size_t   REQUEST_MAX          = 512;
+    static const size_t   BYTES_PER_POLL       = 16 * 1024;   // per viewer, keeps the others moving
+    static const uint32_t REQUEST_TIMEOUT_MS   = 5000;
+    static const size_t   FRAME_SLOTS          = 3;           // latest + two in flight
+    // esp32-camera's JPEG frame buffer at UXGA (width * height / 5): no
+    // frame from the sensor is larger. Without PSRAM the sensor can't
+    // buffer more than a small frame either.
+    static const size_t   FRAME_BYTES          = 1600 * 1200 / 5;
+    static const size_t   FRAME_BYTES_NO_PSRAM = 32 * 1024;
+
+    explicit MjpegServer(int port)
+        : mServer(port), mLatest(nullptr), mFrameMem(nullptr), mFrameBytes(0),
+          mFramesPublished(0), mFramesSent(0), mFramesSkipped(0), mFramesDropped(0)
+    {
+        memset(mFrames, 0, sizeof(mFrames));
+    }
+
+    ~MjpegServer() {
+        for (int i = 0; i < MAX_CLIENTS; ++i) closeClient(mClients[i]);
+        MjpegFrame::release(mLatest);
+        free(mFrameMem);
+    }
+
+    MjpegServer(const MjpegServer&) = delete;
+    MjpegServer& operator=(const MjpegServer&) = delete;
+
+    void begin() {
+        mServer.begin();
+        mServer.setNoDelay(true);
+    }
+
+    // True when at least one client is receiving the stream.
+    bool hasViewers() const {
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            if (mClients[i].active && mClients[i].streaming) return true;
+        }
+        return false;
+    }
+
+    int viewerCount() const {
+        int n = 0;
+        for (int i = 0; i < MAX_CLIENTS; ++i) n += mClients[i].active && mClients[i].streaming ? 1 : 0;
+        return n;
+    }
+
+    // Allocate the frame buffers; otherwise done on the first publish().
+    bool reserve() {
+        if (mFrameMem) return true;
+        size_t bytes = FRAME_BYTES;
+#if defined(ARDUINO)
+        if (!psramFound()) bytes = FRAME_BYTES_NO_PSRAM;
+        mFrameMem = (uint8_t*)(psramFound() ? ps_malloc(FRAME_SLOTS * bytes) : malloc(FRAME_SLOTS * bytes));
+#else
+        mFrameMem = (uint8_t*)malloc(FRAME_SLOTS * bytes);
+#endif
+        if (!mFrameMem) return false;
+        mFrameBytes = bytes;
+        for (size_t i = 0; i < FRAME_SLOTS; ++i) {
+            mFrames[i].refs = 0;
+            mFrames[i].data = mFrameMem + i * bytes;
+        }
+        return true;
+    }
+
+    // Copy a frame once; viewers pick it up as they become free.
+    bool publish(const uint8_t* jpeg, size_t len, uint32_t seq) {
+        if (!hasViewers()) return false;
+        if (!reserve()) return false;
+        MjpegFrame* f = nullptr;
+        for (size_t i = 0; i < FRAME_SLOTS && !f; ++i) {
+            if (mFrames[i].refs == 0) f = &mFrames[i];
+        }
+        if (!f || len > mFrameBytes) {
+            mFramesDropped++;
+            return false;
+        }
+        f->refs = 1;
+        f->seq  = seq;
+        f->len  = len;
+        memcpy(f->data, jpeg, len);
+        MjpegFrame::release(mLatest);
+        mLatest = f;
+        mFramesPublished++;
+        return true;
+    }
+
+    // Bounded, non-blocking service of all clients.
+    void poll() {
+        acceptOne();
+        uint32_t now = millis();
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (!c.active) continue;
+            bool ok = c.streaming ? serviceStream(c) : readRequest(c, now);
+            if (!ok) closeClient(c);
+        }
+        // Don't hand a stale frame to the next viewer
+        if (mLatest && !hasViewers()) {
+            MjpegFrame::release(mLatest);
+            mLatest = nullptr;
+        }
+    }
+
+    uint32_t framesPublished() const { return mFramesPublished; }
+    uint32_t framesSent()      const { return mFramesSent; }
+    uint32_t framesSkipped()   const { return mFramesSkipped; }
+    uint32_t framesDropped()   const { return mFramesDropped; }   // no free buffer, or too big
+
+private:
+    struct Client {
+        bool        active;
+        bool        streaming;      // request answered, sending parts
+        WiFiClient  client;
+        int         fd;
+        uint32_t    opened_ms;
+        char        req[REQUEST_MAX];
+        size_t      req_len;
+        char        head[256];      // HTTP response / part header
+        size_t      head_len;
+        size_t      head_off;
+        MjpegFrame* frame;          // part being sent
+        size_t      body_off;
+        uint32_t    last_seq;
+        bool        close_after;    // error reply: close once it's out
+
+        Client() : active(false), streaming(false), fd(-1), opened_ms(0), req_len(0),
+                   head_len(0), head_off(0), frame(nullptr), body_off(0), last_seq(0),
+                   close_after(false) {}
+    };
+
+    // >0 bytes written, 0 when the socket buffer is full, -1 on error.
+    static int sendSome(int fd, const void* data, size_t len) {
+        int n = ::send(fd, data, len, MSG_DONTWAIT);
+        if (n >= 0) return n;
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    void acceptOne() {
+        WiFiClient client = mServer.available();
+        if (!client) return;
+
+        for (int i = 0; i < MAX_CLIENTS; ++i) {
+            Client& c = mClients[i];
+            if (c.active) continue;
+            c.active      = true;
+            c.streaming   = false;
+            c.client      = client;
+            c.fd          = client.fd();
+            c.opened_ms   = millis();
+            c.req_len     = 0;
+            c.head_len    = 0;
+            c.head_off    = 0;
+            c.frame       = nullptr;
+            c.body_off    = 0;
+            c.last_seq    = 0;
+            c.close_after = false;
+            return;
+        }
+        // Table full: turn the newcomer away rather than slow everyone down
+        static const char busy[] =
+            "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+        sendSome(client.fd(), busy, sizeof(busy) - 1);
+        client.stop();
+    }
+
+    void closeClient(Client& c) {
+        if (!c.active) return;
+        MjpegFrame::release(c.frame);
+        c.frame = nullptr;
+        c.client.stop();
+        c.fd = -1;
+        c.active = false;
+        c.streaming = false;
+    }
+
+    // Collect the request headers, then answer. Returns false to close.
+    bool readRequest(Client& c, uint32_t now) {
+        if (c.head_len || c.close_after) {
+            if (!flushHead(c)) return false;
+            return !(c.close_after && c.head_len == 0);
+        }
+
+        int n = ::recv(c.fd, c.req + c.req_len, REQUEST_MAX - 1 - c.req_len, MSG_DONTWAIT);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            return now - c.opened_ms < REQUEST_TIMEOUT_MS;
+        }
+        c.req_len += (size_t)n;
+        c.req[c.req_len] = '\0';
+        if (!strstr(c.req, "\r\n\r\n")) {
+            return c.req_len < REQUEST_MAX - 1;          // oversized request: drop it
+        }
+
+        if (strncmp(c.req, "GET /stream", 11) != 0 && strncmp(c.req, "GET / ", 6) != 0) {
+            c.head_len = (size_t)snprintf(c.head, sizeof(c.head),
+                "HTTP/1.1 404 Not Found\r\nConnection: close\r\nContent-Length: 0\r\n\r\n");
+            c.close_after = true;
+            return flushHead(c);
+        }
+
+        c.head_len = (size_t)snprintf(c.head, sizeof(c.head),
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+            "Cache-Control: no-cache, no-store\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Connection: close\r\n"
+            "\r\n");
+        c.head_off  = 0;
+        c.streaming = true;
+        return flushHead(c);
+    }
+
+    // Returns false on a write error.
+    bool flushHead(Client& c) {
+        while (c.head_off < c.head_len) {
+            int n = sendSome(c.fd, c.head + c.head_off, c.head_len - c.head_off);
+            if (n < 0) return false;
+            if (n == 0) return true;
+            c.head_off += (size_t)n;
+        }
+        c.head_len = c.head_off = 0;
+        return true;
+    }
+
+    bool serviceStream(Client& c) {
+        // Viewers never send anything after the request; 0 means they left.
+        uint8_t scratch[64];
+        int r = ::recv(c.fd, scratch, sizeof(scratch), MSG_DONTWAIT);
+        if (r == 0) return false;
+        if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+        size_t budget = BYTES_PER_POLL;
+        for (;;) {
+            if (!flushHead(c)) return false;
+            if (c.head_len) return true;                 // socket full
+
+            if (!c.frame) {
+                if (!mLatest || mLatest->seq == c.last_seq) return true;   // nothing new
+                if (c.last_seq && mLatest->seq - c.last_seq > 1) {
+                    mFramesSkipped += mLatest->seq - c.last_seq - 1;
+                }
+                c.frame = mLatest;
+                c.frame->refs++;
+                c.last_seq = c.frame->seq;
+                c.body_off = 0;
+                // Leading CRLF ends the previous part (or is preamble for the first)
+                c.head_len = (size_t)snprintf(c.head, sizeof(c.head),
+                    "\r\n--frame\r\n"
+                    "Content-Type: image/jpeg\r\n"
+                    "Content-Length: %u\r\n"
+                    "\r\n",
+                    (unsigned)c.frame->len);
+                c.head_off = 0;
+                continue;
+            }
+
+            if (!budget) return true;
+            size_t left = c.frame->len - c.body_off;
+            if (left > budget) left = budget;
+            int n = sendSome(c.fd, c.frame->data + c.body_off, left);
+            if (n < 0) return false;
+            if (n == 0) return true;
+            c.body_off += (size_t)n;
+            budget -= (size_t)n;
+            if (c.body_off == c.frame->len) {
+                MjpegFrame::release(c.frame);
+                c.frame = nullptr;
+                mFramesSent++;
+            }
+        }
+    }
+
+    WiFiServer  mServer;
+    Client      mClients[MAX_CLIENTS];
+    MjpegFrame* mLatest;
+    MjpegFrame  mFrames[FRAME_SLOTS];
+    uint8_t*    mFrameMem;
+    size_t      mFrameBytes;
+    uint32_t    mFramesPublished;
+    uint32_t    mFramesSent;
+    uint32_t    mFramesSkipped;
+    uint32_t    mFramesDropped;
+};
@@ -0,0 +1,204 @@
+#pragma once
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <lwip/sockets.h>
+#else
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Broker connection management for the MQTT client, without blocking.
+ *
+ * The TCP connect is a non-blocking socket polled from the owning task's
+ * loop, so an unreachable broker (SYNs unanswered, no route) costs nothing
+ * per iteration instead of the client library's blocking connect. Once the
+ * socket is up, poll() hands it over and the caller runs the MQTT handshake
+ * on it and reports back with established() or failed(); a connection that
+ * later drops is reported with lost().
+ *
+ * Attempts are spaced by exponential backoff with jitter: the n-th
+ * consecutive failure waits a random time in [cap/2, cap], cap =
+ * BACKOFF_MIN_MS * 2^n up to BACKOFF_MAX_MS, so a fleet doesn't hammer a
+ * broker that just came back in lockstep. A connection only clears the
+ * failure count once it has stayed up for STABLE_MS; a broker that accepts
+ * and then drops us keeps backing off.
+ */
+class MqttConnector {
+public:
+    static const uint32_t BACKOFF_MIN_MS     = 1000;
+    static const uint32_t BACKOFF_MAX_MS     = 30000;
+    static const uint32_t CONNECT_TIMEOUT_MS = 5000;
+    static const uint32_t STABLE_MS          = 30000;
+
+    enum State : uint8_t {
+        WAITING,        // backing off until due()
+        CONNECTING,     // TCP connect in progress
+        HANDSHAKE,      // socket handed over, waiting for established()/failed()
+        CONNECTED,
+    };
+
+    MqttConnector()
+        : mState(WAITING), mFd(-1), mNextMs(0), mStartMs(0), mUpMs(0),
+          mBackoffMs(0), mRand(0x9E3779B9u), mFailures(0), mLastError(0),
+          mAttempts(0), mConnects(0) {}
+
+    // Jitter source; pass something device-specific (esp_random()).
+    void seed(uint32_t s) { mRand = s ? s : 0x9E3779B9u; }
+
+    // Time for the next attempt: resolve the broker and call begin().
+    bool due(uint32_t now_ms) const {
+        return mState == WAITING && (mAttempts == 0 || (int32_t)(now_ms - mNextMs) >= 0);
+    }
+
+    // Starts a non-blocking connect to ip (network byte order):port.
+    // False (and the next attempt scheduled) if it failed outright.
+    bool begin(uint32_t ip, uint16_t port, uint32_t now_ms) {
+        if (mState != WAITING) return false;
+        mAttempts++;
+        mFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (mFd < 0) {
+            fail(errno, now_ms);
+            return false;
+        }
+        ::fcntl(mFd, F_SETFL, ::fcntl(mFd, F_GETFL, 0) | O_NONBLOCK);
+
+        struct sockaddr_in a;
+        memset(&a, 0, sizeof(a));
+        a.sin_family      = AF_INET;
+        a.sin_port        = htons(port);
+        a.sin_addr.s_addr = ip;
+        if (::connect(mFd, (struct sockaddr*)&a, sizeof(a)) < 0 && errno != EINPROGRESS) {
+            fail(errno, now_ms);
+            return false;
+        }
+        mState   = CONNECTING;
+        mStartMs = now_ms;
+        return true;
+    }
+
+    // The broker's name didn't resolve; counts as a failed attempt.
+    void unreachable(uint32_t now_ms) {
+        if (mState != WAITING) return;
+        mAttempts++;
+        fail(EHOSTUNREACH, now_ms);
+    }
+
+    // While CONNECTING: returns the connected socket (blocking mode again)
+    // exactly once, and from then on it belongs to the caller. -1 while
+    // still pending or after a failure.
+    int poll(uint32_t now_ms) {
+        if (mState != CONNECTING) return -1;
+
+        fd_set wr;
+        FD_ZERO(&wr);
+        FD_SET(mFd, &wr);
+        struct timeval tv = { 0, 0 };
+        int r = ::select(mFd + 1, nullptr, &wr, nullptr, &tv);
+        if (r == 0) {
+            if (now_ms - mStartMs >= CONNECT_TIMEOUT_MS) fail(ETIMEDOUT, now_ms);
+            return -1;
+        }
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (r < 0) {
+            err = errno;
+        } else if (::getsockopt(mFd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+            err = errno;
+        }
+        if (err) {
+            fail(err, now_ms);
+            return -1;
+        }
+        ::fcntl(mFd, F_SETFL, ::fcntl(mFd, F_GETFL, 0) & ~O_NONBLOCK);
+        int fd = mFd;
+        mFd    = -1;
+        mState = HANDSHAKE;
+        return fd;
+    }
+
+    // Handshake outcome for the socket poll() returned. On failure the
+    // caller has already closed it.
+    void established(uint32_t now_ms) {
+        if (mState != HANDSHAKE) return;
+        mState = CONNECTED;
+        mUpMs  = now_ms;
+        mConnects++;
+    }
+
+    void failed(int err, uint32_t now_ms) {
+        if (mState == HANDSHAKE) fail(err, now_ms);
+    }
+
+    // The established connection went away.
+    void lost(uint32_t now_ms) {
+        if (mState != CONNECTED) return;
+        if (now_ms - mUpMs >= STABLE_MS) mFailures = 0;
+        fail(0, now_ms);
+    }
+
+    State    state()     const { return mState; }
+    uint32_t attempts()  const { return mAttempts; }
+    uint32_t connects()  const { return mConnects; }
+    uint16_t failures()  const { return mFailures; }
+    uint32_t backoffMs() const { return mBackoffMs; }
+    int      lastError() const { return mLastError; }
+
+    // Milliseconds until the next attempt (0 when not waiting).
+    uint32_t retryInMs(uint32_t now_ms) const {
+        if (mState != WAITING || due(now_ms)) return 0;
+        return mNextMs - now_ms;
+    }
+
+    static const char* stateName(State s) {
+        switch (s) {
+            case WAITING:    return "waiting";
+            case CONNECTING: return "connecting";
+            case HANDSHAKE:  return "handshake";
+            case CONNECTED:  return "connected";
+        }
+        return "?";
+    }
+
+private:
+    void fail(int err, uint32_t now_ms) {
+        if (mFd >= 0) {
+            ::close(mFd);
+            mFd = -1;
+        }
+        mLastError = err;
+        uint32_t shift = mFailures < 16 ? mFailures : 16;
+        uint32_t cap = BACKOFF_MIN_MS << shift;
+        if (cap > BACKOFF_MAX_MS || cap < BACKOFF_MIN_MS) cap = BACKOFF_MAX_MS;
+        mBackoffMs = cap / 2 + next() % (cap / 2 + 1);
+        mNextMs    = now_ms + mBackoffMs;
+        if (mFailures < 0xFFFF) mFailures++;
+        mState = WAITING;
+    }
+
+    // xorshift32
+    uint32_t next() {
+        mRand ^= mRand << 13;
+        mRand ^= mRand >> 17;
+        mRand ^= mRand << 5;
+        return mRand;
+    }
+
+    State    mState;
+    int      mFd;
+    uint32_t mNextMs;
+    uint32_t mStartMs;
+    uint32_t mUpMs;
+    uint32_t mBackoffMs;
+    uint32_t mRand;
+    uint16_t mFailures;
+    int      mLastError;
+    uint32_t mAttempts;
+    uint32_t mConnects;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Bounded outbox between the firmware and the MQTT client.
+ *
+ * Nothing here talks to the broker: callers queue messages from wherever
+ * they are and the task that owns the client calls flush(), which hands
+ * them to a publish function in order. Two classes of traffic:
+ *
+ *  - status  messages (MQTT_TOPIC_STATUS, e.g. "stream:on") are state
+ *            changes; each one is published on its own, in order, and kept
+ *            until the publish succeeds. STATUS_SLOTS of them are held while
+ *            the broker is away; past that the oldest goes.
+ *  - log     lines (MQTT_TOPIC_VERBOSE) are best effort. They're appended
+ *            to one LOG_BYTES buffer and sent as a single newline-separated
+ *            message at most every BATCH_INTERVAL_MS, or sooner when the
+ *            buffer is half full. While disconnected the oldest lines are
+ *            dropped to make room and a "(N log lines dropped)" message goes
+ *            out ahead of the next batch.
+ *
+ * Status goes first so a backlog of chatter never delays a state change.
+ * Fixed buffers only; not thread-safe (one owning task).
+ */
+class MqttOutbox {
+public:
+    static const size_t   LOG_BYTES         = 2048;
+    static const size_t   LINE_MAX          = 192;
+    static const size_t   BATCH_MAX         = 1024;
+    static const uint8_t  STATUS_SLOTS      = 8;
+    static const size_t   STATUS_LEN        = 96;
+    static const uint32_t BATCH_INTERVAL_MS = 2000;
+
+    // Returns false if the message wasn't handed to the broker.
+    typedef bool (*PublishFn)(const char* topic, const uint8_t* payload, size_t len, bool retained);
+
+    MqttOutbox(const char* status_topic, const char* log_topic)
+        : mStatusTopic(status_topic), mLogTopic(log_topic),
+          mStatusHead(0), mStatusCount(0), mLogLen(0), mDropNote(0),
+          mLastBatchMs(0), mBatched(false),
+          mPublished(0), mBatches(0), mLogDropped(0), mStatusDropped(0) {}
+
+    void status(const char* msg, bool retained) {
+        if (mStatusCount == STATUS_SLOTS) {
+            mStatusHead = (uint8_t)((mStatusHead + 1) % STATUS_SLOTS);
+            mStatusCount--;
+            mStatusDropped++;
+        }
+        StatusSlot& s = mStatus[(mStatusHead + mStatusCount) % STATUS_SLOTS];
+        snprintf(s.text, sizeof(s.text), "%s", msg);
+        s.retained = retained;
+        mStatusCount++;
+    }
+
+    void log(const char* line) {
+        size_t len = strnlen(line, LINE_MAX);
+        while (mLogLen && mLogLen + len + 1 > LOG_BYTES) {
+            dropOldestLine();
+        }
+        memcpy(mLog + mLogLen, line, len);
+        mLogLen += len;
+        mLog[mLogLen++] = '\n';
+    }
+
+    // Publishes what is due. Call often from the task that owns the client;
+    // does nothing while disconnected, so the queues just hold.
+    void flush(bool connected, uint32_t now_ms, PublishFn publish) {
+        if (!connected) return;
+
+        while (mStatusCount) {
+            const StatusSlot& s = mStatus[mStatusHead];
+            if (!publish(mStatusTopic, (const uint8_t*)s.text, strlen(s.text), s.retained)) return;
+            mStatusHead = (uint8_t)((mStatusHead + 1) % STATUS_SLOTS);
+            mStatusCount--;
+            mPublished++;
+        }
+
+        if (mDropNote) {
+            char note[48];
+            int len = snprintf(note, sizeof(note), "(%lu log lines dropped)", (unsigned long)mDropNote);
+            if (!publish(mLogTopic, (const uint8_t*)note, (size_t)len, false)) return;
+            mDropNote = 0;
+            mPublished++;
+        }
+        if (!mLogLen) return;
+        if (mBatched && now_ms - mLastBatchMs < BATCH_INTERVAL_MS && mLogLen < LOG_BYTES / 2) return;
+
+        // Whole lines from the front, up to BATCH_MAX; sent in place
+        size_t n = 0;
+        while (n < mLogLen) {
+            const char* nl = (const char*)memchr(mLog + n, '\n', mLogLen - n);
+            size_t end = (size_t)(nl - mLog) + 1;
+            if (n && end - 1 > BATCH_MAX) break;
+            n = end;
+        }
+        if (!publish(mLogTopic, (const uint8_t*)mLog, n - 1, false)) return;
+        consume(n);
+        mLastBatchMs = now_ms;
+        mBatched = true;
+        mPublished++;
+        mBatches++;
+    }
+
+    size_t   queuedBytes()   const { return mLogLen; }
+    uint8_t  queuedStatus()  const { return mStatusCount; }
+    uint32_t published()     const { return mPublished; }
+    uint32_t batches()       const { return mBatches; }
+    uint32_t logDropped()    const { return mLogDropped; }
+    uint32_t statusDropped() const { return mStatusDropped; }
+
+private:
+    struct StatusSlot {
+        char text[STATUS_LEN];
+        bool retained;
+    };
+
+    void dropOldestLine() {
+        const char* nl = (const char*)memchr(mLog, '\n', mLogLen);
+        consume(nl ? (size_t)(nl - mLog) + 1 : mLogLen);
+        mLogDropped++;
+        mDropNote++;
+    }
+
+    void consume(size_t n) {
+        memmove(mLog, mLog + n, mLogLen - n);
+        mLogLen -= n;
+    }
+
+    const char* mStatusTopic;
+    const char* mLogTopic;
+
+    StatusSlot mStatus[STATUS_SLOTS];
+    uint8_t    mStatusHead;
+    uint8_t    mStatusCount;
+
+    char     mLog[LOG_BYTES];
+    size_t   mLogLen;
+    uint32_t mDropNote;
+    uint32_t mLastBatchMs;
+    bool     mBatched;
+
+    uint32_t mPublished;
+    uint32_t mBatches;
+    uint32_t mLogDropped;
+    uint32_t mStatusDropped;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Hot-path latency probes.
+ *
+ * PERF_SCOPE(stage) times the rest of the enclosing block; PERF_BEGIN(t) /
+ * PERF_END(t, stage) time an explicit span. Samples go into one fixed-bucket
+ * histogram per stage, read back as count/mean/p50/p95/p99/max.
+ *
+ * Timing uses the CPU cycle counter on the ESP32 (per core, so a span must
+ * start and end on the same pinned task) and a monotonic clock on the host.
+ * Build with -DPERF_PROBES=0 and every probe compiles to nothing.
+ */
+
+#ifndef PERF_PROBES
+#define PERF_PROBES 1
+#endif
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <time.h>
+#endif
+
+enum PerfStage {
+    PERF_LOOP,              // one control-task iteration
+    PERF_CAPTURE,           // esp_camera_fb_get()
+    PERF_JPEG_SCAN,         // JPEG header scan
+    PERF_PACKETIZE,         // building RTP packets after the scan
+    PERF_RTSP_POLL,         // RtspServerLite::poll(), all sessions
+    PERF_RTSP_SEND,         // one session's drain, when it sent something
+    PERF_MJPEG,             // MJPEG server poll with viewers connected
+    PERF_WEB,               // web.poll(), including route handlers
+    PERF_MQTT,              // mqtt.loop() / reconnect attempt
+    PERF_OUTBOX,            // MQTT outbox flush
+    PERF_STAGE_COUNT
+};
+
+static inline const char* perf_stage_name(int stage) {
+    static const char* const names[PERF_STAGE_COUNT] = {
+        "loop", "capture", "jpeg_scan", "packetize", "rtsp_poll",
+        "rtsp_send", "mjpeg", "web", "mqtt", "outbox",
+    };
+    return (stage >= 0 && stage < PERF_STAGE_COUNT) ? names[stage] : "?";
+}
+
+static inline uint32_t perf_ticks() {
+#if defined(ARDUINO)
+    return ESP.getCycleCount();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+#endif
+}
+
+/**
+ * Log-linear latency histogram in microseconds: exact below 4 us, then four
+ * buckets per power of two (at most 19% wide) up to about 4 s; anything
+ * longer lands in the last bucket. Percentiles report the bucket's upper
+ * edge, capped at the largest sample seen.
+ *
+ * One writer per histogram; readers on other tasks may see a sample
+ * half-recorded, which only skews a report by one count.
+ */
+class PerfHistogram {
+public:
+    static const int BUCKETS = 84;
+
+    PerfHistogram() { reset(); }
+
+    void reset() {
+        memset(mBuckets, 0, sizeof(mBuckets));
+        mCount = 0;
+        mSumUs = 0;
+        mMaxUs = 0;
+    }
+
+    void record(uint32_t us) {
+        mBuckets[bucketOf(us)]++;
+        mCount++;
+        mSumUs += us;
+        if (us > mMaxUs) mMaxUs = us;
+    }
+
+    uint32_t count()  const { return mCount; }
+    uint32_t maxUs()  const { return mMaxUs; }
+    uint32_t meanUs() const { return mCount ? (uint32_t)(mSumUs / mCount) : 0; }
+
+    // Smallest bucket edge at or above `pct` percent of the samples.
+    uint32_t percentileUs(uint32_t pct) const {
+        if (!mCount) return 0;
+        uint64_t rank = ((uint64_t)mCount * pct + 99) / 100;
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += mBuckets[b];
+            if (seen >= rank) {
+                uint32_t edge = upperEdge(b);
+                return edge < mMaxUs ? edge : mMaxUs;
+            }
+        }
+        return mMaxUs;
+    }
+
+    static int bucketOf(uint32_t us) {
+        if (us < 4) return (int)us;
+        int msb = 31 - __builtin_clz(us);
+        int b = msb * 4 + (int)((us >> (msb - 2)) & 3) - 4;
+        return b < BUCKETS ? b : BUCKETS - 1;
+    }
+
+    static uint32_t upperEdge(int b) {
+        if (b < 4) return (uint32_t)b;
+        int msb = b / 4 + 1;
+        uint32_t lower = (uint32_t)(4 + b % 4) << (msb - 2);
+        return lower + (1u << (msb - 2)) - 1;
+    }
+
+private:
+    uint32_t mBuckets[BUCKETS];
+    uint32_t mCount;
+    uint64_t mSumUs;
+    uint32_t mMaxUs;
+};
+
+/**
+ * One histogram per PerfStage. perf_stats() is the process-wide instance.
+ */
+class PerfStats {
+public:
+    PerfStats() : mTicksPerUs(default_ticks_per_us()) {}
+
+    void record(int stage, uint32_t ticks) {
+        if (stage < 0 || stage >= PERF_STAGE_COUNT) return;
+        mStages[stage].record(ticks / mTicksPerUs);
+    }
+
+    const PerfHistogram& stage(int s) const { return mStages[s]; }
+
+    void reset() {
+        for (int i = 0; i < PERF_STAGE_COUNT; ++i) mStages[i].reset();
+    }
+
+    // {"enabled":true,"stages":{"loop":{"count":..,"mean_us":..,"p50_us":..,...},...}}
+    // Returns the length written, or 0 if out_len was too small.
+    size_t writeJson(char* out, size_t out_len) const {
+        size_t n = 0;
+        int w = snprintf(out, out_len, "{\"enabled\":%s,\"stages\":{", PERF_PROBES ? "true" : "false");
+        if (w < 0 || (size_t)w >= out_len) return 0;
+        n = (size_t)w;
+        bool first = true;
+        for (int i = 0; i < PERF_STAGE_COUNT; ++i) {
+            const PerfHistogram& h = mStages[i];
+            if (!h.count()) continue;
+            w = snprintf(out + n, out_len - n,
+                "%s\"%s\":{\"count\":%lu,\"mean_us\":%lu,\"p50_us\":%lu,\"p95_us\":%lu,"
+                "\"p99_us\":%lu,\"max_us\":%lu}",
+                first ? "" : ",", perf_stage_name(i), (unsigned long)h.count(),
+                (unsigned long)h.meanUs(), (unsigned long)h.percentileUs(50),
+                (unsigned long)h.percentileUs(95), (unsigned long)h.percentileUs(99),
+                (unsigned long)h.maxUs());
+            if (w < 0 || (size_t)w >= out_len - n) return 0;
+            n += (size_t)w;
+            first = false;
+        }
+        if (out_len - n < 3) return 0;
+        out[n++] = '}';
+        out[n++] = '}';
+        out[n] = '\0';
+        return n;
+    }
+
+private:
+    static uint32_t default_ticks_per_us() {
+#if defined(ARDUINO)
+        return ESP.getCpuFreqMHz();
+#else
+        return 1000;                    // nanosecond clock
+#endif
+    }
+
+    PerfHistogram mStages[PERF_STAGE_COUNT];
+    uint32_t      mTicksPerUs;
+};
+
+inline PerfStats& perf_stats() {
+    static PerfStats stats;
+    return stats;
+}
+
+#if PERF_PROBES
+struct PerfScope {
+    int      stage;
+    uint32_t start;
+    explicit PerfScope(int s) : stage(s), start(perf_ticks()) {}
+    ~PerfScope() { perf_stats().record(stage, perf_ticks() - start); }
+};
+#define PERF_SCOPE(stage)   PerfScope perf_scope_(stage)
+#define PERF_BEGIN(t)       uint32_t t = perf_ticks()
+#define PERF_END(t, stage)  perf_stats().record((stage), perf_ticks() - (t))
+#else
+#define PERF_SCOPE(stage)   do {} while (0)
+#define PERF_BEGIN(t)       do {} while (0)
+#define PERF_END(t, stage)  do {} while (0)
+#endif
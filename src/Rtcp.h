@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+
+static const uint32_t RTCP_SR_INTERVAL_MS = 5000;
+static const uint32_t NTP_UNIX_OFFSET     = 2208988800UL;   // 1900 -> 1970
+
+/*
+ * Compound RTCP sender report (SR + SDES CNAME), RFC 3550 6.4.1 / 6.5.
+ * Receivers pair the NTP and RTP timestamps to compute interarrival
+ * jitter and map media time to wall clock. Returns the packet length, or 0
+ * if out is too small.
+ */
+static inline size_t rtcp_build_sr(uint8_t* out, size_t cap,
+                                   uint32_t ssrc, uint32_t rtp_ts,
+                                   uint32_t packets, uint32_t octets,
+                                   const char* cname)
+{
+    size_t cname_len = strlen(cname);
+    if (cname_len > 255) cname_len = 255;
+    // SDES chunk: SSRC + item(type, len, text) + end + pad to 32 bits
+    size_t sdes_body = 4 + 2 + cname_len + 1;
+    sdes_body = (sdes_body + 3) & ~(size_t)3;
+    size_t total = 28 + 4 + sdes_body;
+    if (cap < total) return 0;
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    uint32_t ntp_sec  = (uint32_t)tv.tv_sec + NTP_UNIX_OFFSET;
+    uint32_t ntp_frac = (uint32_t)(((uint64_t)tv.tv_usec << 32) / 1000000);
+
+    uint8_t* p = out;
+    auto put32 = [](uint8_t* d, uint32_t v) {
+        d[0] = (uint8_t)(v >> 24); d[1] = (uint8_t)(v >> 16);
+        d[2] = (uint8_t)(v >> 8);  d[3] = (uint8_t)v;
+    };
+
+    // SR: V=2, RC=0, PT=200, length = 6 words
+    p[0] = 0x80; p[1] = 200; p[2] = 0; p[3] = 6;
+    put32(p + 4,  ssrc);
+    put32(p + 8,  ntp_sec);
+    put32(p + 12, ntp_frac);
+    put32(p + 16, rtp_ts);
+    put32(p + 20, packets);
+    put32(p + 24, octets);
+    p += 28;
+
+    // SDES: V=2, SC=1, PT=202
+    uint16_t words = (uint16_t)(sdes_body / 4);
+    p[0] = 0x81; p[1] = 202; p[2] = (uint8_t)(words >> 8); p[3] = (uint8_t)words;
+    put32(p + 4, ssrc);
+    memset(p + 8, 0, sdes_body - 4);
+    p[8] = 1;                                           // CNAME
+    p[9] = (uint8_t)cname_len;
+    memcpy(p + 10, cname, cname_len);
+
+    return total;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "RtpJpeg.h"
+
+/**
+ * Packetize-once fan-out of RTP/JPEG frames to several RTSP sessions.
+ *
+ * publish() parses and packetizes a JPEG a single time and queues the same
+ * RtpFrame on every subscriber. Each subscriber drains its own queue at its
+ * own pace through a Sink; when a reader falls behind, its newest pending
+ * frame is replaced by the incoming one, so slow clients skip frames
+ * instead of holding back the others. The frame a subscriber is in the
+ * middle of sending is never dropped, which keeps TCP framing intact.
+ *
+ * Queued frames hold their packet slots, so a stalled reader can tie up
+ * most of the pool. When a new frame doesn't fit, the pending frames of
+ * the most backlogged subscribers are dropped until it does, so one stuck
+ * client costs itself frames rather than failing publish() for everyone.
+ *
+ * Not thread-safe: publish() and drain() are expected on the same task.
+ * Both take the caller's millisecond clock so per-frame send time can be
+ * measured without the fan-out depending on a platform timer.
+ *
+ * Sink concept:
+ *   size_t wireLength(const RtpFrame& f, size_t i);         // bytes for packet i
+ *   int    write(const RtpFrame& f, size_t i, size_t off);  // >0 bytes taken, 0 would block, <0 error
+ */
+class RtpFanout {
+public:
+    static const int    MAX_SUBSCRIBERS = 4;
+    static const size_t QUEUE_DEPTH     = 3;    // in-flight frame + pending frames
+
+    static_assert(RTP_POOL_FRAMES >= MAX_SUBSCRIBERS * QUEUE_DEPTH + 1,
+                  "RTP_POOL_FRAMES must cover every queue slot plus the frame being published");
+
+    struct SubscriberStats {
+        uint32_t frames_sent;
+        uint32_t frames_dropped;
+        uint32_t packets_sent;
+        uint32_t bytes_sent;
+        uint32_t last_send_ms;     // queue-to-last-byte time of the last complete frame
+    };
+
+    explicit RtpFanout(uint32_t ssrc)
+        : mPacketizer(ssrc), mFramesPublished(0), mFramesFailed(0), mFramesSent(0),
+          mFramesDropped(0), mLastPacketCount(0)
+    {
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) mSubs[i].active = false;
+    }
+
+    ~RtpFanout() {
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) unsubscribe(i);
+    }
+
+    RtpFanout(const RtpFanout&) = delete;
+    RtpFanout& operator=(const RtpFanout&) = delete;
+
+    // Returns a subscriber id, or -1 when the table is full.
+    int subscribe() {
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            if (!mSubs[i].active) {
+                Subscriber& s = mSubs[i];
+                memset(&s, 0, sizeof(s));
+                s.active = true;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void unsubscribe(int id) {
+        if (!valid(id)) return;
+        Subscriber& s = mSubs[id];
+        while (s.count) popFront(s);
+        s.active = false;
+    }
+
+    bool hasSubscribers() const {
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            if (mSubs[i].active) return true;
+        }
+        return false;
+    }
+
+    // Packetize once and queue on every subscriber. Skips all work when
+    // nobody is listening.
+    bool publish(const uint8_t* jpeg, size_t len, uint32_t timestamp, uint32_t now_ms = 0,
+                 uint16_t header_key = 0) {
+        if (!hasSubscribers()) return false;
+
+        uint32_t exhausted = poolStats().exhausted;
+        RtpFrame* frame = mPacketizer.packetize(jpeg, len, timestamp, header_key);
+        while (!frame && poolStats().exhausted != exhausted && evictPending()) {
+            exhausted = poolStats().exhausted;
+            frame = mPacketizer.packetize(jpeg, len, timestamp, header_key);
+        }
+        if (!frame) {
+            mFramesFailed++;
+            return false;
+        }
+        mFramesPublished++;
+        mLastPacketCount = frame->count;
+        frame->queued_ms = now_ms;
+
+        frame->refs = 1;    // held across the loop so a drop can't free it early
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            Subscriber& s = mSubs[i];
+            if (!s.active) continue;
+            // Replace the newest pending frame; slot 0 may be mid-send.
+            if (s.count == QUEUE_DEPTH) dropNewest(s);
+            s.queue[(s.head + s.count) % QUEUE_DEPTH] = frame;
+            s.count++;
+            frame->refs++;
+        }
+        RtpFrame::release(frame);
+        return true;
+    }
+
+    // Send as much of subscriber id's queue as the sink accepts, at most
+    // max_packets whole packets. Returns packets completed, or -1 if the
+    // sink reported an error.
+    template <class Sink>
+    int drain(int id, Sink& sink, size_t max_packets, uint32_t now_ms = 0) {
+        if (!valid(id)) return -1;
+        Subscriber& s = mSubs[id];
+        int done = 0;
+        while (s.count && (size_t)done < max_packets) {
+            const RtpFrame& f = *s.queue[s.head];
+            size_t wire = sink.wireLength(f, s.packet);
+            int n = sink.write(f, s.packet, s.offset);
+            if (n < 0) return -1;
+            if (n == 0) break;
+
+            s.offset += (size_t)n;
+            if (s.offset < wire) break;                 // partial write, socket is full
+            s.offset = 0;
+            s.stats.packets_sent++;
+            s.stats.bytes_sent += f.length(s.packet);
+            done++;
+
+            if (++s.packet == f.count) {
+                s.packet = 0;
+                s.stats.frames_sent++;
+                s.stats.last_send_ms = now_ms - f.queued_ms;
+                mFramesSent++;
+                popFront(s);
+            }
+        }
+        return done;
+    }
+
+    // True when subscriber id has nothing queued.
+    bool idle(int id) const { return !valid(id) || mSubs[id].count == 0; }
+
+    // True while a packet for subscriber id is partially written; nothing
+    // else may be interleaved on its stream until it completes.
+    bool midPacket(int id) const { return valid(id) && mSubs[id].offset != 0; }
+
+    const SubscriberStats& stats(int id) const { return mSubs[id].stats; }
+
+    // Worst-case view across subscribers, for congestion control
+    size_t maxBacklog() const {
+        size_t m = 0;
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            if (mSubs[i].active && mSubs[i].count > m) m = mSubs[i].count;
+        }
+        return m;
+    }
+    uint32_t maxSendMs() const {
+        uint32_t m = 0;
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            if (mSubs[i].active && mSubs[i].stats.last_send_ms > m) m = mSubs[i].stats.last_send_ms;
+        }
+        return m;
+    }
+
+    // Cumulative over all subscribers, including ones that have left
+    uint32_t framesSent()    const { return mFramesSent; }
+    uint32_t framesDropped() const { return mFramesDropped; }
+    uint32_t framesPublished() const { return mFramesPublished; }
+    uint32_t framesFailed()    const { return mFramesFailed; }
+    uint16_t lastPacketCount() const { return mLastPacketCount; }
+    uint32_t ssrc()            const { return mPacketizer.ssrc(); }
+    uint16_t nextSeq()         const { return mPacketizer.nextSeq(); }
+    const JpegScanner& scanner() const { return mPacketizer.scanner(); }
+    const RtpPacketPool::Stats& poolStats() const { return mPacketizer.pool().stats(); }
+    bool reserve() { return mPacketizer.reserve(); }
+
+private:
+    struct Subscriber {
+        bool      active;
+        RtpFrame* queue[QUEUE_DEPTH];
+        size_t    head;
+        size_t    count;
+        size_t    packet;      // next packet of queue[head]
+        size_t    offset;      // bytes of that packet already written
+        SubscriberStats stats;
+    };
+
+    bool valid(int id) const {
+        return id >= 0 && id < MAX_SUBSCRIBERS && mSubs[id].active;
+    }
+
+    void dropNewest(Subscriber& s) {
+        size_t tail = (s.head + s.count - 1) % QUEUE_DEPTH;
+        RtpFrame::release(s.queue[tail]);
+        s.count--;
+        s.stats.frames_dropped++;
+        mFramesDropped++;
+    }
+
+    // Drops every pending frame (all but the one at the head) of the
+    // subscriber with the most of them. False when nobody has any.
+    bool evictPending() {
+        Subscriber* worst = nullptr;
+        for (int i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            Subscriber& s = mSubs[i];
+            if (s.active && s.count > 1 && (!worst || s.count > worst->count)) worst = &s;
+        }
+        if (!worst) return false;
+        while (worst->count > 1) dropNewest(*worst);
+        return true;
+    }
+
+    static void popFront(Subscriber& s) {
+        RtpFrame::release(s.queue[s.head]);
+        s.head = (s.head + 1) % QUEUE_DEPTH;
+        s.count--;
+        s.packet = 0;
+        s.offset = 0;
+    }
+
+    RtpJpegPacketizer mPacketizer;
+    Subscriber        mSubs[MAX_SUBSCRIBERS];
+    uint32_t          mFramesPublished;
+    uint32_t          mFramesFailed;
+    uint32_t          mFramesSent;
+    uint32_t          mFramesDropped;
+    uint16_t          mLastPacketCount;
+};
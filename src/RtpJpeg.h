@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JpegScanner.h"
+#include "PerfProbe.h"
+#include "RtpPacketPool.h"
+
+/*
+ * RTP/JPEG (RFC 2435) packetization.
+ *
+ * A frame is parsed and cut into RTP packets exactly once; the resulting
+ * RtpFrame is immutable and refcounted so every RTSP session can send the
+ * same packet buffers. Packets are built in slots from a fixed RtpPacketPool,
+ * so steady-state streaming does no heap allocation. Each packet slot
+ * carries 4 bytes of headroom holding an RTSP interleaved header ('$',
+ * channel 0, length) so TCP sessions on channel 0 can write prefix + packet
+ * in one call.
+ */
+
+static const size_t  RTP_HEADER_SIZE      = 12;
+static const size_t  RTP_JPEG_HEADER_SIZE = 8;
+static const uint8_t RTP_PAYLOAD_JPEG     = 26;
+static const uint32_t RTP_JPEG_CLOCK_HZ   = 90000;
+
+/**
+ * Cuts a parsed JPEG into RFC 2435 packets. Keeps the RTP sequence counter
+ * and SSRC, which are shared by every session fed from the same packetizer.
+ */
+class RtpJpegPacketizer {
+public:
+    explicit RtpJpegPacketizer(uint32_t ssrc) : mSsrc(ssrc), mSeq(0) {}
+
+    uint32_t ssrc()    const { return mSsrc; }
+    uint16_t nextSeq() const { return mSeq; }
+    const JpegScanner& scanner() const { return mScanner; }
+    const RtpPacketPool& pool() const { return mPool; }
+
+    // Allocate the packet pool; otherwise done on the first packetize().
+    bool reserve() { return mPool.reserve(); }
+
+    // Returns a frame with refs == 0; the caller takes the references.
+    // header_key (JpegScanner::key()) lets the header layout be reused
+    // across frames with the same quality/framesize; 0 parses every frame.
+    RtpFrame* packetize(const uint8_t* jpeg, size_t len, uint32_t timestamp, uint16_t header_key = 0) {
+        JpegInfo info;
+        PERF_BEGIN(scan_start);
+        bool parsed = mScanner.scan(jpeg, len, info, header_key);
+        PERF_END(scan_start, PERF_JPEG_SCAN);
+        if (!parsed || info.scan_len == 0) return nullptr;
+        PERF_SCOPE(PERF_PACKETIZE);
+        if (info.width > 2040 || info.height > 2040) return nullptr;   // 8-bit width/8 field
+
+        const bool   restart   = (info.type & 64) != 0;
+        const size_t fixed     = RTP_HEADER_SIZE + RTP_JPEG_HEADER_SIZE + (restart ? 4 : 0);
+        const size_t qhdr      = 4 + 64 * info.qtable_count;
+        const size_t first_cap = RTP_MAX_PACKET_SIZE - fixed - qhdr;
+        const size_t cap       = RTP_MAX_PACKET_SIZE - fixed;
+
+        size_t count = 1;
+        if (info.scan_len > first_cap) {
+            count += (info.scan_len - first_cap + cap - 1) / cap;
+        }
+        if (count > 0xFFFF) return nullptr;
+
+        if (!mPool.reserved() && !mPool.reserve()) return nullptr;
+        RtpFrame* frame = mPool.acquire((uint16_t)count);
+        if (!frame) return nullptr;
+        frame->timestamp = timestamp;
+
+        size_t offset = 0;
+        for (size_t p = 0; p < count; ++p) {
+            uint8_t* out = (uint8_t*)frame->prefixed(p);
+            uint8_t* pkt = out + RTP_INTERLEAVE_SIZE;
+            size_t chunk = info.scan_len - offset;
+            size_t room = (p == 0) ? first_cap : cap;
+            if (chunk > room) chunk = room;
+            bool last = (offset + chunk == info.scan_len);
+
+            // RTP header
+            pkt[0] = 0x80;
+            pkt[1] = RTP_PAYLOAD_JPEG | (last ? 0x80 : 0x00);
+            put16(pkt + 2, mSeq++);
+            put32(pkt + 4, timestamp);
+            put32(pkt + 8, mSsrc);
+
+            // JPEG header
+            uint8_t* h = pkt + RTP_HEADER_SIZE;
+            h[0] = 0;                                   // type-specific
+            h[1] = (uint8_t)(offset >> 16);
+            h[2] = (uint8_t)(offset >> 8);
+            h[3] = (uint8_t)offset;
+            h[4] = info.type;
+            h[5] = 255;                                 // Q = 255: tables sent in-band
+            h[6] = (uint8_t)(info.width / 8);
+            h[7] = (uint8_t)(info.height / 8);
+            h += RTP_JPEG_HEADER_SIZE;
+
+            if (restart) {
+                put16(h, info.restart_interval);
+                h[2] = 0xFF;                            // F = L = 1, count 0x3FFF
+                h[3] = 0xFF;
+                h += 4;
+            }
+            if (p == 0) {
+                h[0] = 0;                               // MBZ
+                h[1] = 0;                               // 8-bit precision
+                put16(h + 2, (uint16_t)(64 * info.qtable_count));
+                h += 4;
+                for (uint8_t t = 0; t < info.qtable_count; ++t) {
+                    // A missing chroma table reuses luma rather than sending garbage
+                    const uint8_t* q = info.qtables[t] ? info.qtables[t] : info.qtables[0];
+                    memcpy(h, q, 64);
+                    h += 64;
+                }
+            }
+
+            memcpy(h, info.scan + offset, chunk);
+            h += chunk;
+            offset += chunk;
+
+            uint16_t rtp_len = (uint16_t)(h - pkt);
+            out[0] = '$';
+            out[1] = 0;                                 // channel 0
+            put16(out + 2, rtp_len);
+            frame->lens[p] = rtp_len;
+            frame->payload_bytes += rtp_len;
+        }
+        return frame;
+    }
+
+private:
+    static void put16(uint8_t* p, uint16_t v) {
+        p[0] = (uint8_t)(v >> 8);
+        p[1] = (uint8_t)v;
+    }
+    static void put32(uint8_t* p, uint32_t v) {
+        p[0] = (uint8_t)(v >> 24);
+        p[1] = (uint8_t)(v >> 16);
+        p[2] = (uint8_t)(v >> 8);
+        p[3] = (uint8_t)v;
+    }
+
+    RtpPacketPool mPool;
+    JpegScanner   mScanner;
+    uint32_t      mSsrc;
+    uint16_t      mSeq;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Spreads one frame's RTP packets across the frame interval instead of
+ * bursting them, so a 30-packet VGA frame doesn't overrun the Wi-Fi TX
+ * queue or a receiver's socket buffer on a lossy link.
+ *
+ * The frame interval is learned from how often frames are published; the
+ * packets of a frame are spaced over SPREAD_PERCENT of it. Times are in
+ * microseconds and compared by difference, so micros() wrap is harmless.
+ */
+class RtpPacer {
+public:
+    static const uint32_t SPREAD_PERCENT  = 75;
+    static const uint32_t MAX_SPACING_US  = 20000;
+
+    RtpPacer() : mSpacingUs(0), mNextUs(0) {}
+
+    // Call when the first packet of a frame is about to go out.
+    void startFrame(uint32_t now_us, uint32_t frame_interval_us, uint16_t packets) {
+        mSpacingUs = 0;
+        if (frame_interval_us && packets > 1) {
+            mSpacingUs = (uint32_t)((uint64_t)frame_interval_us * SPREAD_PERCENT / 100 / packets);
+            if (mSpacingUs > MAX_SPACING_US) mSpacingUs = MAX_SPACING_US;
+        }
+        mNextUs = now_us;
+    }
+
+    bool ready(uint32_t now_us) const {
+        return (int32_t)(now_us - mNextUs) >= 0;
+    }
+
+    // Schedule the next packet. If we are already late (slow poll loop) the
+    // schedule restarts from now rather than releasing a catch-up burst.
+    void sent(uint32_t now_us) {
+        mNextUs += mSpacingUs;
+        if ((int32_t)(now_us - mNextUs) > (int32_t)mSpacingUs) mNextUs = now_us;
+    }
+
+    uint32_t spacingUs() const { return mSpacingUs; }
+
+private:
+    uint32_t mSpacingUs;
+    uint32_t mNextUs;
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <esp32-hal-psram.h>
+#include <esp_heap_caps.h>
+#endif
+
+static const size_t RTP_MAX_PACKET_SIZE   = 1400;   // RTP header + payload, fits a 1500 MTU
+static const size_t RTP_INTERLEAVE_SIZE   = 4;
+static const size_t RTP_PACKET_STRIDE     = RTP_INTERLEAVE_SIZE + RTP_MAX_PACKET_SIZE;
+static const size_t RTP_MAX_FRAME_PACKETS = 160;    // ~215 KB of JPEG scan data
+
+// Packet slots in internal RAM (used first) and PSRAM. Without PSRAM only
+// the internal slots exist, which limits frames to about 22 KB.
+#ifndef RTP_POOL_INTERNAL_SLOTS
+#define RTP_POOL_INTERNAL_SLOTS 16
+#endif
+#ifndef RTP_POOL_PSRAM_SLOTS
+#define RTP_POOL_PSRAM_SLOTS 320
+#endif
+// Frame descriptors: every fan-out queue slot plus the frame being published.
+#ifndef RTP_POOL_FRAMES
+#define RTP_POOL_FRAMES 13
+#endif
+
+class RtpPacketPool;
+
+/**
+ * One packetized frame. Each packet lives in its own pool slot, preceded by
+ * its interleaved-TCP prefix. Descriptors are pool-owned; release() returns
+ * the frame and all of its slots once the last reference is dropped.
+ */
+struct RtpFrame {
+    uint16_t       refs;
+    uint16_t       count;
+    uint32_t       timestamp;
+    uint32_t       queued_ms;        // when the fan-out queued it, for send-time stats
+    size_t         payload_bytes;    // sum of RTP packet lengths
+    RtpPacketPool* pool;
+    uint16_t       lens[RTP_MAX_FRAME_PACKETS];    // RTP packet lengths (without prefix)
+    uint16_t       slots[RTP_MAX_FRAME_PACKETS];   // pool slot of each packet
+
+    inline const uint8_t* prefixed(size_t i) const;
+    const uint8_t* packet(size_t i) const { return prefixed(i) + RTP_INTERLEAVE_SIZE; }
+    uint16_t       length(size_t i) const { return lens[i]; }
+
+    static inline void release(RtpFrame* f);
+};
+
+/**
+ * Fixed-capacity pool of MTU-sized RTP packet slots and frame descriptors.
+ *
+ * Everything is allocated once by reserve(), so packetizing and sending
+ * never touch the heap afterwards. Slots in internal RAM are handed out
+ * before PSRAM ones. acquire() is all-or-nothing: when a frame needs more
+ * slots (or descriptors) than are free it fails at once and the frame is
+ * skipped, rather than partially built. In-use counts keep high-water marks
+ * for sizing.
+ *
+ * Not thread-safe: acquire and release on the streaming task only.
+ */
+class RtpPacketPool {
+public:
+    struct Stats {
+        uint16_t internal_slots;
+        uint16_t psram_slots;
+        uint16_t in_use;
+        uint16_t high_water;
+        uint16_t internal_high_water;
+        uint16_t psram_high_water;
+        uint16_t frames;
+        uint16_t frames_in_use;
+        uint16_t frames_high_water;
+        uint32_t exhausted;           // acquire() failures for lack of slots or descriptors
+        uint32_t oversize;            // frames over RTP_MAX_FRAME_PACKETS
+    };
+
+    RtpPacketPool()
+        : mInternal(nullptr), mPsram(nullptr), mFreeInternal(nullptr), mFreePsram(nullptr),
+          mFrames(nullptr), mFreeFrames(nullptr), mInternalFree(0), mPsramFree(0), mFramesFree(0)
+    {
+        memset(&mStats, 0, sizeof(mStats));
+    }
+
+    ~RtpPacketPool() { freeAll(); }
+
+    RtpPacketPool(const RtpPacketPool&) = delete;
+    RtpPacketPool& operator=(const RtpPacketPool&) = delete;
+
+    // Allocate the pool. Call once, after PSRAM is up; later calls are no-ops.
+    bool reserve(uint16_t internal_slots = RTP_POOL_INTERNAL_SLOTS,
+                 uint16_t psram_slots = RTP_POOL_PSRAM_SLOTS,
+                 uint16_t frames = RTP_POOL_FRAMES) {
+        if (reserved()) return true;
+#if defined(ARDUINO)
+        if (!psramFound()) psram_slots = 0;
+#endif
+        mInternal     = (uint8_t*)allocInternal((size_t)internal_slots * RTP_PACKET_STRIDE);
+        mPsram        = psram_slots ? (uint8_t*)allocPsram((size_t)psram_slots * RTP_PACKET_STRIDE) : nullptr;
+        mFreeInternal = (uint16_t*)allocInternal(internal_slots * sizeof(uint16_t));
+        mFreePsram    = (uint16_t*)allocInternal(psram_slots * sizeof(uint16_t));
+        mFrames       = (RtpFrame*)allocInternal(frames * sizeof(RtpFrame));
+        mFreeFrames   = (RtpFrame**)allocInternal(frames * sizeof(RtpFrame*));
+        if (!mInternal || (psram_slots && !mPsram) || !mFreeInternal || !mFreePsram ||
+            !mFrames || !mFreeFrames) {
+            freeAll();
+            return false;
+        }
+
+        for (uint16_t i = 0; i < internal_slots; ++i) mFreeInternal[i] = internal_slots - 1 - i;
+        for (uint16_t i = 0; i < psram_slots; ++i)    mFreePsram[i] = internal_slots + psram_slots - 1 - i;
+        for (uint16_t i = 0; i < frames; ++i) {
+            mFrames[i].pool = this;
+            mFreeFrames[i] = &mFrames[i];
+        }
+        mInternalFree = internal_slots;
+        mPsramFree    = psram_slots;
+        mFramesFree   = frames;
+        mStats.internal_slots = internal_slots;
+        mStats.psram_slots    = psram_slots;
+        mStats.frames         = frames;
+        return true;
+    }
+
+    bool reserved() const { return mFrames != nullptr; }
+
+    // A descriptor with `count` packet slots and refs == 0, or nullptr when
+    // the pool can't supply all of them.
+    RtpFrame* acquire(uint16_t count) {
+        if (count > RTP_MAX_FRAME_PACKETS) {
+            mStats.oversize++;
+            return nullptr;
+        }
+        if (!mFramesFree || count > mInternalFree + mPsramFree) {
+            mStats.exhausted++;
+            return nullptr;
+        }
+
+        RtpFrame* f = mFreeFrames[--mFramesFree];
+        f->refs = 0;
+        f->count = count;
+        f->timestamp = 0;
+        f->queued_ms = 0;
+        f->payload_bytes = 0;
+        for (uint16_t i = 0; i < count; ++i) {
+            f->slots[i] = mInternalFree ? mFreeInternal[--mInternalFree] : mFreePsram[--mPsramFree];
+        }
+
+        uint16_t internal_used = mStats.internal_slots - mInternalFree;
+        uint16_t psram_used    = mStats.psram_slots - mPsramFree;
+        mStats.in_use        = internal_used + psram_used;
+        mStats.frames_in_use = mStats.frames - mFramesFree;
+        if (mStats.in_use > mStats.high_water)               mStats.high_water = mStats.in_use;
+        if (internal_used > mStats.internal_high_water)      mStats.internal_high_water = internal_used;
+        if (psram_used > mStats.psram_high_water)            mStats.psram_high_water = psram_used;
+        if (mStats.frames_in_use > mStats.frames_high_water) mStats.frames_high_water = mStats.frames_in_use;
+        return f;
+    }
+
+    void release(RtpFrame* f) {
+        for (uint16_t i = 0; i < f->count; ++i) {
+            uint16_t s = f->slots[i];
+            if (s < mStats.internal_slots) mFreeInternal[mInternalFree++] = s;
+            else                           mFreePsram[mPsramFree++] = s;
+        }
+        mFreeFrames[mFramesFree++] = f;
+        mStats.in_use -= f->count;
+        mStats.frames_in_use--;
+    }
+
+    uint8_t* slot(uint16_t i) const {
+        return i < mStats.internal_slots ? mInternal + (size_t)i * RTP_PACKET_STRIDE
+                                         : mPsram + (size_t)(i - mStats.internal_slots) * RTP_PACKET_STRIDE;
+    }
+
+    const Stats& stats() const { return mStats; }
+
+private:
+    void freeAll() {
+        free(mInternal);
+        free(mPsram);
+        free(mFreeInternal);
+        free(mFreePsram);
+        free(mFrames);
+        free(mFreeFrames);
+        mInternal = mPsram = nullptr;
+        mFreeInternal = mFreePsram = nullptr;
+        mFrames = nullptr;
+        mFreeFrames = nullptr;
+    }
+
+    static void* allocInternal(size_t n) {
+#if defined(ARDUINO)
+        return heap_caps_malloc(n ? n : 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+        return malloc(n ? n : 1);
+#endif
+    }
+    static void* allocPsram(size_t n) {
+#if defined(ARDUINO)
+        return ps_malloc(n);
+#else
+        return malloc(n);
+#endif
+    }
+
+    uint8_t*   mInternal;
+    uint8_t*   mPsram;
+    uint16_t*  mFreeInternal;
+    uint16_t*  mFreePsram;
+    RtpFrame*  mFrames;
+    RtpFrame** mFreeFrames;
+    uint16_t   mInternalFree;
+    uint16_t   mPsramFree;
+    uint16_t   mFramesFree;
+    Stats      mStats;
+};
+
+inline const uint8_t* RtpFrame::prefixed(size_t i) const {
+    return pool->slot(slots[i]);
+}
+
+inline void RtpFrame::release(RtpFrame* f) {
+    if (f && --f->refs == 0) f->pool->release(f);
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// One parsed RTSP request; only the headers the server acts on are kept.
+struct RtspRequest {
+    char     method[16];
+    char     url[160];
+    int      cseq;
+    char     transport[128];
+    char     session[32];
+    size_t   content_length;
+};
+
+/**
+ * Incremental RTSP request parser.
+ *
+ * Bytes are fed as they arrive from a non-blocking socket; feed() consumes
+ * what it can and reports when a full request is ready. Interleaved binary
+ * frames from the client ('$' channel length payload, e.g. RTCP receiver
+ * reports over TCP) and request bodies are skipped without buffering.
+ */
+class RtspRequestParser {
+public:
+    enum Result {
+        NEED_MORE,     // consumed everything, no complete request yet
+        REQUEST,       // request() is valid until the next feed()
+        INTERLEAVED,   // skipped one complete interleaved frame
+        TOO_LARGE      // header block overflowed the buffer; drop the client
+    };
+
+    static const size_t MAX_HEADER = 1024;
+
+    RtspRequestParser() { reset(); }
+
+    void reset() {
+        mState = START;
+        mLen = 0;
+        mSkip = 0;
+    }
+
+    // Consume up to len bytes. Stops right after a complete request or
+    // interleaved frame so the caller can act before feeding the rest.
+    size_t feed(const uint8_t* data, size_t len, Result& result) {
+        size_t used = 0;
+        result = NEED_MORE;
+        while (used < len) {
+            switch (mState) {
+            case START:
+                if (data[used] == '$') {
+                    mState = BIN_HEADER;
+                    mLen = 0;
+                } else if (data[used] == '\r' || data[used] == '\n') {
+                    ++used;                             // stray line ending between requests
+                } else {
+                    mState = HEADERS;
+                    mLen = 0;
+                }
+                break;
+
+            case BIN_HEADER:
+                mBuf[mLen++] = (char)data[used++];
+                if (mLen == 4) {
+                    mSkip = ((uint8_t)mBuf[2] << 8) | (uint8_t)mBuf[3];
+                    mState = mSkip ? BIN_BODY : START;
+                    if (!mSkip) { result = INTERLEAVED; return used; }
+                }
+                break;
+
+            case BIN_BODY: {
+                size_t n = len - used < mSkip ? len - used : mSkip;
+                used += n;
+                mSkip -= n;
+                if (mSkip == 0) {
+                    mState = START;
+                    result = INTERLEAVED;
+                    return used;
+                }
+                break;
+            }
+
+            case HEADERS:
+                if (mLen + 1 >= MAX_HEADER) {
+                    result = TOO_LARGE;
+                    return used;
+                }
+                mBuf[mLen++] = (char)data[used++];
+                if (mLen >= 4 && memcmp(mBuf + mLen - 4, "\r\n\r\n", 4) == 0) {
+                    mBuf[mLen] = '\0';
+                    parse();
+                    mSkip = mReq.content_length;
+                    mState = mSkip ? BODY : START;
+                    result = REQUEST;
+                    return used;
+                }
+                break;
+
+            case BODY: {
+                size_t n = len - used < mSkip ? len - used : mSkip;
+                used += n;
+                mSkip -= n;
+                if (mSkip == 0) mState = START;
+                break;
+            }
+            }
+        }
+        return used;
+    }
+
+    const RtspRequest& request() const { return mReq; }
+
+private:
+    enum State { START, HEADERS, BODY, BIN_HEADER, BIN_BODY };
+
+    void parse() {
+        memset(&mReq, 0, sizeof(mReq));
+        mReq.cseq = -1;
+
+        char* line = mBuf;
+        char* eol = strstr(line, "\r\n");
+        if (!eol) return;
+        *eol = '\0';
+
+        // Request line: METHOD URL RTSP/1.0
+        char* sp = strchr(line, ' ');
+        if (sp) {
+            copy(mReq.method, sizeof(mReq.method), line, sp - line);
+            char* url = sp + 1;
+            char* sp2 = strchr(url, ' ');
+            copy(mReq.url, sizeof(mReq.url), url, sp2 ? (size_t)(sp2 - url) : strlen(url));
+        }
+
+        for (line = eol + 2; *line; line = eol + 2) {
+            eol = strstr(line, "\r\n");
+            if (!eol || eol == line) break;
+            *eol = '\0';
+
+            char* colon = strchr(line, ':');
+            if (!colon) continue;
+            *colon = '\0';
+            char* value = colon + 1;
+            while (*value == ' ' || *value == '\t') ++value;
+
+            if (strcasecmp(line, "CSeq") == 0) {
+                mReq.cseq = atoi(value);
+            } else if (strcasecmp(line, "Transport") == 0) {
+                copy(mReq.transport, sizeof(mReq.transport), value, strlen(value));
+            } else if (strcasecmp(line, "Session") == 0) {
+                // Strip ";timeout=..." if a client echoes it back
+                char* semi = strchr(value, ';');
+                copy(mReq.session, sizeof(mReq.session), value,
+                     semi ? (size_t)(semi - value) : strlen(value));
+            } else if (strcasecmp(line, "Content-Length") == 0) {
+                mReq.content_length = (size_t)atoi(value);
+            }
+        }
+    }
+
+    static void copy(char* dst, size_t cap, const char* src, size_t n) {
+        if (n >= cap) n = cap - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+
+    State       mState;
+    char        mBuf[MAX_HEADER];
+    size_t      mLen;
+    size_t      mSkip;
+    RtspRequest mReq;
+};
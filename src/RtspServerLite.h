@@ -1,36 +1,536 @@
 #pragma once
-#include <WiFiClient.h>
-#include "CamStreamer.h"
-#include "CRtspSession.h"
+#include <WiFi.h>
+#include <errno.h>
+#include <stdio.h>
+
+#if defined(ARDUINO)
+#include <lwip/sockets.h>
+#else
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "PerfProbe.h"
+#include "Rtcp.h"
+#include "RtpFanout.h"
+#include "RtpPacer.h"
+#include "RtspRequest.h"
 
 /**
- * Lightweight wrapper around Micro-RTSP’s CRtspSession.
- * Handles one client at a time.
+ * Non-blocking multi-session RTSP server for a single MJPEG track.
+ *
+ * A fixed session table holds every connected client. poll() does a
+ * bounded amount of work per call -- accept at most one client, read one
+ * chunk per session, answer at most one request per session, and drain a
+ * few RTP packets per playing session -- so the caller's loop (web, MQTT,
+ * OTA) keeps running while viewers are connected. On an interleaved session
+ * RTSP replies and RTP packets share the TCP stream, so a reply is held
+ * until the packet being written is complete. Frames are handed in
+ * with pushFrame() and fanned out to every playing session through
+ * RtpFanout, either interleaved over the RTSP TCP connection or as UDP
+ * unicast RTP/RTCP when the client asks for it in SETUP. UDP packets are
+ * paced across the frame interval, and every session gets periodic RTCP
+ * sender reports.
+ *
+ * A session that sends nothing for the session timeout -- no request, no
+ * interleaved data and, over UDP, no RTCP receiver report from its client
+ * RTCP port -- is closed whatever its state, so a viewer that vanished
+ * without a FIN doesn't keep its slot (or the RTP sent to it) forever.
  */
 class RtspServerLite {
 public:
-    RtspServerLite(int port, u_short width = 640, u_short height = 480)
-        : tcpServer(port), width(width), height(height) {}
+    static const int      MAX_SESSIONS        = RtpFanout::MAX_SUBSCRIBERS;
+    static const size_t   READ_CHUNK          = 512;
+    static const size_t   PACKETS_PER_POLL    = 8;
+    static const uint32_t SESSION_TIMEOUT_MS  = 60000;   // idle limit in any state
+    static const uint16_t DEFAULT_RTP_PORT    = 6970;    // RTCP on the next port
+
+    explicit RtspServerLite(int port, const char* name = "ESP32-CAM",
+                            uint16_t rtp_port = DEFAULT_RTP_PORT)
+        : tcpServer(port), mName(name), mFanout(0x45535033u /* "ESP3" */),
+          mNextSessionId(0x1000), mRtpPort(rtp_port), mRtpFd(-1), mRtcpFd(-1),
+          mLastFrameMs(0), mFrameIntervalUs(0), mSessionTimeoutMs(SESSION_TIMEOUT_MS) {}
+
+    void begin() {
+        tcpServer.begin();
+        tcpServer.setNoDelay(true);
+        mFanout.reserve();
+        mRtpFd  = openUdp(mRtpPort);
+        mRtcpFd = openUdp(mRtpPort + 1);
+    }
+
+    // Idle limit for new and existing sessions (tests shorten it).
+    void setSessionTimeoutMs(uint32_t ms) { mSessionTimeoutMs = ms; }
+
+    // Bounded, non-blocking service of all sessions. Call from loop().
+    void poll() {
+        PERF_SCOPE(PERF_RTSP_POLL);
+        acceptOne();
+        uint32_t now = millis();
+        drainRtcp(now);
+        for (int i = 0; i < MAX_SESSIONS; ++i) {
+            Session& s = mSessions[i];
+            if (!s.active) continue;
+
+            if (!flushResponse(s) || !readAndHandle(s, now)) {
+                closeSession(s);
+                continue;
+            }
+            if (s.state == PLAYING) {
+                maybeSendReport(s, now);
+                PERF_BEGIN(send_start);
+                int sent = 0;
+                if (s.udp) {
+                    UdpSink sink(*this, s);
+                    sent = mFanout.drain(s.sub, sink, PACKETS_PER_POLL, now);
+                } else if (s.resp_len == 0) {
+                    TcpSink sink(s);
+                    sent = mFanout.drain(s.sub, sink, PACKETS_PER_POLL, now);
+                } else if (s.resp_off == 0 && mFanout.midPacket(s.sub)) {
+                    // A reply is waiting: finish the packet in progress only
+                    TcpSink sink(s);
+                    sent = mFanout.drain(s.sub, sink, 1, now);
+                }
+                if (sent < 0) {
+                    closeSession(s);
+                    continue;
+                }
+                if (sent > 0) PERF_END(send_start, PERF_RTSP_SEND);
+            }
+            if (now - s.last_rx_ms > mSessionTimeoutMs) {
+                closeSession(s);
+            }
+        }
+    }
+
+    // True when at least one session is in PLAY state.
+    bool hasViewers() const { return mFanout.hasSubscribers(); }
+
+    // Packetize once and queue for every playing session.
+    bool pushFrame(const uint8_t* jpeg, size_t len, uint32_t stamp_ms, uint16_t header_key = 0) {
+        // Learn the frame interval for UDP pacing (EWMA, 1/8 weight)
+        if (mLastFrameMs && stamp_ms > mLastFrameMs) {
+            uint32_t us = (stamp_ms - mLastFrameMs) * 1000;
+            mFrameIntervalUs = mFrameIntervalUs ? mFrameIntervalUs - mFrameIntervalUs / 8 + us / 8 : us;
+        }
+        mLastFrameMs = stamp_ms;
+        return mFanout.publish(jpeg, len, stamp_ms * (RTP_JPEG_CLOCK_HZ / 1000), millis(), header_key);
+    }
+
+    int sessionCount() const {
+        int n = 0;
+        for (int i = 0; i < MAX_SESSIONS; ++i) n += mSessions[i].active ? 1 : 0;
+        return n;
+    }
+
+    const RtpFanout& fanout() const { return mFanout; }
+    uint32_t frameIntervalMs() const { return mFrameIntervalUs / 1000; }
+
+private:
+    enum State { INIT, READY, PLAYING };
+
+    struct Session {
+        bool              active;
+        WiFiClient        client;
+        int               fd;
+        State             state;
+        uint32_t          id;
+        int               sub;           // fan-out subscriber id while PLAYING
+        uint8_t           channel;       // interleaved RTP channel
+        bool              udp;           // RTP/RTCP over UDP instead of interleaved
+        sockaddr_in       rtp_addr;
+        sockaddr_in       rtcp_addr;
+        RtpPacer          pacer;
+        uint32_t          last_sr_ms;
+        uint32_t          last_rx_ms;
+        RtspRequestParser parser;
+        uint8_t           in[READ_CHUNK];  // received, not yet fed to the parser
+        size_t            in_len;
+        char              resp[768];
+        size_t            resp_len;
+        size_t            resp_off;
+        bool              close_after;   // TEARDOWN: close once the reply is out
+
+        Session() : active(false), fd(-1), state(INIT), id(0), sub(-1), channel(0),
+                    udp(false), last_sr_ms(0), last_rx_ms(0), in_len(0), resp_len(0), resp_off(0),
+                    close_after(false) {}
+    };
 
-    void begin() { tcpServer.begin(); }
+    // Writes RTP packets interleaved on the session's TCP connection.
+    struct TcpSink {
+        Session& s;
+        explicit TcpSink(Session& session) : s(session) {}
+
+        size_t wireLength(const RtpFrame& f, size_t i) {
+            return RTP_INTERLEAVE_SIZE + f.length(i);
+        }
+
+        int write(const RtpFrame& f, size_t i, size_t off) {
+            if (s.channel == 0) {
+                // Shared buffer already carries '$', channel 0 and the length
+                return sendSome(s.fd, f.prefixed(i) + off, wireLength(f, i) - off);
+            }
+            if (off < RTP_INTERLEAVE_SIZE) {
+                uint8_t hdr[RTP_INTERLEAVE_SIZE];
+                memcpy(hdr, f.prefixed(i), RTP_INTERLEAVE_SIZE);
+                hdr[1] = s.channel;
+                return sendSome(s.fd, hdr + off, RTP_INTERLEAVE_SIZE - off);
+            }
+            off -= RTP_INTERLEAVE_SIZE;
+            return sendSome(s.fd, f.packet(i) + off, f.length(i) - off);
+        }
+    };
+
+    // Sends each RTP packet as one datagram, paced across the frame interval.
+    struct UdpSink {
+        RtspServerLite& srv;
+        Session&        s;
+        UdpSink(RtspServerLite& server, Session& session) : srv(server), s(session) {}
+
+        size_t wireLength(const RtpFrame& f, size_t i) { return f.length(i); }
+
+        int write(const RtpFrame& f, size_t i, size_t) {
+            uint32_t now = micros();
+            if (i == 0) s.pacer.startFrame(now, srv.mFrameIntervalUs, f.count);
+            if (!s.pacer.ready(now)) return 0;
+
+            int n = ::sendto(srv.mRtpFd, f.packet(i), f.length(i), MSG_DONTWAIT,
+                             (const sockaddr*)&s.rtp_addr, sizeof(s.rtp_addr));
+            if (n < 0) {
+                // Full TX queue: retry on the next poll. Datagrams are never partial.
+                return (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOMEM ||
+                        errno == ENOBUFS) ? 0 : -1;
+            }
+            s.pacer.sent(now);
+            return (int)f.length(i);
+        }
+    };
+
+    // >0 bytes written, 0 when the socket buffer is full, -1 on error.
+    static int sendSome(int fd, const uint8_t* data, size_t len) {
+        int n = ::send(fd, data, len, MSG_DONTWAIT);
+        if (n >= 0) return n;
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    static int openUdp(uint16_t port) {
+        int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (::bind(fd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        return fd;
+    }
+
+    // Receiver reports only count as a sign of life: each one refreshes
+    // the UDP session whose client RTCP address it came from.
+    void drainRtcp(uint32_t now) {
+        if (mRtcpFd < 0) return;
+        uint8_t buf[256];
+        for (int i = 0; i < 4; ++i) {
+            sockaddr_in from;
+            socklen_t from_len = sizeof(from);
+            int n = ::recvfrom(mRtcpFd, buf, sizeof(buf), MSG_DONTWAIT, (sockaddr*)&from, &from_len);
+            if (n <= 0) break;
+            if (n < 8 || (buf[0] >> 6) != 2 || buf[1] < 200 || buf[1] > 204) continue;   // not RTCP
+            for (int k = 0; k < MAX_SESSIONS; ++k) {
+                Session& s = mSessions[k];
+                if (s.active && s.udp &&
+                    s.rtcp_addr.sin_addr.s_addr == from.sin_addr.s_addr &&
+                    s.rtcp_addr.sin_port == from.sin_port) {
+                    s.last_rx_ms = now;
+                }
+            }
+        }
+    }
+
+    void maybeSendReport(Session& s, uint32_t now) {
+        if (now - s.last_sr_ms < RTCP_SR_INTERVAL_MS) return;
+
+        const RtpFanout::SubscriberStats& st = mFanout.stats(s.sub);
+        uint8_t  sr[64 + RTP_INTERLEAVE_SIZE];
+        uint8_t* body = sr + RTP_INTERLEAVE_SIZE;
+        uint32_t octets = st.bytes_sent - st.packets_sent * (uint32_t)RTP_HEADER_SIZE;
+        size_t len = rtcp_build_sr(body, sizeof(sr) - RTP_INTERLEAVE_SIZE, mFanout.ssrc(),
+                                   now * (RTP_JPEG_CLOCK_HZ / 1000), st.packets_sent, octets, mName);
+        if (!len) return;
+
+        if (s.udp) {
+            if (mRtpFd < 0) return;
+            // Sent from the RTP socket's sibling port so NATs see server_port+1
+            int fd = mRtcpFd >= 0 ? mRtcpFd : mRtpFd;
+            ::sendto(fd, body, len, MSG_DONTWAIT, (const sockaddr*)&s.rtcp_addr, sizeof(s.rtcp_addr));
+        } else {
+            // Interleaved on channel+1, queued like a reply so a partial write
+            // resumes before any more RTP goes out.
+            if (s.resp_len || mFanout.midPacket(s.sub)) return;
+            sr[0] = '$';
+            sr[1] = (uint8_t)(s.channel + 1);
+            sr[2] = (uint8_t)(len >> 8);
+            sr[3] = (uint8_t)len;
+            memcpy(s.resp, sr, len + RTP_INTERLEAVE_SIZE);
+            s.resp_len = len + RTP_INTERLEAVE_SIZE;
+            s.resp_off = 0;
+            flushResponse(s);
+        }
+        s.last_sr_ms = now;
+    }
 
-    void handleConnections(bool stream_on) {
+    void acceptOne() {
         WiFiClient client = tcpServer.available();
         if (!client) return;
 
-        CamStreamer streamer(width, height);
-        CRtspSession session(&client, &streamer);
+        for (int i = 0; i < MAX_SESSIONS; ++i) {
+            Session& s = mSessions[i];
+            if (s.active) continue;
+            s.active      = true;
+            s.client      = client;
+            s.fd          = client.fd();
+            s.state       = INIT;
+            s.id          = mNextSessionId++ * 2654435761u;
+            s.sub         = -1;
+            s.channel     = 0;
+            s.udp         = false;
+            s.last_sr_ms  = 0;
+            s.last_rx_ms  = millis();
+            s.in_len      = 0;
+            s.resp_len    = 0;
+            s.resp_off    = 0;
+            s.close_after = false;
+            s.parser.reset();
+            s.client.setNoDelay(true);
+            return;
+        }
+        // Table full: refuse rather than starve existing viewers
+        client.stop();
+    }
+
+    void closeSession(Session& s) {
+        if (s.sub >= 0) mFanout.unsubscribe(s.sub);
+        s.sub = -1;
+        s.client.stop();
+        s.fd = -1;
+        s.active = false;
+    }
+
+    // Returns false when the client is gone or misbehaving.
+    bool readAndHandle(Session& s, uint32_t now) {
+        if (s.resp_len) return true;                    // finish the last reply first
 
-        // main RTSP loop
-        while (client.connected() && stream_on) {
-            session.handleRequests(0);
-            streamer.streamImage(millis());
-            yield();
+        if (s.in_len < sizeof(s.in)) {
+            int n = ::recv(s.fd, s.in + s.in_len, sizeof(s.in) - s.in_len, MSG_DONTWAIT);
+            if (n == 0) return false;                   // orderly close
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            if (n > 0) {
+                s.in_len += (size_t)n;
+                s.last_rx_ms = now;
+            }
         }
+
+        size_t off = 0;
+        while (off < s.in_len) {
+            RtspRequestParser::Result r;
+            off += s.parser.feed(s.in + off, s.in_len - off, r);
+            if (r == RtspRequestParser::TOO_LARGE) return false;
+            if (r == RtspRequestParser::REQUEST) {
+                handleRequest(s, s.parser.request());
+                // One reply in flight at a time; pipelined requests stay in
+                // s.in until it has gone out.
+                if (s.resp_len) break;
+            }
+        }
+        if (off) {
+            memmove(s.in, s.in + off, s.in_len - off);
+            s.in_len -= off;
+        }
+        return true;
     }
 
-private:
-    WiFiServer tcpServer;
-    u_short width;
-    u_short height;
+    // Returns false on a write error or after a TEARDOWN reply went out. A
+    // reply doesn't start while an interleaved RTP packet is half written.
+    bool flushResponse(Session& s) {
+        if (s.resp_off == 0 && s.resp_len && !s.udp && mFanout.midPacket(s.sub)) return true;
+        while (s.resp_off < s.resp_len) {
+            int n = sendSome(s.fd, (const uint8_t*)s.resp + s.resp_off, s.resp_len - s.resp_off);
+            if (n < 0) return false;
+            if (n == 0) return true;
+            s.resp_off += (size_t)n;
+        }
+        s.resp_len = s.resp_off = 0;
+        return !s.close_after;
+    }
+
+    void handleRequest(Session& s, const RtspRequest& req) {
+        const char* m = req.method;
+
+        if (strcmp(m, "OPTIONS") == 0) {
+            reply(s, req, 200, "OK",
+                  "Public: OPTIONS, DESCRIBE, SETUP, PLAY, TEARDOWN, GET_PARAMETER\r\n");
+        } else if (strcmp(m, "DESCRIBE") == 0) {
+            handleDescribe(s, req);
+        } else if (strcmp(m, "SETUP") == 0) {
+            handleSetup(s, req);
+        } else if (strcmp(m, "PLAY") == 0) {
+            handlePlay(s, req);
+        } else if (strcmp(m, "TEARDOWN") == 0) {
+            reply(s, req, 200, "OK", "");
+            s.close_after = true;
+        } else if (strcmp(m, "GET_PARAMETER") == 0 || strcmp(m, "SET_PARAMETER") == 0) {
+            reply(s, req, 200, "OK", "");               // keep-alive
+        } else {
+            reply(s, req, 405, "Method Not Allowed", "");
+        }
+        flushResponse(s);
+    }
+
+    void handleDescribe(Session& s, const RtspRequest& req) {
+        IPAddress ip = s.client.localIP();
+        char sdp[256];
+        int sdp_len = snprintf(sdp, sizeof(sdp),
+            "v=0\r\n"
+            "o=- %u 1 IN IP4 %u.%u.%u.%u\r\n"
+            "s=%s\r\n"
+            "c=IN IP4 0.0.0.0\r\n"
+            "t=0 0\r\n"
+            "m=video 0 RTP/AVP %u\r\n"
+            "a=control:track1\r\n",
+            (unsigned)s.id, ip[0], ip[1], ip[2], ip[3], mName, RTP_PAYLOAD_JPEG);
+
+        size_t url_len = strlen(req.url);
+        const char* slash = (url_len && req.url[url_len - 1] == '/') ? "" : "/";
+        char hdrs[320];
+        snprintf(hdrs, sizeof(hdrs),
+                 "Content-Base: %s%s\r\n"
+                 "Content-Type: application/sdp\r\n"
+                 "Content-Length: %d\r\n",
+                 req.url, slash, sdp_len);
+        reply(s, req, 200, "OK", hdrs, sdp);
+    }
+
+    void handleSetup(Session& s, const RtspRequest& req) {
+        if (strstr(req.transport, "RTP/AVP/TCP")) {
+            setupInterleaved(s, req);
+        } else {
+            setupUdp(s, req);
+        }
+    }
+
+    void setupInterleaved(Session& s, const RtspRequest& req) {
+        const char* il = strstr(req.transport, "interleaved=");
+        int rtp_ch = il ? atoi(il + strlen("interleaved=")) : 0;
+        if (rtp_ch < 0 || rtp_ch > 254) rtp_ch = 0;
+        s.channel = (uint8_t)rtp_ch;
+        s.udp = false;
+        s.state = READY;
+
+        char hdrs[160];
+        snprintf(hdrs, sizeof(hdrs),
+                 "Transport: RTP/AVP/TCP;unicast;interleaved=%d-%d\r\n"
+                 "Session: %08X;timeout=%u\r\n",
+                 rtp_ch, rtp_ch + 1, (unsigned)s.id, timeoutSeconds());
+        reply(s, req, 200, "OK", hdrs);
+    }
+
+    // RTP/AVP[/UDP];unicast;client_port=a-b
+    void setupUdp(Session& s, const RtspRequest& req) {
+        const char* cp = strstr(req.transport, "client_port=");
+        if (mRtpFd < 0 || !cp || strstr(req.transport, "multicast")) {
+            reply(s, req, 461, "Unsupported Transport", "");
+            return;
+        }
+        cp += strlen("client_port=");
+        int rtp_port = atoi(cp);
+        const char* dash = (const char*)memchr(cp, '-', strcspn(cp, ";"));
+        int rtcp_port = dash ? atoi(dash + 1) : rtp_port + 1;
+        if (rtp_port <= 0 || rtp_port > 65535 || rtcp_port <= 0 || rtcp_port > 65535) {
+            reply(s, req, 461, "Unsupported Transport", "");
+            return;
+        }
+
+        // Media goes to the address the RTSP connection came from
+        sockaddr_in peer;
+        socklen_t peer_len = sizeof(peer);
+        if (::getpeername(s.fd, (sockaddr*)&peer, &peer_len) < 0) {
+            reply(s, req, 500, "Internal Server Error", "");
+            return;
+        }
+        s.rtp_addr = peer;
+        s.rtp_addr.sin_port = htons((uint16_t)rtp_port);
+        s.rtcp_addr = peer;
+        s.rtcp_addr.sin_port = htons((uint16_t)rtcp_port);
+        s.udp = true;
+        s.state = READY;
+
+        char hdrs[200];
+        snprintf(hdrs, sizeof(hdrs),
+                 "Transport: RTP/AVP;unicast;client_port=%d-%d;server_port=%u-%u;ssrc=%08X\r\n"
+                 "Session: %08X;timeout=%u\r\n",
+                 rtp_port, rtcp_port, (unsigned)mRtpPort, (unsigned)(mRtpPort + 1),
+                 (unsigned)mFanout.ssrc(), (unsigned)s.id, timeoutSeconds());
+        reply(s, req, 200, "OK", hdrs);
+    }
+
+    // Advertised in SETUP replies: what poll() enforces, rounded down so
+    // clients send their keep-alives in time.
+    unsigned timeoutSeconds() const {
+        return mSessionTimeoutMs >= 2000 ? (unsigned)(mSessionTimeoutMs / 1000) : 1u;
+    }
+
+    void handlePlay(Session& s, const RtspRequest& req) {
+        if (s.state == INIT) {
+            reply(s, req, 455, "Method Not Valid in This State", "");
+            return;
+        }
+        if (s.sub < 0) {
+            s.sub = mFanout.subscribe();
+            if (s.sub < 0) {
+                reply(s, req, 453, "Not Enough Bandwidth", "");
+                return;
+            }
+        }
+        s.state = PLAYING;
+
+        char hdrs[96];
+        snprintf(hdrs, sizeof(hdrs),
+                 "Session: %08X\r\n"
+                 "Range: npt=0.000-\r\n",
+                 (unsigned)s.id);
+        reply(s, req, 200, "OK", hdrs);
+    }
+
+    void reply(Session& s, const RtspRequest& req, int code, const char* reason,
+               const char* headers, const char* body = "") {
+        int n = snprintf(s.resp, sizeof(s.resp),
+                         "RTSP/1.0 %d %s\r\n"
+                         "CSeq: %d\r\n"
+                         "%s"
+                         "\r\n"
+                         "%s",
+                         code, reason, req.cseq, headers, body);
+        if (n < 0) n = 0;
+        if ((size_t)n >= sizeof(s.resp)) n = sizeof(s.resp) - 1;
+        s.resp_len = (size_t)n;
+        s.resp_off = 0;
+    }
+
+    WiFiServer  tcpServer;
+    const char* mName;
+    RtpFanout   mFanout;
+    Session     mSessions[MAX_SESSIONS];
+    uint32_t    mNextSessionId;
+    uint16_t    mRtpPort;
+    int         mRtpFd;
+    int         mRtcpFd;
+    uint32_t    mLastFrameMs;
+    uint32_t    mFrameIntervalUs;
+    uint32_t    mSessionTimeoutMs;
 };
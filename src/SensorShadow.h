@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Batches OV2640 camera parameters into register writes.
+ *
+ * Most camera parameters are a few bits in one to three sensor registers.
+ * esp32-camera's driver writes each one from its own setter, often as a
+ * read-modify-write, so applying ten of them is dozens of SCCB
+ * transactions. The same register is rewritten several times: REG04, for
+ * example, holds mirror, flip and the low exposure bits. The image
+ * glitches for as long as that takes.
+ *
+ * add() merges a parameter's register bits at its old and new value into
+ * a per-register shadow. flush() then writes each register whose bits
+ * actually change exactly once, grouped by bank, so the bank-select
+ * register is switched at most once per bank. Register bits that belong
+ * to no added parameter are left alone (masked writes).
+ *
+ * The "old" side comes from the parameter values the driver reports, not
+ * from state kept across batches, so writes made in between (by the
+ * driver, by ABR) can't make it stale.
+ *
+ * Parameters that aren't plain register bits stay with the driver's
+ * setters: brightness, contrast and saturation go through the indirect SDE
+ * registers, and framesize reprograms the whole sensor.
+ *
+ * Flush goes through a Bus:
+ *   int write(uint8_t bank, uint8_t reg, uint8_t mask, uint8_t value);  // 0 = ok
+ * On the device that is sensor_t::set_reg. On the host it is a fake SCCB
+ * bus that counts transactions (src/bench/sensor_shadow_bench.cpp).
+ */
+enum Ov2640Param : uint8_t {
+    OV2640_AE_LEVEL,        // -2..2
+    OV2640_AGC_GAIN,        // 0..30
+    OV2640_AEC_VALUE,       // 0..1200
+    OV2640_AEC2,            // 0/1
+    OV2640_AWB,             // 0/1
+    OV2640_AWB_GAIN,        // 0/1
+    OV2640_HMIRROR,         // 0/1
+    OV2640_VFLIP,           // 0/1
+    OV2640_QUALITY,         // JPEG quality scale
+    OV2640_GAINCEILING,     // 0..6 (2x..128x)
+    OV2640_PARAM_COUNT
+};
+
+class SensorShadow {
+public:
+    static const uint8_t BANK_DSP    = 0;
+    static const uint8_t BANK_SENSOR = 1;
+    static const size_t  MAX_REGS    = 16;   // every register of every parameter fits
+    static const size_t  MAX_FIELDS  = 3;    // per parameter
+
+    // Bits of one register
+    struct Field {
+        uint8_t bank;
+        uint8_t reg;
+        uint8_t mask;
+        uint8_t value;
+    };
+
+    SensorShadow() : mCount(0) {}
+
+    void clear() { mCount = 0; }
+
+    // Parameter p goes from value `from` to `to` (both in range). False if
+    // p is unknown or the shadow is full; nothing is added then.
+    bool add(Ov2640Param p, int from, int to) {
+        Field f_old[MAX_FIELDS], f_new[MAX_FIELDS];
+        size_t n = fields(p, from, f_old);
+        if (!n || fields(p, to, f_new) != n) return false;
+        size_t missing = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (!find(f_old[i].bank, f_old[i].reg)) missing++;
+        }
+        if (mCount + missing > MAX_REGS) return false;
+        for (size_t i = 0; i < n; ++i) {
+            Reg* r = find(f_old[i].bank, f_old[i].reg);
+            if (!r) {
+                r = &mRegs[mCount++];
+                r->bank = f_old[i].bank;
+                r->reg  = f_old[i].reg;
+                r->mask = r->from = r->to = 0;
+            }
+            uint8_t m = f_old[i].mask;
+            r->mask |= m;
+            r->from = (uint8_t)((r->from & ~m) | (f_old[i].value & m));
+            r->to   = (uint8_t)((r->to & ~m) | (f_new[i].value & m));
+        }
+        return true;
+    }
+
+    // Registers that flush() would write
+    size_t pending() const {
+        size_t n = 0;
+        for (size_t i = 0; i < mCount; ++i) {
+            if (mRegs[i].from != mRegs[i].to) n++;
+        }
+        return n;
+    }
+
+    // Writes the changed registers, DSP bank first, each once. Returns how
+    // many were written, or -1 if a write failed (the rest are skipped and
+    // the shadow is kept; the caller falls back to the driver's setters).
+    template <class Bus>
+    int flush(Bus& bus) {
+        int written = 0;
+        for (uint8_t bank = BANK_DSP; bank <= BANK_SENSOR; ++bank) {
+            for (size_t i = 0; i < mCount; ++i) {
+                const Reg& r = mRegs[i];
+                if (r.bank != bank || r.from == r.to) continue;
+                if (bus.write(r.bank, r.reg, r.mask, r.to) != 0) return -1;
+                written++;
+            }
+        }
+        mCount = 0;
+        return written;
+    }
+
+    // Register bits for parameter p at value v, following esp32-camera's
+    // ov2640 setters. Returns the number of fields (0 for an unknown p).
+    static size_t fields(Ov2640Param p, int v, Field* out) {
+        switch (p) {
+            case OV2640_AE_LEVEL: {
+                // AEW, AEB, VV: stable-operating-region limits per level
+                static const uint8_t levels[5][3] = {
+                    { 0x20, 0x18, 0x60 },
+                    { 0x34, 0x1C, 0x00 },
+                    { 0x3E, 0x38, 0x81 },
+                    { 0x48, 0x40, 0x81 },
+                    { 0x58, 0x50, 0x92 },
+                };
+                int l = clamp(v, -2, 2) + 2;
+                out[0] = field(BANK_SENSOR, 0x24, 0xFF, levels[l][0]);
+                out[1] = field(BANK_SENSOR, 0x25, 0xFF, levels[l][1]);
+                out[2] = field(BANK_SENSOR, 0x26, 0xFF, levels[l][2]);
+                return 3;
+            }
+            case OV2640_AGC_GAIN: {
+                static const uint8_t gains[31] = {
+                    0x00, 0x10, 0x18, 0x30, 0x34, 0x38, 0x3C, 0x70, 0x72, 0x74, 0x76,
+                    0x78, 0x7A, 0x7C, 0x7E, 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6,
+                    0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
+                };
+                out[0] = field(BANK_SENSOR, 0x00, 0xFF, gains[clamp(v, 0, 30)]);   // GAIN
+                return 1;
+            }
+            case OV2640_AEC_VALUE:
+                v = clamp(v, 0, 1200);
+                out[0] = field(BANK_SENSOR, 0x04, 0x03, (uint8_t)(v & 0x03));          // REG04 AEC[1:0]
+                out[1] = field(BANK_SENSOR, 0x10, 0xFF, (uint8_t)((v >> 2) & 0xFF));   // AEC AEC[9:2]
+                out[2] = field(BANK_SENSOR, 0x45, 0xFF, (uint8_t)((v >> 10) & 0x3F));  // REG45 AEC[15:10]
+                return 3;
+            case OV2640_AEC2:
+                out[0] = field(BANK_DSP, 0xC2, 0x80, v ? 0x80 : 0);      // CTRL0 AEC_EN
+                return 1;
+            case OV2640_AWB:
+                out[0] = field(BANK_DSP, 0xC3, 0x08, v ? 0x08 : 0);      // CTRL1 AWB
+                return 1;
+            case OV2640_AWB_GAIN:
+                out[0] = field(BANK_DSP, 0xC3, 0x04, v ? 0x04 : 0);      // CTRL1 AWB_GAIN
+                return 1;
+            case OV2640_HMIRROR:
+                out[0] = field(BANK_SENSOR, 0x04, 0x80, v ? 0x80 : 0);   // REG04 HFLIP_IMG
+                return 1;
+            case OV2640_VFLIP:
+                out[0] = field(BANK_SENSOR, 0x04, 0x50, v ? 0x50 : 0);   // REG04 VFLIP_IMG | VREF_EN
+                return 1;
+            case OV2640_QUALITY:
+                out[0] = field(BANK_DSP, 0x44, 0xFF, (uint8_t)clamp(v, 0, 255));   // QS
+                return 1;
+            case OV2640_GAINCEILING:
+                out[0] = field(BANK_SENSOR, 0x14, 0xE0, (uint8_t)(clamp(v, 0, 6) << 5));   // COM9 AGC ceiling
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+private:
+    struct Reg {
+        uint8_t bank;
+        uint8_t reg;
+        uint8_t mask;   // bits owned by the added parameters
+        uint8_t from;   // current value of those bits
+        uint8_t to;     // after the batch
+    };
+
+    static Field field(uint8_t bank, uint8_t reg, uint8_t mask, uint8_t value) {
+        Field f = { bank, reg, mask, value };
+        return f;
+    }
+
+    static int clamp(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+    Reg* find(uint8_t bank, uint8_t reg) {
+        for (size_t i = 0; i < mCount; ++i) {
+            if (mRegs[i].bank == bank && mRegs[i].reg == reg) return &mRegs[i];
+        }
+        return nullptr;
+    }
+
+    Reg    mRegs[MAX_REGS];
+    size_t mCount;
+};
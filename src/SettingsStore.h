@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * RAM copy of N integer settings with deferred, batched persistence.
+ *
+ * set() only updates the copy and marks the setting dirty if the value
+ * differs from what was last written (or loaded); setting it back before
+ * the flush clears the mark again. flush() writes the dirty settings in one
+ * transaction once nothing has changed for DEBOUNCE_MS, or at the latest
+ * MAX_DELAY_MS after the first unsaved change, so dragging a slider costs
+ * one write of one key instead of one per step.
+ *
+ * Storage is a template argument to flush(): a Writer with
+ *   bool begin(); bool write(size_t index, int32_t value); bool commit(); void end();
+ * Not thread-safe: one owning task.
+ */
+template <size_t N>
+class SettingsStore {
+public:
+    static const uint32_t DEBOUNCE_MS  = 1500;
+    static const uint32_t MAX_DELAY_MS = 10000;
+
+    struct Stats {
+        uint32_t sets;        // set() calls
+        uint32_t unchanged;   // ... that left nothing to write
+        uint32_t writes;      // keys written
+        uint32_t commits;
+        uint32_t failures;
+    };
+
+    SettingsStore() : mKnown(0), mDirty(0), mFirstMs(0), mLastMs(0) {
+        static_assert(N <= 32, "dirty bits are one uint32_t");
+        for (size_t i = 0; i < N; ++i) mValue[i] = mStored[i] = 0;
+        mStats.sets = mStats.unchanged = mStats.writes = mStats.commits = mStats.failures = 0;
+    }
+
+    // Value found in storage at boot: known, nothing to write.
+    void load(size_t i, int32_t v) {
+        if (i >= N) return;
+        mValue[i] = mStored[i] = v;
+        mKnown |= bit(i);
+        mDirty &= ~bit(i);
+    }
+
+    void set(size_t i, int32_t v, uint32_t now_ms) {
+        if (i >= N) return;
+        mStats.sets++;
+        mValue[i] = v;
+        if ((mKnown & bit(i)) && mStored[i] == v) {
+            mDirty &= ~bit(i);
+            mStats.unchanged++;
+            return;
+        }
+        if (!mDirty) mFirstMs = now_ms;
+        mDirty |= bit(i);
+        mLastMs = now_ms;
+    }
+
+    int32_t get(size_t i) const { return i < N ? mValue[i] : 0; }
+
+    // Number of settings waiting to be written.
+    unsigned pending() const {
+        unsigned n = 0;
+        for (uint32_t d = mDirty; d; d &= d - 1) n++;
+        return n;
+    }
+
+    bool due(uint32_t now_ms) const {
+        return mDirty && (now_ms - mLastMs >= DEBOUNCE_MS || now_ms - mFirstMs >= MAX_DELAY_MS);
+    }
+
+    // Writes the dirty settings if due (or now, with force). Returns the
+    // number of keys written; on failure they stay dirty and are retried
+    // after another DEBOUNCE_MS.
+    template <class Writer>
+    unsigned flush(Writer& w, uint32_t now_ms, bool force = false) {
+        if (!mDirty || (!force && !due(now_ms))) return 0;
+        unsigned n = 0;
+        bool opened = w.begin();
+        bool ok = opened;
+        for (size_t i = 0; ok && i < N; ++i) {
+            if (!(mDirty & bit(i))) continue;
+            ok = w.write(i, mValue[i]);
+            n++;
+        }
+        if (ok) ok = w.commit();
+        if (opened) w.end();
+        if (!ok) {
+            mStats.failures++;
+            mFirstMs = mLastMs = now_ms;
+            return 0;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            if (mDirty & bit(i)) mStored[i] = mValue[i];
+        }
+        mKnown |= mDirty;
+        mDirty = 0;
+        mStats.writes += n;
+        mStats.commits++;
+        return n;
+    }
+
+    const Stats& stats() const { return mStats; }
+
+private:
+    static uint32_t bit(size_t i) { return 1UL << i; }
+
+    int32_t  mValue[N];
+    int32_t  mStored[N];
+    uint32_t mKnown;
+    uint32_t mDirty;
+    uint32_t mFirstMs;
+    uint32_t mLastMs;
+    Stats    mStats;
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <esp32-hal-psram.h>
+#endif
+
+/**
+ * Most recent snapshot JPEG, copied out of the capture ring.
+ *
+ * Holding a private copy means a slow HTTP client never pins a camera frame
+ * buffer, and polling clients inside the max-age window are answered without
+ * touching the capture pipeline at all. The frame sequence number doubles as
+ * the ETag.
+ *
+ * Responses are sent straight from the cache: pin() the current copy for the
+ * length of a download and unpin() it afterwards. A refresh goes to a second
+ * buffer while the current one is pinned (and is skipped if both are), so a
+ * download never sees its bytes change. Buffers only grow (in PSRAM when
+ * present) and the second one is allocated on first use, so steady-state
+ * refreshes don't allocate.
+ *
+ * Not thread-safe: use from the web server task only.
+ */
+class SnapshotCache {
+public:
+    SnapshotCache()
+        : mCur(0), mLen(0), mSeq(0), mStampMs(0), mHits(0), mMisses(0), mNotModified(0)
+    {
+        memset(mBufs, 0, sizeof(mBufs));
+    }
+
+    ~SnapshotCache() {
+        for (int i = 0; i < 2; ++i) free(mBufs[i].data);
+    }
+
+    SnapshotCache(const SnapshotCache&) = delete;
+    SnapshotCache& operator=(const SnapshotCache&) = delete;
+
+    // True when a frame is cached and no older than max_age_ms.
+    bool fresh(uint32_t now_ms, uint32_t max_age_ms) const {
+        return mLen && now_ms - mStampMs <= max_age_ms;
+    }
+
+    // Replace the cached frame. Returns false (and keeps the old one) if
+    // both buffers are pinned or the free one can't grow to fit.
+    bool store(const uint8_t* jpeg, size_t len, uint32_t seq, uint32_t stamp_ms) {
+        int target = mBufs[mCur].pins == 0 ? mCur : 1 - mCur;
+        Buffer& b = mBufs[target];
+        if (b.pins) return false;
+        if (len > b.cap) {
+            void* grown = alloc(len);
+            if (!grown) return false;
+            free(b.data);
+            b.data = (uint8_t*)grown;
+            b.cap = len;
+        }
+        memcpy(b.data, jpeg, len);
+        mCur = target;
+        mLen = len;
+        mSeq = seq;
+        mStampMs = stamp_ms;
+        return true;
+    }
+
+    // Quoted ETag for the cached frame, e.g. "\"f-1234\""
+    void etag(char* out, size_t out_len) const {
+        snprintf(out, out_len, "\"f-%lu\"", (unsigned long)mSeq);
+    }
+
+    // True when an If-None-Match header names the cached frame.
+    bool matches(const char* if_none_match) const {
+        if (!mLen || !if_none_match || !*if_none_match) return false;
+        if (strcmp(if_none_match, "*") == 0) return true;
+        char tag[24];
+        etag(tag, sizeof(tag));
+        return strstr(if_none_match, tag) != nullptr;
+    }
+
+    // Keep the current copy unchanged until unpin(data).
+    const uint8_t* pin() {
+        mBufs[mCur].pins++;
+        return mBufs[mCur].data;
+    }
+
+    void unpin(const uint8_t* data) {
+        for (int i = 0; i < 2; ++i) {
+            if (mBufs[i].data == data && mBufs[i].pins) {
+                mBufs[i].pins--;
+                return;
+            }
+        }
+    }
+
+    const uint8_t* data()    const { return mBufs[mCur].data; }
+    size_t         length()  const { return mLen; }
+    uint32_t       seq()     const { return mSeq; }
+    uint32_t       stampMs() const { return mStampMs; }
+
+    void countHit()         { mHits++; }
+    void countMiss()        { mMisses++; }
+    void countNotModified() { mNotModified++; }
+
+    uint32_t hits()        const { return mHits; }
+    uint32_t misses()      const { return mMisses; }
+    uint32_t notModified() const { return mNotModified; }
+
+private:
+    static void* alloc(size_t n) {
+#if defined(ARDUINO)
+        return psramFound() ? ps_malloc(n) : malloc(n);
+#else
+        return malloc(n);
+#endif
+    }
+
+    struct Buffer {
+        uint8_t* data;
+        size_t   cap;
+        uint16_t pins;
+    };
+
+    Buffer   mBufs[2];
+    int      mCur;
+    size_t   mLen;
+    uint32_t mSeq;
+    uint32_t mStampMs;
+    uint32_t mHits;
+    uint32_t mMisses;
+    uint32_t mNotModified;
+};
@@ -0,0 +1,372 @@
+/*
+ * RTP/JPEG packetization benchmark (PlatformIO env:native_bench).
+ *
+ * Feeds every JPEG in a directory through the firmware's packetizer and
+ * fan-out and prints one JSON object per file and stage, plus a summary
+ * line, so results can be diffed across firmware versions:
+ *
+ *   pio run -e native_bench
+ *   .pio/build/native_bench/program --corpus <dir> [--label v1.2] [--min-ms 200]
+ *       [--subscribers 2] [--verify] > bench.jsonl
+ *
+ * Stages:
+ *   scan       JpegScanner::scan() with a fixed header key (cached layout)
+ *   packetize  RtpJpegPacketizer::packetize() + release
+ *   fanout     RtpFanout::publish() to N subscribers and drain() of every
+ *              packet into a sink that accepts everything
+ *
+ * Per frame: wall time (ns), RTP packets, JPEG bytes copied into packet
+ * buffers (scan data + quant tables), and heap allocations/bytes counted by
+ * interposing malloc (glibc).
+ *
+ * --verify checks jpeg_parse() and JpegScanner against a straightforward
+ * reference parser on every file, as-is and with trailing padding, a missing
+ * EOI, and stale cache entries (other quant tables, other frame size); prints one JSON line per file and exits
+ * non-zero on any mismatch instead of benchmarking.
+ */
+
+#include "JpegScanner.h"
+#include "RtpFanout.h"
+#include "RtpJpeg.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// ---- Allocation counting ----
+extern "C" void* __libc_malloc(size_t n);
+
+static size_t bench_allocs      = 0;
+static size_t bench_alloc_bytes = 0;
+
+extern "C" void* malloc(size_t n) {
+    bench_allocs++;
+    bench_alloc_bytes += n;
+    return __libc_malloc(n);
+}
+
+// ---- Corpus ----
+struct CorpusFile {
+    std::string          name;
+    std::vector<uint8_t> data;
+    JpegInfo             info;
+};
+
+static bool load_corpus(const char* dir, std::vector<CorpusFile>& out) {
+    DIR* d = opendir(dir);
+    if (!d) {
+        perror(dir);
+        return false;
+    }
+    std::vector<std::string> names;
+    while (dirent* e = readdir(d)) {
+        std::string n = e->d_name;
+        size_t dot = n.rfind('.');
+        if (dot == std::string::npos) continue;
+        std::string ext = n.substr(dot + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == "jpg" || ext == "jpeg") names.push_back(n);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        CorpusFile f;
+        f.name = names[i];
+        std::string path = std::string(dir) + "/" + names[i];
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp) continue;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) f.data.insert(f.data.end(), chunk, chunk + n);
+        fclose(fp);
+        if (!jpeg_parse(f.data.data(), f.data.size(), f.info)) {
+            fprintf(stderr, "skipping %s: not an RFC 2435 baseline JPEG\n", f.name.c_str());
+            continue;
+        }
+        out.push_back(f);
+    }
+    return !out.empty();
+}
+
+// ---- Reference parser ----
+// Byte-at-a-time marker walk with a backward EOI search, kept deliberately
+// simple as the oracle for --verify.
+static bool reference_parse(const uint8_t* buf, size_t len, JpegInfo& out) {
+    memset(&out, 0, sizeof(out));
+    if (len < 4 || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+    bool have_sof = false;
+    size_t i = 2;
+    while (i + 4 <= len) {
+        if (buf[i] != 0xFF) return false;
+        uint8_t marker = buf[i + 1];
+        if (marker == 0xFF) { ++i; continue; }
+        if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7)) { i += 2; continue; }
+        size_t seg_len = (size_t)buf[i + 2] << 8 | buf[i + 3];
+        const uint8_t* seg = buf + i + 4;
+        if (seg_len < 2 || i + 2 + seg_len > len) return false;
+        size_t body = seg_len - 2;
+        if (marker == 0xDB) {
+            for (size_t off = 0; off < body; off += 65) {
+                uint8_t tq = seg[off] & 0x0F;
+                if ((seg[off] >> 4) != 0 || tq > 1 || off + 65 > body) return false;
+                out.qtables[tq] = seg + off + 1;
+                if (tq + 1 > out.qtable_count) out.qtable_count = tq + 1;
+            }
+        } else if (marker == 0xC0 || marker == 0xC1) {
+            if (body < 15 || seg[5] != 3) return false;
+            out.height = (uint16_t)(seg[1] << 8 | seg[2]);
+            out.width  = (uint16_t)(seg[3] << 8 | seg[4]);
+            if (seg[7] == 0x21)      out.type = 0;
+            else if (seg[7] == 0x22) out.type = 1;
+            else return false;
+            have_sof = true;
+        } else if (marker == 0xC2) {
+            return false;
+        } else if (marker == 0xDD) {
+            if (body < 2) return false;
+            out.restart_interval = (uint16_t)(seg[0] << 8 | seg[1]);
+        } else if (marker == 0xDA) {
+            if (!have_sof || out.qtable_count == 0) return false;
+            size_t start = i + 2 + seg_len;
+            size_t end = len;
+            for (size_t j = len; j >= start + 2; --j) {
+                if (buf[j - 2] == 0xFF && buf[j - 1] == 0xD9) { end = j - 2; break; }
+            }
+            out.scan = buf + start;
+            out.scan_len = end - start;
+            if (out.restart_interval) out.type |= 64;
+            return true;
+        }
+        i += 2 + seg_len;
+    }
+    return false;
+}
+
+// Same result, comparing table contents since cached tables live elsewhere.
+static bool same_info(const uint8_t* buf, const JpegInfo& a, const JpegInfo& b) {
+    if (a.width != b.width || a.height != b.height || a.type != b.type ||
+        a.restart_interval != b.restart_interval || a.qtable_count != b.qtable_count ||
+        a.scan - buf != b.scan - buf || a.scan_len != b.scan_len) return false;
+    for (int t = 0; t < 2; ++t) {
+        if (!a.qtables[t] != !b.qtables[t]) return false;
+        if (a.qtables[t] && memcmp(a.qtables[t], b.qtables[t], 64) != 0) return false;
+    }
+    return true;
+}
+
+// Checks one buffer through jpeg_parse() and the scanner under `key`.
+// Returns the number of mismatches.
+static int verify_one(const std::vector<uint8_t>& data, JpegScanner& scanner, uint16_t key) {
+    const uint8_t* buf = data.data();
+    JpegInfo ref, got;
+    bool ok_ref = reference_parse(buf, data.size(), ref);
+    int bad = 0;
+    bool ok = jpeg_parse(buf, data.size(), got);
+    if (ok != ok_ref || (ok && !same_info(buf, ref, got))) bad++;
+    ok = scanner.scan(buf, data.size(), got, key);
+    if (ok != ok_ref || (ok && !same_info(buf, ref, got))) bad++;
+    return bad;
+}
+
+static int verify(const char* label, const std::vector<CorpusFile>& files) {
+    const uint16_t key = JpegScanner::key(12, 0);   // one key for the corpus: every file change is "stale"
+    JpegScanner scanner;
+    int total = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const std::vector<uint8_t>& data = files[i].data;
+        int bad = 0, cases = 0;
+
+        bad += verify_one(data, scanner, key); cases++;          // miss (or stale)
+        bad += verify_one(data, scanner, key); cases++;          // hit
+
+        std::vector<uint8_t> padded(data);
+        padded.insert(padded.end(), 61, 0);                      // zero padding after EOI
+        bad += verify_one(padded, scanner, key); cases++;
+
+        std::vector<uint8_t> fill(data);
+        fill.insert(fill.end(), 7, 0xFF);                        // fill bytes after EOI
+        bad += verify_one(fill, scanner, key); cases++;
+
+        std::vector<uint8_t> cut(data.begin(), data.end() - 2);  // no EOI
+        bad += verify_one(cut, scanner, key); cases++;
+
+        std::vector<uint8_t> requant(data);                      // same layout, other tables
+        JpegInfo fi;
+        reference_parse(data.data(), data.size(), fi);
+        for (int t = 0; t < 2; ++t) {
+            if (fi.qtables[t]) requant[fi.qtables[t] - data.data() + 5] ^= 0x01;
+        }
+        bad += verify_one(requant, scanner, key); cases++;
+
+        std::vector<uint8_t> resized(data);                      // same layout, other frame size
+        size_t sof = 2;
+        while (sof + 9 < resized.size() && !(resized[sof] == 0xFF && (resized[sof + 1] == 0xC0 ||
+                                                                      resized[sof + 1] == 0xC1))) {
+            sof += 2 + jpeg_be16(&resized[sof + 2]);
+        }
+        if (sof + 9 < resized.size()) {
+            resized[sof + 5] ^= 0x01;                            // height
+            resized[sof + 8] ^= 0x08;                            // width, still a multiple of 8
+            bad += verify_one(data, scanner, key); cases++;      // back to the original layout
+            bad += verify_one(resized, scanner, key); cases++;
+        }
+
+        printf("{\"label\":\"%s\",\"verify\":true,\"file\":\"%s\",\"cases\":%d,\"mismatches\":%d}\n",
+               label, files[i].name.c_str(), cases, bad);
+        total += bad;
+    }
+    printf("{\"label\":\"%s\",\"summary\":true,\"verify\":true,\"files\":%zu,\"mismatches\":%d,"
+           "\"scanner_hits\":%u,\"scanner_misses\":%u,\"scanner_stale\":%u}\n",
+           label, files.size(), total, scanner.hits(), scanner.misses(), scanner.stale());
+    return total ? 1 : 0;
+}
+
+// ---- Stages ----
+struct NullSink {
+    size_t bytes;
+    NullSink() : bytes(0) {}
+    size_t wireLength(const RtpFrame& f, size_t i) { return RTP_INTERLEAVE_SIZE + f.length(i); }
+    int write(const RtpFrame& f, size_t i, size_t off) {
+        size_t n = wireLength(f, i) - off;
+        bytes += n;
+        return (int)n;
+    }
+};
+
+struct Result {
+    uint64_t iterations;
+    double   ns_per_frame;
+    double   packets_per_frame;
+    double   allocs_per_frame;
+    double   alloc_bytes_per_frame;
+};
+
+typedef uint64_t (*StageFn)(const CorpusFile& f, void* ctx);   // returns packets
+
+static uint64_t stage_scan(const CorpusFile& f, void* ctx) {
+    JpegScanner& s = *(JpegScanner*)ctx;
+    JpegInfo info;
+    s.scan(f.data.data(), f.data.size(), info, JpegScanner::key(12, 0));
+    return 0;
+}
+
+static uint64_t stage_packetize(const CorpusFile& f, void* ctx) {
+    RtpJpegPacketizer& p = *(RtpJpegPacketizer*)ctx;
+    RtpFrame* frame = p.packetize(f.data.data(), f.data.size(), 0);
+    if (!frame) return 0;
+    uint64_t packets = frame->count;
+    frame->refs = 1;
+    RtpFrame::release(frame);
+    return packets;
+}
+
+struct FanoutCtx {
+    RtpFanout* fanout;
+    int        subs[RtpFanout::MAX_SUBSCRIBERS];
+    int        nsubs;
+};
+
+static uint64_t stage_fanout(const CorpusFile& f, void* ctx) {
+    FanoutCtx& c = *(FanoutCtx*)ctx;
+    if (!c.fanout->publish(f.data.data(), f.data.size(), 0)) return 0;
+    uint64_t packets = c.fanout->lastPacketCount();
+    NullSink sink;
+    for (int i = 0; i < c.nsubs; ++i) c.fanout->drain(c.subs[i], sink, (size_t)-1);
+    return packets;
+}
+
+static Result run(const CorpusFile& f, StageFn fn, void* ctx, uint32_t min_ms, uint64_t min_iters) {
+    using namespace std::chrono;
+    for (int i = 0; i < 5; ++i) fn(f, ctx);          // warm up caches and the allocator
+
+    Result r;
+    memset(&r, 0, sizeof(r));
+    uint64_t packets = 0;
+    size_t allocs0 = bench_allocs, bytes0 = bench_alloc_bytes;
+    steady_clock::time_point t0 = steady_clock::now();
+    steady_clock::time_point t1 = t0;
+    while (r.iterations < min_iters || duration_cast<milliseconds>(t1 - t0).count() < min_ms) {
+        packets += fn(f, ctx);
+        r.iterations++;
+        if ((r.iterations & 15) == 0 || r.iterations >= min_iters) t1 = steady_clock::now();
+    }
+    t1 = steady_clock::now();
+    double n = (double)r.iterations;
+    r.ns_per_frame          = (double)duration_cast<nanoseconds>(t1 - t0).count() / n;
+    r.packets_per_frame     = (double)packets / n;
+    r.allocs_per_frame      = (double)(bench_allocs - allocs0) / n;
+    r.alloc_bytes_per_frame = (double)(bench_alloc_bytes - bytes0) / n;
+    return r;
+}
+
+static void print_result(const char* label, const char* stage, const CorpusFile& f, const Result& r) {
+    size_t copied = f.info.scan_len + 64u * f.info.qtable_count;
+    printf("{\"label\":\"%s\",\"stage\":\"%s\",\"file\":\"%s\",\"width\":%u,\"height\":%u,"
+           "\"jpeg_bytes\":%zu,\"iterations\":%llu,\"ns_per_frame\":%.0f,\"packets_per_frame\":%.2f,"
+           "\"bytes_copied_per_frame\":%zu,\"allocs_per_frame\":%.2f,\"alloc_bytes_per_frame\":%.0f}\n",
+           label, stage, f.name.c_str(), f.info.width, f.info.height, f.data.size(),
+           (unsigned long long)r.iterations, r.ns_per_frame, r.packets_per_frame, copied,
+           r.allocs_per_frame, r.alloc_bytes_per_frame);
+}
+
+int main(int argc, char** argv) {
+    const char* corpus = nullptr;
+    const char* label  = "dev";
+    uint32_t    min_ms = 200;
+    int         nsubs  = 2;
+    bool        check  = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--verify")) { check = true; continue; }
+        if (i + 1 >= argc) break;
+        if      (!strcmp(argv[i], "--corpus"))      corpus = argv[i + 1];
+        else if (!strcmp(argv[i], "--label"))       label  = argv[i + 1];
+        else if (!strcmp(argv[i], "--min-ms"))      min_ms = (uint32_t)atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--subscribers")) nsubs  = atoi(argv[i + 1]);
+        ++i;
+    }
+    if (!corpus) {
+        fprintf(stderr, "usage: %s --corpus <dir> [--label NAME] [--min-ms MS] [--subscribers N] [--verify]\n", argv[0]);
+        return 2;
+    }
+    nsubs = std::max(1, std::min(nsubs, (int)RtpFanout::MAX_SUBSCRIBERS));
+
+    std::vector<CorpusFile> files;
+    if (!load_corpus(corpus, files)) {
+        fprintf(stderr, "no usable JPEGs in %s\n", corpus);
+        return 1;
+    }
+    if (check) return verify(label, files);
+
+    JpegScanner scanner;
+    RtpJpegPacketizer packetizer(0x45535033u);
+    RtpFanout fanout(0x45535033u);
+    FanoutCtx fctx;
+    fctx.fanout = &fanout;
+    fctx.nsubs  = nsubs;
+    for (int i = 0; i < nsubs; ++i) fctx.subs[i] = fanout.subscribe();
+
+    double total_ns[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < files.size(); ++i) {
+        scanner.clear();
+        Result s = run(files[i], stage_scan, &scanner, min_ms, 50);
+        print_result(label, "scan", files[i], s);
+        total_ns[2] += s.ns_per_frame;
+        Result p = run(files[i], stage_packetize, &packetizer, min_ms, 50);
+        print_result(label, "packetize", files[i], p);
+        Result f = run(files[i], stage_fanout, &fctx, min_ms, 50);
+        print_result(label, "fanout", files[i], f);
+        total_ns[0] += p.ns_per_frame;
+        total_ns[1] += f.ns_per_frame;
+    }
+    printf("{\"label\":\"%s\",\"summary\":true,\"files\":%zu,\"subscribers\":%d,"
+           "\"mean_ns_scan\":%.0f,\"mean_ns_packetize\":%.0f,\"mean_ns_fanout\":%.0f}\n",
+           label, files.size(), nsubs, total_ns[2] / files.size(), total_ns[0] / files.size(),
+           total_ns[1] / files.size());
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * OV2640 register batching check (PlatformIO env:native_sccb).
+ *
+ * Applies batches of camera parameters to a fake SCCB bus in two ways:
+ *
+ *   driver    one esp32-camera setter per parameter, modelled write for
+ *             write (write_reg / read-modify-write write_reg_bits, bank
+ *             select skipped when the bank is already selected)
+ *   batched   SensorShadow: changed registers only, once each, grouped by
+ *             bank, through a set_reg-style read-modify-write
+ *
+ * Both start from the same register file. The final register files must
+ * match byte for byte; bank switches, reads and writes are counted as
+ * transactions. Prints one JSON object per case and a summary line, and
+ * exits non-zero on any mismatch:
+ *
+ *   pio run -e native_sccb
+ *   .pio/build/native_sccb/program [--random 2000] [--seed 1]
+ */
+
+#include "SensorShadow.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---- Fake bus ----
+struct FakeSccb {
+    uint8_t  regs[2][256];
+    int      bank;
+    unsigned bank_switches;
+    unsigned reads;
+    unsigned writes;
+
+    void reset_counts() {
+        bank = -1;
+        bank_switches = reads = writes = 0;
+    }
+
+    unsigned transactions() const { return bank_switches + reads + writes; }
+
+    void select(int b) {
+        if (bank == b) return;
+        bank = b;
+        bank_switches++;
+    }
+
+    uint8_t read(int b, uint8_t reg) {
+        select(b);
+        reads++;
+        return regs[b][reg];
+    }
+
+    void write(int b, uint8_t reg, uint8_t v) {
+        select(b);
+        writes++;
+        regs[b][reg] = v;
+    }
+
+    void write_bits(int b, uint8_t reg, uint8_t mask, int enable) {
+        uint8_t v = read(b, reg);
+        write(b, reg, enable ? (v | mask) : (v & ~mask));
+    }
+};
+
+// sensor_t::set_reg on the device
+struct SetRegBus {
+    FakeSccb& sccb;
+    int write(uint8_t bank, uint8_t reg, uint8_t mask, uint8_t value) {
+        uint8_t old = sccb.read(bank, reg);
+        sccb.write(bank, reg, (uint8_t)((old & ~mask) | (value & mask)));
+        return 0;
+    }
+};
+
+// ---- Driver model: what each setter writes ----
+static const int DSP = SensorShadow::BANK_DSP;
+static const int SEN = SensorShadow::BANK_SENSOR;
+
+static void driver_set(FakeSccb& b, int p, int v) {
+    static const uint8_t ae_levels[5][3] = {
+        { 0x20, 0x18, 0x60 }, { 0x34, 0x1C, 0x00 }, { 0x3E, 0x38, 0x81 },
+        { 0x48, 0x40, 0x81 }, { 0x58, 0x50, 0x92 },
+    };
+    static const uint8_t agc_gain[31] = {
+        0x00, 0x10, 0x18, 0x30, 0x34, 0x38, 0x3C, 0x70, 0x72, 0x74, 0x76,
+        0x78, 0x7A, 0x7C, 0x7E, 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6,
+        0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
+    };
+    switch (p) {
+        case OV2640_AE_LEVEL:
+            b.write(SEN, 0x24, ae_levels[v + 2][0]);
+            b.write(SEN, 0x25, ae_levels[v + 2][1]);
+            b.write(SEN, 0x26, ae_levels[v + 2][2]);
+            break;
+        case OV2640_AGC_GAIN:
+            b.write(SEN, 0x00, agc_gain[v]);
+            break;
+        case OV2640_AEC_VALUE: {
+            uint8_t r4 = b.read(SEN, 0x04);
+            b.write(SEN, 0x04, (uint8_t)((r4 & ~0x03) | (v & 0x03)));
+            b.write(SEN, 0x10, (uint8_t)((v >> 2) & 0xFF));
+            b.write(SEN, 0x45, (uint8_t)((v >> 10) & 0x3F));
+            break;
+        }
+        case OV2640_AEC2:        b.write_bits(DSP, 0xC2, 0x80, v); break;
+        case OV2640_AWB:         b.write_bits(DSP, 0xC3, 0x08, v); break;
+        case OV2640_AWB_GAIN:    b.write_bits(DSP, 0xC3, 0x04, v); break;
+        case OV2640_HMIRROR:     b.write_bits(SEN, 0x04, 0x80, v); break;
+        case OV2640_VFLIP:
+            b.write_bits(SEN, 0x04, 0x10, v);
+            b.write_bits(SEN, 0x04, 0x40, v);
+            break;
+        case OV2640_QUALITY:     b.write(DSP, 0x44, (uint8_t)v); break;
+        case OV2640_GAINCEILING: {
+            uint8_t c = b.read(SEN, 0x14);
+            b.write(SEN, 0x14, (uint8_t)((c & ~0xE0) | (v << 5)));
+            break;
+        }
+    }
+}
+
+// ---- Cases ----
+struct Params {
+    int v[OV2640_PARAM_COUNT];
+};
+
+static const int PARAM_MIN[OV2640_PARAM_COUNT] = { -2,  0,    0, 0, 0, 0, 0, 0,  4, 0 };
+static const int PARAM_MAX[OV2640_PARAM_COUNT] = {  2, 30, 1200, 1, 1, 1, 1, 1, 63, 6 };
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int rand_value(int p) {
+    return PARAM_MIN[p] + (int)(rng() % (uint32_t)(PARAM_MAX[p] - PARAM_MIN[p] + 1));
+}
+
+struct Result {
+    unsigned driver_tx;
+    unsigned batched_tx;
+    int      regs_written;
+    bool     match;
+};
+
+// Registers hold junk in the bits no parameter owns, then the driver
+// brings them to `from`. `batch` flags which parameters the request sets.
+static Result run_case(const Params& from, const Params& to, const bool* batch) {
+    static FakeSccb base, driver, batched;
+    for (int b = 0; b < 2; ++b) {
+        for (int r = 0; r < 256; ++r) base.regs[b][r] = (uint8_t)rng();
+    }
+    base.reset_counts();
+    for (int p = 0; p < OV2640_PARAM_COUNT; ++p) driver_set(base, p, from.v[p]);
+
+    driver = base;
+    batched = base;
+    driver.reset_counts();
+    batched.reset_counts();
+
+    // Driver: every requested setter, as /api/set_cam_params used to
+    for (int p = 0; p < OV2640_PARAM_COUNT; ++p) {
+        if (batch[p]) driver_set(driver, p, to.v[p]);
+    }
+
+    SensorShadow shadow;
+    for (int p = 0; p < OV2640_PARAM_COUNT; ++p) {
+        if (batch[p] && from.v[p] != to.v[p]) shadow.add((Ov2640Param)p, from.v[p], to.v[p]);
+    }
+    SetRegBus bus = { batched };
+    Result res;
+    res.regs_written = shadow.flush(bus);
+    res.driver_tx  = driver.transactions();
+    res.batched_tx = batched.transactions();
+    res.match = memcmp(driver.regs, batched.regs, sizeof(driver.regs)) == 0;
+    return res;
+}
+
+static void print_case(const char* name, int params, const Result& r) {
+    printf("{\"case\":\"%s\",\"params\":%d,\"driver_tx\":%u,\"batched_tx\":%u,"
+           "\"regs_written\":%d,\"match\":%s}\n",
+           name, params, r.driver_tx, r.batched_tx, r.regs_written, r.match ? "true" : "false");
+}
+
+int main(int argc, char** argv) {
+    int random_cases = 2000;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--random") && i + 1 < argc) {
+            random_cases = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            rng_state = (uint32_t)strtoul(argv[++i], nullptr, 0);
+            if (!rng_state) rng_state = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--random N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failures = 0;
+    bool all[OV2640_PARAM_COUNT];
+    for (int p = 0; p < OV2640_PARAM_COUNT; ++p) all[p] = true;
+
+    // Settings form: every parameter sent, every one changed
+    Params a = { { 0, 0, 300, 1, 1, 1, 0, 1, 10, 2 } };
+    Params b = { { 2, 12, 801, 0, 0, 0, 1, 0, 14, 4 } };
+    Result r = run_case(a, b, all);
+    print_case("form_all_changed", OV2640_PARAM_COUNT, r);
+    failures += !r.match;
+
+    // Settings form resent with one change (the common case)
+    Params c = a;
+    c.v[OV2640_AE_LEVEL] = 1;
+    r = run_case(a, c, all);
+    print_case("form_one_changed", OV2640_PARAM_COUNT, r);
+    failures += !r.match;
+
+    // Form resent unchanged
+    r = run_case(a, a, all);
+    print_case("form_unchanged", OV2640_PARAM_COUNT, r);
+    failures += !r.match;
+
+    // Orientation: both flips and exposure share REG04
+    bool orient[OV2640_PARAM_COUNT] = { false };
+    orient[OV2640_HMIRROR] = orient[OV2640_VFLIP] = orient[OV2640_AEC_VALUE] = true;
+    r = run_case(a, b, orient);
+    print_case("reg04_shared", 3, r);
+    failures += !r.match;
+
+    // Random states and batches
+    unsigned long driver_tx = 0, batched_tx = 0;
+    int random_failures = 0;
+    for (int i = 0; i < random_cases; ++i) {
+        Params from, to;
+        bool batch[OV2640_PARAM_COUNT];
+        for (int p = 0; p < OV2640_PARAM_COUNT; ++p) {
+            from.v[p] = rand_value(p);
+            to.v[p] = (rng() & 1) ? rand_value(p) : from.v[p];
+            batch[p] = (rng() % 3) != 0;
+        }
+        r = run_case(from, to, batch);
+        driver_tx += r.driver_tx;
+        batched_tx += r.batched_tx;
+        if (!r.match) {
+            random_failures++;
+            if (random_failures <= 5) print_case("random_mismatch", i, r);
+        }
+    }
+    failures += random_failures;
+    printf("{\"summary\":true,\"random_cases\":%d,\"random_failures\":%d,"
+           "\"driver_tx_mean\":%.1f,\"batched_tx_mean\":%.1f,\"failures\":%d}\n",
+           random_cases, random_failures,
+           random_cases ? (double)driver_tx / random_cases : 0.0,
+           random_cases ? (double)batched_tx / random_cases : 0.0, failures);
+    return failures ? 1 : 0;
+}
@@ -6,12 +6,11 @@
 #include "secrets.h"
 #include <Preferences.h>
 
-// ---- RTSP (ESP32-RTSPServer) ----
-// Library: https://github.com/rjsachse/ESP32-RTSPServer
-#include <ESP32-RTSPServer.h>
+// ---- RTSP (non-blocking, multi-session) ----
+#include "RtspServerLite.h"
 
 // ---- Web + OTA ----
-#include <WebServer.h>
+#include "HttpServerLite.h"
 #include <ArduinoOTA.h>
 
 #include <sys/time.h>
@@ -19,6 +18,23 @@
 #include <string.h>
 #include "esp_sntp.h"
 #include "favicon.h"
+#include "web_assets.h"
+#include "FrameRing.h"
+#include "AdaptiveBitrate.h"
+#include "FrameGovernor.h"
+#include "MjpegServer.h"
+#include "SnapshotCache.h"
+#include "PerfProbe.h"
+#include "JsonDelta.h"
+#include "CommandParser.h"
+#include "MqttConnector.h"
+#include "MqttOutbox.h"
+#include "SettingsStore.h"
+#include "ConfigBlob.h"
+#include "BootTimeline.h"
+#include "SensorShadow.h"
+#include "esp_timer.h"
+#include <freertos/event_groups.h>
 
 // ---- Camera pin map for AI Thinker ESP32-CAM ----
 #define PWDN_GPIO_NUM     32
@@ -49,24 +65,42 @@ Preferences prefs;
 Preferences camPrefs;
 WiFiClient netClient;
 PubSubClient mqtt(netClient);
-WebServer web(80);
+HttpServerLite web(80);   // non-blocking, several clients at once
+
+// Everything bound for MQTT except telemetry; drained by the control task
+#ifdef MQTT_TOPIC_VERBOSE
+static MqttOutbox outbox(MQTT_TOPIC_STATUS, MQTT_TOPIC_VERBOSE);
+#else
+static MqttOutbox outbox(MQTT_TOPIC_STATUS, MQTT_TOPIC_STATUS);
+#endif
+static MqttConnector mqtt_link;   // broker connection state machine (see MQTT CONNECTION)
 
 // Nominal “status” resolution for RTSP (may differ from actual fb->width/height)
 static const uint16_t STREAM_WIDTH  = 640;
 static const uint16_t STREAM_HEIGHT = 480;
 
-// ESP32-RTSPServer instance (video-only for now)
-static RTSPServer rtspServer;
+// RTSP server instance (video-only, up to RtspServerLite::MAX_SESSIONS viewers)
+static RtspServerLite rtspServer(RTSP_PORT, DEVICE_NAME);
+
+// Browser MJPEG preview, served by the stream task (see STREAM TASK)
+#ifndef MJPEG_PORT
+#define MJPEG_PORT 81
+#endif
+static MjpegServer mjpegServer(MJPEG_PORT);
 
 // RTSP stream path
 static const char *RTSP_STREAM_PATH = "mjpeg";   // Changeable
 
 
-bool  stream_on   = false;
-bool  led_active  = false;
+// Streaming state is owned by the stream task (see TASKS); the control
+// task changes it with stream_command() and reads it with stream_state().
+static bool stream_on = false;
+
+// Control-plane state, touched only by the control task
+static bool   led_active = false;
+static uint8_t flash_level = 0;
 unsigned long led_on_ms           = 0;
 unsigned long last_telem_ms       = 0;
-unsigned long last_mqtt_attempt_ms = 0;
 
 // Web UI options
 static bool show_fahrenheit   = false;   // toggled at /toggle_temp
@@ -75,12 +109,95 @@ static bool stream_default_on = true;    // default stream-on state persisted in
 // Don't call OTA when disabled
 static bool ota_enabled = false;
 
+// Adaptive quality/framesize control of the RTSP stream (persisted in prefs).
+// Stream task only, once it is running.
+static AdaptiveBitrate abr;
+static bool abr_enabled = true;
+static uint32_t last_abr_ms = 0;
+
+// Capture rate cap in frames/s, 0 = unlimited (persisted in prefs)
+static volatile uint16_t target_fps = 0;
+
+// /snapshot.jpg answers from this copy while it is younger than
+// snapshot_max_age_ms (persisted in prefs)
+static SnapshotCache snapshot_cache;
+static uint32_t snapshot_max_age_ms = 1000;
+
+// =============================================================
+//  PERSISTENT CONFIG
+//  Everything saved across reboots, as one blob in the
+//  "settings" namespace (see ConfigBlob.h). Loaded once in
+//  setup(); the control task changes it and calls config_save().
+// =============================================================
+static const uint16_t CONFIG_VERSION   = 2;
+static const size_t   CONFIG_CAM_SLOTS = 24;   // room for camera parameters without moving fields
+
+// Append new fields at the end and bump CONFIG_VERSION.
+struct DeviceConfig {
+  char     timezone[64];
+  uint8_t  temp_f;
+  uint8_t  stream_default;
+  uint8_t  abr;
+  uint8_t  reserved;
+  uint16_t target_fps;
+  uint16_t reserved2;
+  uint32_t snapshot_max_age_ms;
+  uint32_t cam_saved;                   // bit per CamParamId with a saved value
+  int16_t  cam[CONFIG_CAM_SLOTS];       // indexed by CamParamId
+  // v2: last AP joined, for a fast reconnect at boot (channel 0 = none)
+  uint8_t  wifi_bssid[6];
+  uint8_t  wifi_channel;
+  uint8_t  reserved3;
+};
+// No tail padding: a field appended there would load old padding bytes (ConfigBlob.h)
+static_assert(sizeof(DeviceConfig) == offsetof(DeviceConfig, reserved3) + 1,
+              "DeviceConfig ends in padding");
+
+typedef ConfigBlob<DeviceConfig> DeviceConfigBlob;
+
+static DeviceConfig config;
+
+static void config_defaults(DeviceConfig& c) {
+  memset(&c, 0, sizeof(c));
+  strncpy(c.timezone, "UTC0", sizeof(c.timezone) - 1);
+  c.stream_default      = 1;
+  c.abr                 = 1;
+  c.snapshot_max_age_ms = 1000;
+}
+
+static bool config_save() {
+  uint8_t blob[DeviceConfigBlob::SIZE];
+  size_t n = DeviceConfigBlob::pack(config, CONFIG_VERSION, blob);
+  return prefs.putBytes("config", blob, n) == n;
+}
+
+static void config_set_timezone(const char* tz) {
+  strncpy(config.timezone, tz, sizeof(config.timezone) - 1);
+  config.timezone[sizeof(config.timezone) - 1] = '\0';
+  config_save();
+}
+
+// Boot timing: the phase timeline, plus time spent on config load and
+// sensor settings. Reported once by the control task (see CONTROL TASK).
+static BootTimeline boot;
+static uint32_t boot_config_us = 0;
+static unsigned boot_cam_applied = 0;
+
 // =============================================================
 //  TELEMETRY / TIMING CONSTANTS
 // =============================================================
 static const uint32_t TELEMETRY_INTERVAL_MS   = 15000;
-static const uint32_t MQTT_RETRY_INTERVAL_MS  = 5000;
+static const uint32_t TELEMETRY_FULL_MS       = 300000; // full retained telemetry at least this often
+static const uint16_t MQTT_HANDSHAKE_S        = 2;      // CONNECT/CONNACK bound once TCP is up
 static const uint32_t FLASH_AUTO_OFF_MS       = 10000;
+static const uint32_t CAPTURE_IDLE_MS         = 2000;   // keep capturing this long after the last consumer
+static const uint32_t SNAPSHOT_MAX_AGE_MS     = 500;    // older ring frames are not served as snapshots
+static const uint32_t SNAPSHOT_WAIT_MS        = 1000;   // parked /snapshot.jpg requests, then the old frame
+static const int      SNAPSHOT_PARKED_MAX     = 4;
+static const uint32_t SNAPSHOT_CACHE_LIMIT_MS = 60000;  // upper bound for snapshot_max_age_ms
+static const uint32_t ABR_SAMPLE_MS           = 250;
+
+static void cam_store_flush(bool force);   // see CAMERA PARAMETERS
 
 // =============================================================
 //  ArduinoOTA Setup
@@ -114,6 +231,7 @@ static void setupOTA() {
     // Optional diagnostics
     ArduinoOTA.onStart([]() {
         Serial.println("[OTA] Start");
+        cam_store_flush(true);   // don't lose a pending save to the reboot
     });
     ArduinoOTA.onEnd([]() {
         Serial.println("[OTA] End");
@@ -143,17 +261,12 @@ static float readCcdTempC() {
 //  LOGGING HELPERS
 // =============================================================
 
+// Serial now, MQTT via the outbox: verbose lines are batched, the rest
+// go to MQTT_TOPIC_STATUS one by one. Control task only.
 static void log_line(const char* msg, bool verbose = false) {
   Serial.println(msg);
-  if (!mqtt.connected()) return;
-
-#ifdef MQTT_TOPIC_VERBOSE
-  if (verbose) {
-    mqtt.publish(MQTT_TOPIC_VERBOSE, msg, false);
-    return;
-  }
-#endif
-  mqtt.publish(MQTT_TOPIC_STATUS, msg, false);
+  if (verbose) outbox.log(msg);
+  else         outbox.status(msg, false);
 }
 
 static void logf(const char* fmt, ...) {
@@ -205,20 +318,32 @@ static esp_err_t camera_reinit(uint32_t xclk_hz, framesize_t fsize, int jpeg_qua
   config.frame_size   = fsize;
   config.jpeg_quality = jpeg_quality;
   config.fb_count     = fb_count;
-  config.grab_mode    = CAMERA_GRAB_WHEN_EMPTY;
+  // With spare buffers, hand out the newest one: the capture task may sit
+  // idle between governed grabs and must not get a stale frame afterwards.
+  config.grab_mode    = fb_count > 1 ? CAMERA_GRAB_LATEST : CAMERA_GRAB_WHEN_EMPTY;
 
   esp_camera_deinit();
   return esp_camera_init(&config);
 }
 
-static bool camera_init_auto() {
-  int fb_count = psramFound() ? 2 : 1;
-
-  // Prefer QVGA-ish to keep bandwidth and RAM usage modest; framesize still VGA for RTSP
-  if (camera_reinit(20000000, FRAMESIZE_VGA, 10, fb_count) != ESP_OK) {
-    if (camera_reinit(10000000, FRAMESIZE_QVGA, 12, fb_count) != ESP_OK) {
-      Serial.println("Camera init failed (both attempts).");
-      return false;
+// framesize/quality: what to start the sensor with (the saved baseline,
+// VGA/10 when nothing is saved)
+static bool camera_init_auto(framesize_t framesize, int quality) {
+  // One buffer stays pinned as the ring's latest frame, so give the driver a
+  // spare when PSRAM allows it.
+  int fb_count = psramFound() ? 3 : 1;
+
+  // Some modules only come up at 10 MHz XCLK: retry there with the same
+  // settings, and only then at QVGA/12 (the saved framesize is lost then).
+  if (camera_reinit(20000000, framesize, quality, fb_count) != ESP_OK) {
+    Serial.println("Camera init at 20 MHz failed, retrying at 10 MHz.");
+    if (camera_reinit(10000000, framesize, quality, fb_count) != ESP_OK) {
+      Serial.printf("Camera init at framesize %d/quality %d failed, falling back to QVGA/12.\n",
+                    (int)framesize, quality);
+      if (camera_reinit(10000000, FRAMESIZE_QVGA, 12, fb_count) != ESP_OK) {
+        Serial.println("Camera init failed (all attempts).");
+        return false;
+      }
     }
   }
 
@@ -237,6 +362,208 @@ static bool camera_init_auto() {
   return true;
 }
 
+// =============================================================
+//  TASKS
+//  Streaming plane (capture, RTSP, MJPEG) runs on STREAM_CORE;
+//  the control plane (web, MQTT, OTA, telemetry, flash) on
+//  CONTROL_CORE alongside the WiFi stack. The planes don't share
+//  mutable state: commands go to the stream task on
+//  stream_cmd_q, it posts its state to stream_state_q (a
+//  one-slot mailbox) and log/status lines to control_msg_q.
+// =============================================================
+static const BaseType_t STREAM_CORE  = 1;
+static const BaseType_t CONTROL_CORE = 0;
+
+static const uint32_t STREAM_STATE_MS = 250;    // mailbox refresh while idle
+static const uint32_t TASK_STATS_MS   = 2000;   // CPU share window
+
+enum StreamCmdType : uint8_t {
+  STREAM_CMD_RUN,          // a = 0/1
+  STREAM_CMD_ABR_ENABLE,   // a = 0/1
+  STREAM_CMD_ABR_BASE,     // a = quality, b = framesize; -1 keeps the current one
+};
+
+struct StreamCmd {
+  StreamCmdType type;
+  int16_t       a;
+  int16_t       b;
+};
+
+// What the control plane may know about the stream task
+struct StreamState {
+  bool     stream_on;
+  bool     abr_enabled;
+  int8_t   abr_level;
+  uint8_t  abr_quality;
+  uint8_t  abr_framesize;
+  uint8_t  abr_base_quality;
+  uint8_t  abr_base_framesize;
+  uint8_t  abr_reason;
+  uint8_t  rtsp_sessions;
+  uint8_t  mjpeg_clients;
+  RtpPacketPool::Stats rtp_pool;
+};
+
+// Log line (or MQTT status message) from the stream task
+struct ControlMsg {
+  bool status;
+  char text[96];
+};
+
+static QueueHandle_t stream_cmd_q   = nullptr;
+static QueueHandle_t stream_state_q = nullptr;
+static QueueHandle_t control_msg_q  = nullptr;
+
+// Both planes talk to the sensor over SCCB (ABR on the stream side, the
+// camera settings routes on the control side); one transaction at a time.
+static SemaphoreHandle_t sensor_mutex = nullptr;
+
+struct SensorLock {
+  bool held;
+  SensorLock() : held(sensor_mutex && xSemaphoreTake(sensor_mutex, portMAX_DELAY) == pdTRUE) {}
+  ~SensorLock() { unlock(); }
+  void unlock() {
+    if (held) xSemaphoreGive(sensor_mutex);
+    held = false;
+  }
+};
+
+enum TaskId { TASK_CAPTURE, TASK_STREAM, TASK_CONTROL, TASK_COUNT };
+
+// Each task adds the time it spends working (not blocked or delayed) to
+// its own busy_us; the control task turns that into a CPU share.
+struct TaskInfo {
+  const char*           name;
+  BaseType_t            core;
+  TaskHandle_t          handle;
+  volatile uint32_t     busy_us;
+  uint32_t              busy_last_us;
+  uint16_t              cpu_permille;   // of one core, over the last window
+};
+
+static TaskInfo task_info[TASK_COUNT] = {
+  { "capture", STREAM_CORE,  nullptr, 0, 0, 0 },
+  { "stream",  STREAM_CORE,  nullptr, 0, 0, 0 },
+  { "control", CONTROL_CORE, nullptr, 0, 0, 0 },
+};
+
+static void task_busy(TaskId id, uint32_t since_us) {
+  task_info[id].busy_us += micros() - since_us;
+}
+
+static bool tasks_create_queues() {
+  stream_cmd_q   = xQueueCreate(8, sizeof(StreamCmd));
+  stream_state_q = xQueueCreate(1, sizeof(StreamState));
+  control_msg_q  = xQueueCreate(8, sizeof(ControlMsg));
+  sensor_mutex   = xSemaphoreCreateMutex();
+  return stream_cmd_q && stream_state_q && control_msg_q && sensor_mutex;
+}
+
+static bool task_start(TaskId id, TaskFunction_t fn, uint32_t stack, UBaseType_t prio) {
+  BaseType_t ok = xTaskCreatePinnedToCore(
+    fn, task_info[id].name, stack, nullptr, prio, &task_info[id].handle, task_info[id].core);
+  return ok == pdPASS;
+}
+
+// Control side: queue a command for the stream task. Returns false when
+// the queue is full (the stream task is stuck), so the caller can report it.
+static bool stream_command(StreamCmdType type, int a, int b = -1) {
+  StreamCmd cmd = { type, (int16_t)a, (int16_t)b };
+  return xQueueSend(stream_cmd_q, &cmd, pdMS_TO_TICKS(20)) == pdTRUE;
+}
+
+// Control side: the stream task's last posted state.
+static StreamState stream_state() {
+  StreamState st;
+  if (!stream_state_q || xQueuePeek(stream_state_q, &st, 0) != pdTRUE) {
+    memset(&st, 0, sizeof(st));
+  }
+  return st;
+}
+
+// Stream side: hand a line to the control task for Serial/MQTT.
+static void stream_post(bool status, const char* fmt, ...) {
+  ControlMsg msg;
+  msg.status = status;
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(msg.text, sizeof(msg.text), fmt, args);
+  va_end(args);
+  xQueueSend(control_msg_q, &msg, 0);   // drop rather than stall the stream
+}
+
+// =============================================================
+//  CAPTURE TASK
+//  The only caller of esp_camera_fb_get(). Frames go into a
+//  refcounted ring; RTSP and /snapshot.jpg read the latest one.
+// =============================================================
+static void release_camera_fb(camera_fb_t* fb) {
+  esp_camera_fb_return(fb);
+}
+
+typedef FrameRing<camera_fb_t, 4> CameraFrameRing;
+static CameraFrameRing frame_ring(release_camera_fb);
+
+static volatile uint32_t capture_demand_ms = 0;
+static volatile bool capture_kick = false;     // a snapshot wants a frame now
+static uint32_t rtsp_last_seq = 0;
+
+// Paces capture to target_fps. Owned by the capture task; other tasks only
+// read its stats (word-sized fields, so a torn read is just a stale mix).
+static FrameGovernor frame_governor;
+
+static const uint32_t CAPTURE_MAX_SLEEP_MS = 20;   // bound on reaction to kicks/stop
+
+// Every consumer (stream task while streaming, MJPEG viewers, snapshots)
+// calls this to keep capture running.
+static void capture_touch() {
+  capture_demand_ms = millis();
+}
+
+static void capture_task(void*) {
+  for (;;) {
+    bool wanted = millis() - capture_demand_ms < CAPTURE_IDLE_MS;
+    if (!wanted) {
+      frame_ring.clear();
+      vTaskDelay(pdMS_TO_TICKS(50));
+      continue;
+    }
+
+    if (frame_governor.targetFps() != target_fps) {
+      frame_governor.setTargetFps(target_fps);
+    }
+
+    // Wait for the governor's next slot unless a snapshot is waiting
+    uint64_t now_us = esp_timer_get_time();
+    bool due = frame_governor.due(now_us);
+    if (!due && !capture_kick) {
+      uint32_t wait_ms = frame_governor.waitUs(now_us) / 1000;
+      if (wait_ms > CAPTURE_MAX_SLEEP_MS) wait_ms = CAPTURE_MAX_SLEEP_MS;
+      vTaskDelay(pdMS_TO_TICKS(wait_ms ? wait_ms : 1));
+      continue;
+    }
+
+    PERF_BEGIN(grab_start);
+    camera_fb_t* fb = esp_camera_fb_get();     // blocks until DMA delivers; not counted as busy
+    PERF_END(grab_start, PERF_CAPTURE);
+    if (!fb) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      continue;
+    }
+    uint32_t busy_start = micros();
+    capture_kick = false;
+    // Out-of-schedule snapshot grabs don't move the schedule or the stats
+    if (due) frame_governor.taken(esp_timer_get_time());
+    frame_ring.publish(fb, millis());
+    boot.mark(BOOT_FIRST_FRAME, millis());
+    task_busy(TASK_CAPTURE, busy_start);
+  }
+}
+
+static bool capture_start() {
+  return task_start(TASK_CAPTURE, capture_task, 4096, 5);
+}
+
 // =============================================================
 //  OV2640 RAW TEMPERATURE REGISTER (UNOFFICIAL)
 //  NOTE: Must restore sensor registers after reading to avoid
@@ -245,6 +572,7 @@ static bool camera_init_auto() {
 static int read_ov2640_temp_raw() {
     sensor_t* s = esp_camera_sensor_get();
     if (!s) return -1;
+    SensorLock lock;   // bank switch must not interleave with ABR writes
 
     // Select sensor register bank 1
     if (s->set_reg(s, 0xFF, 0x01, 0x01) != 0) {
@@ -298,6 +626,21 @@ static void build_status_json(char* out, size_t out_len) {
 
   IPAddress ip = WiFi.localIP();
 
+  FrameGovernor::Stats fps_stats = frame_governor.stats();
+  StreamState st = stream_state();
+  const RtpPacketPool::Stats& pool = st.rtp_pool;
+
+  char tasks[200];
+  size_t tl = 0;
+  for (int i = 0; i < TASK_COUNT && tl < sizeof(tasks); ++i) {
+    const TaskInfo& t = task_info[i];
+    tl += snprintf(tasks + tl, sizeof(tasks) - tl,
+                   "%s\"%s\":{\"core\":%d,\"stack_free\":%u,\"cpu\":%.1f}",
+                   i ? "," : "", t.name, (int)t.core,
+                   t.handle ? (unsigned)uxTaskGetStackHighWaterMark(t.handle) : 0u,
+                   t.cpu_permille / 10.0f);
+  }
+
   snprintf(
     out,
     out_len,
@@ -314,7 +657,18 @@ static void build_status_json(char* out, size_t out_len) {
       "\"ccd_temp_c\":%s,"
       "\"ccd_temp_f\":%s,"
       "\"stream_on\":%s,"
-      "\"flash_on\":%s"
+      "\"flash_on\":%s,"
+      "\"rtsp_sessions\":%d,"
+      "\"mjpeg_clients\":%d,"
+      "\"http\":{\"clients\":%d,\"requests\":%lu,\"timeouts\":%lu,\"rejected\":%lu,"
+        "\"subscribers\":%d,\"event_drops\":%lu},"
+      "\"mqtt\":{\"state\":\"%s\",\"attempts\":%lu,\"retry_ms\":%lu,\"log_queued\":%u,\"status_queued\":%u,\"batches\":%lu,\"dropped\":%lu},"
+      "\"snapshot\":{\"hits\":%lu,\"misses\":%lu,\"not_modified\":%lu},"
+      "\"fps\":{\"target\":%u,\"actual\":%.2f,\"min_ms\":%.1f,\"avg_ms\":%.1f,\"max_ms\":%.1f},"
+      "\"rtp_pool\":{\"slots\":%u,\"psram_slots\":%u,\"in_use\":%u,\"high_water\":%u,"
+        "\"internal_hw\":%u,\"psram_hw\":%u,\"frames_hw\":%u,\"exhausted\":%lu,\"oversize\":%lu},"
+      "\"abr\":{\"enabled\":%s,\"level\":%d,\"quality\":%d,\"framesize\":%d,\"reason\":\"%s\"},"
+      "\"tasks\":{%s}"
     "}",
     DEVICE_NAME,
     ip.toString().c_str(),
@@ -327,41 +681,116 @@ static void build_status_json(char* out, size_t out_len) {
     cpuF,
     ccdC_field,
     ccdF_field,
-    stream_on ? "true" : "false",
-    led_active ? "true" : "false"
+    st.stream_on ? "true" : "false",
+    led_active ? "true" : "false",
+    (int)st.rtsp_sessions,
+    (int)st.mjpeg_clients,
+    web.clientCount(),
+    (unsigned long)web.requests(),
+    (unsigned long)web.timeouts(),
+    (unsigned long)web.rejected(),
+    web.eventClientCount(),
+    (unsigned long)web.eventDrops(),
+    MqttConnector::stateName(mqtt_link.state()),
+    (unsigned long)mqtt_link.attempts(),
+    (unsigned long)mqtt_link.retryInMs(millis()),
+    (unsigned)outbox.queuedBytes(),
+    (unsigned)outbox.queuedStatus(),
+    (unsigned long)outbox.batches(),
+    (unsigned long)(outbox.logDropped() + outbox.statusDropped()),
+    (unsigned long)snapshot_cache.hits(),
+    (unsigned long)snapshot_cache.misses(),
+    (unsigned long)snapshot_cache.notModified(),
+    (unsigned)target_fps,
+    frame_governor.actualFpsX100() / 100.0f,
+    fps_stats.min_us / 1000.0f,
+    fps_stats.avg_us / 1000.0f,
+    fps_stats.max_us / 1000.0f,
+    (unsigned)(pool.internal_slots + pool.psram_slots),
+    (unsigned)pool.psram_slots,
+    (unsigned)pool.in_use,
+    (unsigned)pool.high_water,
+    (unsigned)pool.internal_high_water,
+    (unsigned)pool.psram_high_water,
+    (unsigned)pool.frames_high_water,
+    (unsigned long)pool.exhausted,
+    (unsigned long)pool.oversize,
+    st.abr_enabled ? "true" : "false",
+    (int)st.abr_level,
+    (int)st.abr_quality,
+    (int)st.abr_framesize,
+    AdaptiveBitrate::reasonName((AdaptiveBitrate::Reason)st.abr_reason),
+    tasks
   );
 }
 
-// MQTT telemetry publisher (compact JSON)
+// MQTT telemetry: the full JSON (retained) after each connect and every
+// TELEMETRY_FULL_MS, otherwise only the top-level members that changed
+// since the last one, not retained. Subscribers merge deltas into the last
+// full message. Telemetry isn't queued while offline; the first one after
+// reconnecting is full anyway.
+static char telem_prev[1280];
+static char telem_delta[1280];
+static bool telem_full_due = true;
+static uint32_t telem_full_ms = 0;
+
 static void publish_telemetry() {
-  if (!mqtt.connected()) return;
-  char msg[256];
+  if (!mqtt.connected()) {
+    telem_full_due = true;
+    return;
+  }
+  char msg[1280];
   build_status_json(msg, sizeof(msg));
-  mqtt.publish(MQTT_TOPIC_TELEM, msg, true);
+
+  uint32_t now = millis();
+  size_t n = 0;
+  if (!telem_full_due && now - telem_full_ms < TELEMETRY_FULL_MS) {
+    n = json_delta(telem_prev, msg, telem_delta, sizeof(telem_delta));
+  }
+  bool sent;
+  if (n == 2) {
+    sent = true;                        // nothing changed
+  } else if (n) {
+    sent = mqtt.publish(MQTT_TOPIC_TELEM, (const uint8_t*)telem_delta, n, false);
+  } else {
+    sent = mqtt.publish(MQTT_TOPIC_TELEM, msg, true);
+    if (sent) {
+      telem_full_due = false;
+      telem_full_ms = now;
+    }
+  }
+  if (sent) memcpy(telem_prev, msg, strlen(msg) + 1);
+
+#if PERF_PROBES && defined(MQTT_TOPIC_PERF)
+  char perf[1280];
+  if (perf_stats().writeJson(perf, sizeof(perf))) mqtt.publish(MQTT_TOPIC_PERF, perf, false);
+#endif
 }
 
-// Simple status text message
+// Simple status text message (retained); queued until the broker has it
 static void publish_status(const char* msg) {
   if (!mqtt.connected()) {
     Serial.print("[STATUS] (offline MQTT) ");
     Serial.println(msg);
-    return;
   }
-  mqtt.publish(MQTT_TOPIC_STATUS, msg, true);
+  outbox.status(msg, true);
+}
+
+static bool outbox_publish(const char* topic, const uint8_t* payload, size_t len, bool retained) {
+  return mqtt.publish(topic, payload, (unsigned int)len, retained);
 }
 
 // =============================================================
 //  CONTROL HELPERS (STREAM / FLASH)
 // =============================================================
+// The stream task applies it and reports back "stream:on"/"stream:off".
 static void set_stream(bool on) {
-  if (stream_on == on) return;
-  stream_on = on;
-  publish_status(on ? "stream:on" : "stream:off");
-  logf("Stream %s", on ? "ENABLED" : "DISABLED");
+  if (!stream_command(STREAM_CMD_RUN, on)) log_line("Stream task not responding", true);
 }
 
 static void set_flash(uint8_t value) {
   ledcWrite(0, value);
+  flash_level = value;
   bool now_on = (value > 0);
   if (now_on) {
     led_active = true;
@@ -373,57 +802,670 @@ static void set_flash(uint8_t value) {
   }
 }
 
+static void set_target_fps(int fps) {
+  fps = constrain(fps, 0, (int)FrameGovernor::MAX_FPS);
+  if (target_fps == fps) return;
+  target_fps = (uint16_t)fps;
+  config.target_fps = target_fps;
+  config_save();
+  logf("Target FPS %d%s", fps, fps ? "" : " (unlimited)");
+}
+
+// =============================================================
+//  ADAPTIVE BITRATE
+// =============================================================
+// Feed stream health to the controller and apply what it decides.
+static void abr_update() {
+  uint32_t now = millis();
+  if (now - last_abr_ms < ABR_SAMPLE_MS) return;
+  last_abr_ms = now;
+
+  const RtpFanout& fo = rtspServer.fanout();
+  AdaptiveBitrate::Sample sample;
+  sample.frames_sent       = fo.framesSent();
+  sample.frames_dropped    = fo.framesDropped();
+  sample.backlog_frames    = fo.maxBacklog();
+  sample.send_ms           = fo.maxSendMs();
+  sample.frame_interval_ms = rtspServer.frameIntervalMs();
+  sample.rssi_dbm          = WiFi.RSSI();
+
+  if (!abr.update(now, sample)) return;
+
+  sensor_t* s = esp_camera_sensor_get();
+  if (!s) return;
+  SensorLock lock;
+  if (s->status.quality != abr.quality()) s->set_quality(s, abr.quality());
+  if (s->status.framesize != abr.framesize()) s->set_framesize(s, (framesize_t)abr.framesize());
+  stream_post(false, "ABR: level %d quality %d framesize %d (%s)", abr.level(), abr.quality(),
+              abr.framesize(), AdaptiveBitrate::reasonName(abr.reason()));
+}
+
+// User-chosen quality/framesize: the controller's baseline, applied as-is.
+// Stream task (or setup() before it starts); the control plane goes
+// through request_abr_base().
+static void abr_set_base(int quality, int framesize) {
+  abr.setBase(quality, framesize);
+  sensor_t* s = esp_camera_sensor_get();
+  if (!s) return;
+  SensorLock lock;
+  if (s->status.quality != quality) s->set_quality(s, quality);
+  if (s->status.framesize != framesize) s->set_framesize(s, (framesize_t)framesize);
+}
+
+// Control side: new user baseline; -1 keeps the current value.
+static void request_abr_base(int quality, int framesize) {
+  if (!stream_command(STREAM_CMD_ABR_BASE, quality, framesize)) {
+    log_line("Stream task not responding", true);
+  }
+}
+
+static void set_abr(bool enabled) {
+  config.abr = enabled;
+  config_save();
+  stream_command(STREAM_CMD_ABR_ENABLE, enabled);
+}
+
+// =============================================================
+//  CAMERA PARAMETERS
+//  One table behind /api/set_cam_param and the MQTT .../set
+//  topics; the ranges are also what Home Assistant is told.
+// =============================================================
+enum CamParamId {
+  CP_BRIGHTNESS, CP_CONTRAST, CP_SATURATION, CP_SHARPNESS, CP_DENOISE,
+  CP_AE_LEVEL, CP_AGC_GAIN, CP_AEC2, CP_AEC_VALUE, CP_AWB, CP_AWB_GAIN,
+  CP_HMIRROR, CP_VFLIP, CP_QUALITY, CP_GAINCEILING, CP_FRAMESIZE,
+  CP_COUNT
+};
+
+struct CamParam {
+  const char* name;     // API/prefs key
+  const char* label;
+  int16_t     min;
+  int16_t     max;
+  int8_t      ov2640;   // Ov2640Param for register batching, -1: driver setter
+};
+
+static const int8_t NO_REG = -1;
+
+// In CamParamId order
+static const CamParam CAM_PARAMS[CP_COUNT] = {
+  { "brightness",  "Brightness",         -2,     2, NO_REG },
+  { "contrast",    "Contrast",           -2,     2, NO_REG },
+  { "saturation",  "Saturation",         -2,     2, NO_REG },
+  { "sharpness",   "Sharpness",          -3,     3, NO_REG },
+  { "denoise",     "Denoise",             0,     8, NO_REG },
+  { "ae_level",    "AE level",           -2,     2, OV2640_AE_LEVEL },
+  { "agc_gain",    "AGC gain",            0,    30, OV2640_AGC_GAIN },
+  { "aec2",        "AEC2",                0,     1, OV2640_AEC2 },
+  { "aec_value",   "AEC value",           0,  1200, OV2640_AEC_VALUE },
+  { "awb",         "AWB",                 0,     1, OV2640_AWB },
+  { "awb_gain",    "AWB gain",            0,     1, OV2640_AWB_GAIN },
+  { "hmirror",     "Horizontal mirror",   0,     1, OV2640_HMIRROR },
+  { "vflip",       "Vertical flip",       0,     1, OV2640_VFLIP },
+  { "quality",     "JPEG quality",        4,    63, OV2640_QUALITY },
+  { "gainceiling", "Gain ceiling",        0,     6, OV2640_GAINCEILING },
+  { "framesize",   "Framesize",           0,    13, NO_REG },
+};
+
+static_assert(CP_COUNT <= CONFIG_CAM_SLOTS, "DeviceConfig::cam is too small");
+
+// Saved camera parameters, seeded from config at boot. Changes are written
+// back batched and debounced from the control task (cam_store_flush).
+static SettingsStore<CP_COUNT> cam_store;
+
+// Dirty parameters go into config, then one blob write for all of them.
+struct CamConfigWriter {
+  bool begin() { return true; }
+  bool write(size_t i, int32_t v) {
+    config.cam[i] = (int16_t)v;
+    config.cam_saved |= 1UL << i;
+    return true;
+  }
+  bool commit() { return config_save(); }
+  void end() {}
+};
+
+static void cam_store_flush(bool force) {
+  CamConfigWriter writer;
+  unsigned n = cam_store.flush(writer, millis(), force);
+  if (n) logf("Camera settings saved (%u key%s)", n, n == 1 ? "" : "s");
+}
+
+static int cam_param_find(const char* name, size_t len) {
+  for (int i = 0; i < CP_COUNT; ++i) {
+    if (strlen(CAM_PARAMS[i].name) == len && strncmp(CAM_PARAMS[i].name, name, len) == 0) return i;
+  }
+  return -1;
+}
+
+// Caller holds the sensor lock
+static void cam_param_apply(sensor_t* s, int id, int v) {
+  switch (id) {
+    case CP_BRIGHTNESS:  s->set_brightness(s, v); break;
+    case CP_CONTRAST:    s->set_contrast(s, v); break;
+    case CP_SATURATION:  s->set_saturation(s, v); break;
+    case CP_SHARPNESS:   s->set_sharpness(s, v); break;
+    case CP_DENOISE:     s->set_denoise(s, v); break;
+    case CP_AE_LEVEL:    s->set_ae_level(s, v); break;
+    case CP_AGC_GAIN:    s->set_agc_gain(s, v); break;
+    case CP_AEC2:        s->set_aec2(s, v); break;
+    case CP_AEC_VALUE:   s->set_aec_value(s, v); break;
+    case CP_AWB:         s->set_whitebal(s, v); break;
+    case CP_AWB_GAIN:    s->set_awb_gain(s, v); break;
+    case CP_HMIRROR:     s->set_hmirror(s, v); break;
+    case CP_VFLIP:       s->set_vflip(s, v); break;
+    case CP_QUALITY:     s->set_quality(s, v); break;
+    case CP_GAINCEILING: s->set_gainceiling(s, (gainceiling_t)v); break;
+    case CP_FRAMESIZE:   s->set_framesize(s, (framesize_t)v); break;
+  }
+}
+
+// What the sensor driver has; quality/framesize are the current ABR step
+static int cam_param_sensor_value(const sensor_t* s, int id) {
+  switch (id) {
+    case CP_BRIGHTNESS:  return s->status.brightness;
+    case CP_CONTRAST:    return s->status.contrast;
+    case CP_SATURATION:  return s->status.saturation;
+    case CP_SHARPNESS:   return s->status.sharpness;
+    case CP_DENOISE:     return s->status.denoise;
+    case CP_AE_LEVEL:    return s->status.ae_level;
+    case CP_AGC_GAIN:    return s->status.agc_gain;
+    case CP_AEC2:        return s->status.aec2;
+    case CP_AEC_VALUE:   return s->status.aec_value;
+    case CP_AWB:         return s->status.awb;
+    case CP_AWB_GAIN:    return s->status.awb_gain;
+    case CP_HMIRROR:     return s->status.hmirror;
+    case CP_VFLIP:       return s->status.vflip;
+    case CP_QUALITY:     return s->status.quality;
+    case CP_GAINCEILING: return s->status.gainceiling;
+    case CP_FRAMESIZE:   return s->status.framesize;
+  }
+  return 0;
+}
+
+// After a batched register write, what the driver's setter would have
+// recorded
+static void cam_param_set_status(sensor_t* s, int id, int v) {
+  switch (id) {
+    case CP_AE_LEVEL:    s->status.ae_level = v; break;
+    case CP_AGC_GAIN:    s->status.agc_gain = v; break;
+    case CP_AEC2:        s->status.aec2 = v; break;
+    case CP_AEC_VALUE:   s->status.aec_value = v; break;
+    case CP_AWB:         s->status.awb = v; break;
+    case CP_AWB_GAIN:    s->status.awb_gain = v; break;
+    case CP_HMIRROR:     s->status.hmirror = v; break;
+    case CP_VFLIP:       s->status.vflip = v; break;
+    case CP_QUALITY:     s->status.quality = v; break;
+    case CP_GAINCEILING: s->status.gainceiling = (gainceiling_t)v; break;
+  }
+}
+
+// SensorShadow's bus: ov2640's set_reg takes the bank in bit 8
+struct SensorRegBus {
+  sensor_t* s;
+  int write(uint8_t bank, uint8_t reg, uint8_t mask, uint8_t value) {
+    return s->set_reg(s, (bank << 8) | reg, mask, value);
+  }
+};
+
+struct CamApplyResult {
+  uint8_t setters;   // driver setter calls
+  int8_t  regs;      // batched register writes, -1 if they failed
+};
+
+// Applies values[i] for every bit i in `set` (already clamped); caller
+// holds the sensor lock. Parameters already at their value are skipped.
+// On an OV2640 the register parameters go out as one SensorShadow batch,
+// the rest through the driver's setters; framesize goes last as it
+// reconfigures the sensor.
+static CamApplyResult cam_params_apply(sensor_t* s, const int* values, uint32_t set) {
+  CamApplyResult res = { 0, 0 };
+  bool batch = s->id.PID == OV2640_PID;
+  SensorShadow shadow;
+  uint32_t batched = 0;
+
+  for (int i = 0; i < CP_COUNT; ++i) {
+    if (!(set & (1UL << i)) || i == CP_FRAMESIZE) continue;
+    int cur = cam_param_sensor_value(s, i);
+    if (values[i] == cur) continue;
+    int8_t reg = CAM_PARAMS[i].ov2640;
+    if (batch && reg != NO_REG && shadow.add((Ov2640Param)reg, cur, values[i])) {
+      batched |= 1UL << i;
+      continue;
+    }
+    cam_param_apply(s, i, values[i]);
+    res.setters++;
+  }
+
+  if (batched) {
+    SensorRegBus bus = { s };
+    res.regs = (int8_t)shadow.flush(bus);
+    for (int i = 0; i < CP_COUNT; ++i) {
+      if (!(batched & (1UL << i))) continue;
+      if (res.regs >= 0) {
+        cam_param_set_status(s, i, values[i]);
+      } else {
+        cam_param_apply(s, i, values[i]);
+        res.setters++;
+      }
+    }
+  }
+
+  if ((set & (1UL << CP_FRAMESIZE)) && values[CP_FRAMESIZE] != s->status.framesize) {
+    cam_param_apply(s, CP_FRAMESIZE, values[CP_FRAMESIZE]);
+    res.setters++;
+  }
+  return res;
+}
+
+// Quality/framesize report the user baseline, not the ABR step
+static int cam_param_value(const sensor_t* s, const StreamState& st, int id) {
+  if (id == CP_QUALITY)   return st.abr_base_quality;
+  if (id == CP_FRAMESIZE) return st.abr_base_framesize;
+  return cam_param_sensor_value(s, id);
+}
+
+// Sets and clamps one parameter and queues it for saving. False for an
+// unknown name or when there is no sensor.
+static bool set_cam_param(const char* name, size_t len, int v) {
+  int id = cam_param_find(name, len);
+  sensor_t* s = esp_camera_sensor_get();
+  if (id < 0 || !s) return false;
+
+  const CamParam& p = CAM_PARAMS[id];
+  v = constrain(v, (int)p.min, (int)p.max);
+  int values[CP_COUNT] = { 0 };
+  values[id] = v;
+  {
+    SensorLock lock;
+    cam_params_apply(s, values, 1UL << id);
+  }
+  if (id == CP_QUALITY)   request_abr_base(v, -1);
+  if (id == CP_FRAMESIZE) request_abr_base(-1, v);
+
+  cam_store.set(id, v, millis());
+  return true;
+}
+
+// =============================================================
+//  STREAM TASK
+//  RTSP sessions, the MJPEG preview and ABR, on STREAM_CORE next
+//  to capture. Never blocks: every server is polled with bounded
+//  work, then the task sleeps for a tick.
+// =============================================================
+static uint32_t stream_state_ms = 0;
+
+static void stream_apply(const StreamCmd& cmd) {
+  switch (cmd.type) {
+  case STREAM_CMD_RUN:
+    if (stream_on == (cmd.a != 0)) break;
+    stream_on = cmd.a != 0;
+    stream_post(true, stream_on ? "stream:on" : "stream:off");
+    stream_post(false, "Stream %s", stream_on ? "ENABLED" : "DISABLED");
+    break;
+  case STREAM_CMD_ABR_ENABLE:
+    abr_enabled = cmd.a != 0;
+    // Hand the user's settings back when the controller lets go
+    if (!abr_enabled) abr_set_base(abr.baseQuality(), abr.baseFramesize());
+    break;
+  case STREAM_CMD_ABR_BASE:
+    abr_set_base(cmd.a >= 0 ? cmd.a : abr.baseQuality(),
+                 cmd.b >= 0 ? cmd.b : abr.baseFramesize());
+    break;
+  }
+}
+
+static void stream_post_state() {
+  StreamState st;
+  st.stream_on          = stream_on;
+  st.abr_enabled        = abr_enabled;
+  st.abr_level          = (int8_t)abr.level();
+  st.abr_quality        = (uint8_t)abr.quality();
+  st.abr_framesize      = (uint8_t)abr.framesize();
+  st.abr_base_quality   = (uint8_t)abr.baseQuality();
+  st.abr_base_framesize = (uint8_t)abr.baseFramesize();
+  st.abr_reason         = (uint8_t)abr.reason();
+  st.rtsp_sessions      = (uint8_t)rtspServer.sessionCount();
+  st.mjpeg_clients      = (uint8_t)mjpegServer.viewerCount();
+  st.rtp_pool           = rtspServer.fanout().poolStats();
+  xQueueOverwrite(stream_state_q, &st);
+  stream_state_ms = millis();
+}
+
+static void stream_task(void*) {
+  mjpegServer.begin();
+  uint32_t mjpeg_last_seq = 0;
+  for (;;) {
+    uint32_t busy_start = micros();
+
+    bool changed = false;
+    StreamCmd cmd;
+    while (xQueueReceive(stream_cmd_q, &cmd, 0) == pdTRUE) {
+      stream_apply(cmd);
+      changed = true;
+    }
+    if (stream_on) capture_touch();
+
+    // RTSP: bounded, non-blocking service of every session
+    rtspServer.poll();
+
+    // Hand each new frame to the RTSP fan-out once; it is packetized a
+    // single time and shared by all playing sessions.
+    if (stream_on && rtspServer.hasViewers()) {
+      CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+      if (frame && frame.seq() != rtsp_last_seq) {
+        rtsp_last_seq = frame.seq();
+        sensor_t* s = esp_camera_sensor_get();
+        uint16_t header_key = s ? JpegScanner::key(s->status.quality, s->status.framesize) : 0;
+        rtspServer.pushFrame(frame->buf, frame->len, frame.stampMs(), header_key);
+      }
+      if (abr_enabled) abr_update();
+    }
+
+    // MJPEG preview
+    bool viewing = mjpegServer.hasViewers();
+    if (viewing) {
+      capture_touch();
+      CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+      if (frame && frame.seq() != mjpeg_last_seq) {
+        mjpeg_last_seq = frame.seq();
+        mjpegServer.publish(frame->buf, frame->len, mjpeg_last_seq);
+      }
+    }
+    PERF_BEGIN(poll_start);
+    mjpegServer.poll();
+    if (viewing) PERF_END(poll_start, PERF_MJPEG);
+
+    if (changed || millis() - stream_state_ms >= STREAM_STATE_MS) stream_post_state();
+
+    task_busy(TASK_STREAM, busy_start);
+    bool active = rtspServer.hasViewers() || mjpegServer.hasViewers();
+    vTaskDelay(active ? 1 : pdMS_TO_TICKS(10));
+  }
+}
+
+// Network must be up: the task opens the MJPEG listening socket on start.
+static bool stream_start() {
+  stream_post_state();
+  return task_start(TASK_STREAM, stream_task, 8192, 4);
+}
+
 // =============================================================
 //  MQTT HANDLING
 // =============================================================
+// =============================================================
+//  MQTT COMMANDS
+//  MQTT_TOPIC_CMD takes one or more fields, as JSON or key=value
+//  (CommandParser.h); MQTT_TOPIC_BASE/<key>/set takes just the
+//  value. Keys: stream, flash, fps, abr and every CAM_PARAMS name;
+//  a bare "start"/"stop" still works. The payload is copied to the
+//  stack and parsed in place, no String/heap.
+// =============================================================
+#ifndef MQTT_TOPIC_BASE
+#define MQTT_TOPIC_BASE "/esp32cam"
+#endif
+static const size_t COMMAND_MAX = 384;
+
+static bool ha_state_due = false;   // republish MQTT_TOPIC_BASE/state now
+
+static bool command_apply(const char* key, size_t klen, const char* val, size_t vlen) {
+  long n;
+  bool b;
+  if (vlen == 0) {
+    if (cmd_is(key, klen, "start")) set_stream(true);
+    else if (cmd_is(key, klen, "stop")) set_stream(false);
+    else return false;
+  } else if (cmd_is(key, klen, "stream")) {
+    if (!cmd_bool(val, vlen, b)) return false;
+    set_stream(b);
+  } else if (cmd_is(key, klen, "flash")) {
+    if (cmd_int(val, vlen, n))       n = constrain(n, 0L, 255L);
+    else if (cmd_bool(val, vlen, b)) n = b ? 255 : 0;
+    else return false;
+    set_flash((uint8_t)n);
+  } else if (cmd_is(key, klen, "fps")) {
+    if (!cmd_int(val, vlen, n)) return false;
+    set_target_fps((int)n);
+  } else if (cmd_is(key, klen, "abr")) {
+    if (!cmd_bool(val, vlen, b)) return false;
+    set_abr(b);
+  } else {
+    // Camera parameters; the on/off ones also take ON/OFF
+    if (!cmd_int(val, vlen, n)) {
+      if (!cmd_bool(val, vlen, b)) return false;
+      n = b ? 1 : 0;
+    }
+    if (!set_cam_param(key, klen, (int)n)) return false;
+  }
+  ha_state_due = true;
+  return true;
+}
+
 static void mqtt_callback(char* topic, byte* payload, unsigned int len) {
-  String cmd;
-  cmd.reserve(len);
-  for (unsigned int i = 0; i < len; ++i) {
-    cmd += static_cast<char>(payload[i]);
+  char buf[COMMAND_MAX];
+
+  // MQTT_TOPIC_BASE/<key>/set
+  const size_t base_len = sizeof(MQTT_TOPIC_BASE) - 1;
+  if (strncmp(topic, MQTT_TOPIC_BASE "/", base_len + 1) == 0) {
+    const char* key = topic + base_len + 1;
+    const char* end = strchr(key, '/');
+    if (end && strcmp(end, "/set") == 0) {
+      if (len >= sizeof(buf)) return;
+      memcpy(buf, payload, len);
+      buf[len] = '\0';
+      const char* val = buf;
+      size_t vlen = len;
+      cmd_trim(val, vlen);
+      if (!command_apply(key, (size_t)(end - key), val, vlen)) {
+        logf("MQTT: rejected %s '%s'", topic, val);
+      }
+      return;
+    }
   }
-  cmd.toLowerCase();
+  if (strcmp(topic, MQTT_TOPIC_CMD) != 0) return;
 
-  if (cmd.indexOf("start") != -1) {
-    set_stream(true);
-  } else if (cmd.indexOf("stop") != -1) {
-    set_stream(false);
-  } else if (cmd.startsWith("flash:")) {
-    int val = constrain(cmd.substring(6).toInt(), 0, 255);
-    set_flash((uint8_t)val);
+  CommandReader reader(buf, sizeof(buf), payload, len);
+  if (!reader.ok()) {
+    logf("MQTT: command too long (%u bytes)", len);
+    return;
+  }
+  CommandField f;
+  while (reader.next(f)) {
+    if (!command_apply(f.key, f.key_len, f.value, f.value_len)) {
+      logf("MQTT: rejected command %.*s=%.*s", (int)f.key_len, f.key, (int)f.value_len, f.value);
+    }
   }
 }
 
-static void mqtt_connect_once() {
-  if (mqtt.connected()) return;
-  if (WiFi.status() != WL_CONNECTED) return;
+// =============================================================
+//  HOME ASSISTANT
+//  Discovery configs (retained) go out one per control-task
+//  iteration after each connect. Entities read MQTT_TOPIC_BASE/state,
+//  republished (retained) when anything in it changes, whether from
+//  MQTT or the web UI. Availability is
+//  MQTT_TOPIC_BASE/availability, with "offline" as the last will.
+// =============================================================
+#ifndef HA_DISCOVERY_PREFIX
+#define HA_DISCOVERY_PREFIX "homeassistant"
+#endif
+static const char* HA_STATE_TOPIC = MQTT_TOPIC_BASE "/state";
+static const char* HA_AVAIL_TOPIC = MQTT_TOPIC_BASE "/availability";
+static const uint32_t HA_STATE_CHECK_MS = 1000;
+
+// Controls besides CAM_PARAMS; 0..1 ranges become switches, the rest numbers
+static const CamParam HA_CONTROLS[] = {
+  { "stream", "Stream",           0,   1, NO_REG },
+  { "abr",    "Adaptive bitrate", 0,   1, NO_REG },
+  { "flash",  "Flash",            0, 255, NO_REG },
+  { "fps",    "Target FPS",       0, FrameGovernor::MAX_FPS, NO_REG },
+};
+static const int HA_CONTROL_COUNT = sizeof(HA_CONTROLS) / sizeof(HA_CONTROLS[0]);
+static const int HA_ENTITY_COUNT  = HA_CONTROL_COUNT + CP_COUNT;
+
+static char     ha_state_prev[512];
+static uint32_t ha_state_ms = 0;
+static int      ha_discovery_next = HA_ENTITY_COUNT;
+
+static size_t build_ha_state(char* out, size_t out_len) {
+  StreamState st = stream_state();
+  size_t n = (size_t)snprintf(out, out_len, "{\"stream\":%d,\"abr\":%d,\"flash\":%u,\"fps\":%u",
+                              st.stream_on ? 1 : 0, st.abr_enabled ? 1 : 0,
+                              (unsigned)flash_level, (unsigned)target_fps);
+  sensor_t* s = esp_camera_sensor_get();
+  for (int i = 0; s && i < CP_COUNT && n < out_len; ++i) {
+    n += snprintf(out + n, out_len - n, ",\"%s\":%d", CAM_PARAMS[i].name, cam_param_value(s, st, i));
+  }
+  if (n + 2 > out_len) return 0;
+  out[n++] = '}';
+  out[n] = '\0';
+  return n;
+}
 
-  log_line("MQTT: attempting connection...", true);
+static bool ha_publish_discovery(int i) {
+  bool control = i < HA_CONTROL_COUNT;
+  const CamParam& e = control ? HA_CONTROLS[i] : CAM_PARAMS[i - HA_CONTROL_COUNT];
+  bool toggle = e.min == 0 && e.max == 1;
+
+  char topic[128];
+  snprintf(topic, sizeof(topic), HA_DISCOVERY_PREFIX "/%s/%s/%s/config",
+           toggle ? "switch" : "number", MQTT_CLIENT_ID, e.name);
+
+  char cfg[640];
+  size_t n = (size_t)snprintf(cfg, sizeof(cfg),
+    "{\"~\":\"%s\",\"name\":\"%s\",\"uniq_id\":\"%s_%s\","
+    "\"cmd_t\":\"~/%s/set\",\"stat_t\":\"~/state\",\"avty_t\":\"~/availability\",",
+    MQTT_TOPIC_BASE, e.label, MQTT_CLIENT_ID, e.name, e.name);
+  if (toggle) {
+    n += snprintf(cfg + n, sizeof(cfg) - n,
+                  "\"val_tpl\":\"{{ 'ON' if value_json.%s else 'OFF' }}\"", e.name);
+  } else {
+    n += snprintf(cfg + n, sizeof(cfg) - n,
+                  "\"val_tpl\":\"{{ value_json.%s }}\",\"min\":%d,\"max\":%d", e.name, e.min, e.max);
+  }
+  if (!control && n < sizeof(cfg)) n += snprintf(cfg + n, sizeof(cfg) - n, ",\"ent_cat\":\"config\"");
+  if (n < sizeof(cfg)) {
+    n += snprintf(cfg + n, sizeof(cfg) - n,
+                  ",\"dev\":{\"ids\":[\"%s\"],\"name\":\"%s\",\"mf\":\"Espressif\",\"mdl\":\"ESP32-CAM\"}}",
+                  MQTT_CLIENT_ID, DEVICE_NAME);
+  }
+  if (n >= sizeof(cfg)) return true;   // can't happen with these names; skip rather than retry
+  return mqtt.publish(topic, (const uint8_t*)cfg, (unsigned int)n, true);
+}
 
-  bool ok = false;
-#if defined(MQTT_USER) && defined(MQTT_PASS)
-  ok = mqtt.connect(MQTT_CLIENT_ID, MQTT_USER, MQTT_PASS);
-#else
-  ok = mqtt.connect(MQTT_CLIENT_ID);
-#endif
+static void ha_on_connected() {
+  mqtt.publish(HA_AVAIL_TOPIC, "online", true);
+  mqtt.subscribe(MQTT_TOPIC_BASE "/+/set");
+  ha_discovery_next = 0;
+  ha_state_prev[0] = '\0';
+}
 
-  if (!ok) {
-    int8_t state = mqtt.state();
-    char buf[96];
-    snprintf(buf, sizeof(buf), "MQTT connect failed, state=%d", state);
-    log_line(buf, true);
+// Control task, while connected
+static void ha_tick() {
+  if (ha_discovery_next < HA_ENTITY_COUNT) {
+    if (ha_publish_discovery(ha_discovery_next)) ha_discovery_next++;
     return;
   }
+  uint32_t now = millis();
+  if (!ha_state_due && now - ha_state_ms < HA_STATE_CHECK_MS) return;
+  ha_state_due = false;
+  ha_state_ms = now;
+
+  char state[sizeof(ha_state_prev)];
+  size_t n = build_ha_state(state, sizeof(state));
+  if (!n || strcmp(state, ha_state_prev) == 0) return;
+  if (mqtt.publish(HA_STATE_TOPIC, (const uint8_t*)state, (unsigned int)n, true)) {
+    memcpy(ha_state_prev, state, n + 1);
+  }
+}
+
+// =============================================================
+//  MQTT CONNECTION
+//  MqttConnector opens the TCP connection without blocking and
+//  spaces attempts with backoff + jitter; PubSubClient only runs
+//  the CONNECT/CONNACK exchange on the ready socket, which
+//  MQTT_HANDSHAKE_S bounds if the broker accepts but won't answer.
+// =============================================================
+
+// A literal address is used as is; a hostname costs a (blocking) DNS
+// lookup per attempt.
+static bool mqtt_resolve(IPAddress& ip) {
+  if (ip.fromString(MQTT_SERVER)) return true;
+  return WiFi.hostByName(MQTT_SERVER, ip) == 1;
+}
 
-  log_line("MQTT connected", true);
+static void mqtt_on_connected() {
+  boot.mark(BOOT_MQTT, millis());
+  logf("MQTT connected (attempt %lu)", (unsigned long)mqtt_link.attempts());
   mqtt.subscribe(MQTT_TOPIC_CMD);
+  ha_on_connected();
   publish_status("online");
 
   // Announce RTSP URL
   char rtsp_url[96];
   snprintf(rtsp_url, sizeof(rtsp_url), "rtsp://%s:%d/",
     WiFi.localIP().toString().c_str(), RTSP_PORT);
-  mqtt.publish(MQTT_TOPIC_STATUS, rtsp_url, true);
+  outbox.status(rtsp_url, true);
+  telem_full_due = true;
+}
+
+// Control task, every iteration: never waits on the network except for
+// the bounded handshake.
+static void mqtt_service() {
+  uint32_t now = millis();
+  if (mqtt.connected()) {
+    mqtt.loop();
+    ha_tick();
+    return;
+  }
+  if (mqtt_link.state() == MqttConnector::CONNECTED) {
+    mqtt_link.lost(now);
+    logf("MQTT connection lost, state=%d; retry in %lu ms",
+         mqtt.state(), (unsigned long)mqtt_link.retryInMs(now));
+  }
+  if (WiFi.status() != WL_CONNECTED) return;
+
+  if (mqtt_link.due(now)) {
+    IPAddress ip;
+    if (!mqtt_resolve(ip)) {
+      mqtt_link.unreachable(now);
+      logf("MQTT: cannot resolve %s; retry in %lu ms",
+           MQTT_SERVER, (unsigned long)mqtt_link.retryInMs(now));
+      return;
+    }
+    if (!mqtt_link.begin((uint32_t)ip, MQTT_PORT, now)) {
+      logf("MQTT: socket error %d; retry in %lu ms",
+           mqtt_link.lastError(), (unsigned long)mqtt_link.retryInMs(now));
+      return;
+    }
+  }
+
+  MqttConnector::State before = mqtt_link.state();
+  int fd = mqtt_link.poll(now);
+  if (fd < 0) {
+    if (before == MqttConnector::CONNECTING && mqtt_link.state() == MqttConnector::WAITING) {
+      logf("MQTT connect failed, errno=%d; retry in %lu ms",
+           mqtt_link.lastError(), (unsigned long)mqtt_link.retryInMs(now));
+    }
+    return;
+  }
+
+  netClient = WiFiClient(fd);
+  bool ok = false;
+#if defined(MQTT_USER) && defined(MQTT_PASS)
+  ok = mqtt.connect(MQTT_CLIENT_ID, MQTT_USER, MQTT_PASS, HA_AVAIL_TOPIC, 0, true, "offline");
+#else
+  ok = mqtt.connect(MQTT_CLIENT_ID, HA_AVAIL_TOPIC, 0, true, "offline");
+#endif
+  now = millis();
+  if (!ok) {
+    netClient.stop();
+    mqtt_link.failed(mqtt.state(), now);
+    logf("MQTT handshake failed, state=%d; retry in %lu ms",
+         mqtt.state(), (unsigned long)mqtt_link.retryInMs(now));
+    return;
+  }
+  mqtt_link.established(now);
+  mqtt_on_connected();
 }
 
 // =============================================================
@@ -434,417 +1476,71 @@ static void redirect_home() {
   web.send(303);
 }
 
-// HTML root page
-static void handle_root() {
-  String html;
-  html.reserve(4000);
+// Static UI from flash (web/ -> tools/embed_web.py -> web_assets.h).
+// Served gzip-compressed straight out of PROGMEM: nothing is built on the
+// heap per request. Live values are filled in from /api/status.
+// Heap over one page load (/, /app.css, /app.js): free heap when the load
+// starts and the lowest seen until it has been quiet for a second. Logged,
+// so a UI change can be checked on the device.
+static struct {
+  uint32_t start_free;
+  uint32_t lowest_free;
+  uint32_t start_min;
+  uint32_t last_ms;
+  bool     active;
+} ui_load;
+
+static void ui_load_sample() {
+  if (!ui_load.active) return;
+  uint32_t f = ESP.getFreeHeap();
+  if (f < ui_load.lowest_free) ui_load.lowest_free = f;
+  if (millis() - ui_load.last_ms < 1000 || web.clientCount() > 0) return;
+  ui_load.active = false;
+  logf("UI load: heap %u free before, %u lowest (peak use %u B)%s",
+       (unsigned)ui_load.start_free, (unsigned)ui_load.lowest_free,
+       (unsigned)(ui_load.start_free - ui_load.lowest_free),
+       ESP.getMinFreeHeap() < ui_load.start_min ? ", new low-water mark" : "");
+}
 
-  IPAddress ip = WiFi.localIP();
-  unsigned long uptime_s = millis() / 1000UL;
-  int rssi = WiFi.RSSI();
-  uint32_t heap_free  = ESP.getFreeHeap();
-  uint32_t psram_free = ESP.getFreePsram();
-  float cpuC = readCpuTempC();
-  float cpuF = cpuC * 9.0f / 5.0f + 32.0f;
+static void ui_load_mark() {
+  if (!ui_load.active) {
+    ui_load.start_free  = ESP.getFreeHeap();
+    ui_load.lowest_free = ui_load.start_free;
+    ui_load.start_min   = ESP.getMinFreeHeap();
+    ui_load.active      = true;
+  }
+  ui_load.last_ms = millis();
+}
 
-  time_t now_ts = time(nullptr);
-  struct tm tm_info;
-  localtime_r(&now_ts, &tm_info);
-
-  char time_buf[40];
-  strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S %Z", &tm_info);
-
-  html += F("<!DOCTYPE html><html><head><meta charset='utf-8'>"
-            "<meta name='viewport' content='width=device-width,initial-scale=1'>"
-            "<title>ESP32-CAM - ");
-  html += DEVICE_NAME;
-  html += F("</title>"
-            "<link rel='icon' type='image/png' href='/favicon.ico'>"
-            "<style>"
-            "body{margin:0;padding:0;font-family:system-ui,-apple-system,BlinkMacSystemFont,'Segoe UI',sans-serif;background:#111;color:#eee}"
-            "header{background:#222;padding:10px 16px;display:flex;justify-content:space-between;align-items:center;border-bottom:1px solid #333}"
-            "header h1{margin:0;font-size:18px}"
-            "header span{font-size:12px;color:#aaa}"
-            "main{padding:12px 16px;display:flex;flex-direction:column;gap:12px}"
-            ".grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(220px,1fr));gap:12px}"
-            ".card{background:#1a1a1a;border:1px solid #333;border-radius:8px;padding:10px 12px;box-sizing:border-box}"
-            ".card h2{margin:0 0 4px 0;font-size:14px;color:#f0f0f0}"
-            ".label{font-size:11px;color:#888}"
-            ".value{font-size:13px}"
-            // Unified two-column rows
-            ".row{"
-              "display:flex;"
-              "flex-wrap:wrap;"
-              "justify-content:space-between;"
-              "margin-bottom:4px;"
-            "}"
-            ".col{"
-              "flex:1 1 calc(50% - 8px);"
-              "margin:2px 0;"
-            "}"
-            "button, .btn{display:inline-block;padding:6px 10px;border-radius:6px;border:1px solid #444;background:#2b2b2b;color:#eee;font-size:12px;text-decoration:none;cursor:pointer;margin:2px 2px 0 0}"
-            "button:hover,.btn:hover{background:#3b3b3b}"
-            "img{max-width:100%;height:auto;border-radius:6px;border:1px solid #333}"
-            "code{font-size:11px;background:#000;padding:2px 4px;border-radius:4px}"
-
-            // Camera controls layout
-            ".cam-card{display:flex;flex-direction:column;}"
-            "#cam_ctrls{flex:1;display:grid;grid-template-columns:repeat(auto-fit,minmax(160px,1fr));"
-            "gap:4px 12px;align-content:flex-start;}"
-            ".cam-group-title{grid-column:1/-1;margin-top:6px;font-size:11px;color:#aaa;"
-            "text-transform:uppercase;letter-spacing:0.04em;}"
-            ".cam-footer{margin-top:8px;display:flex;justify-content:flex-end;}"
-            "</style>"
-            "<script>"
-            "const tzMap={\"America/Los_Angeles\":\"PST8PDT,M3.2.0/2,M11.1.0/2\"};"
-            "let lastAutoSync=0;"
-
-            "async function syncClock(){"
-              "const epoch=Math.floor(Date.now()/1000);"
-              "const browserIANA=Intl.DateTimeFormat().resolvedOptions().timeZone;"
-              "const posix=tzMap[browserIANA]||'UTC0';"
-              "await fetch('/api/sync_clock?epoch='+epoch+'&tz='+encodeURIComponent(posix));"
-              "await refreshStatus();"
-            "}"
-
-            "async function refreshStatus(){"
-              "try{"
-                "const r=await fetch('/api/status');"
-                "if(!r.ok)return;"
-                "const j=await r.json();"
-                "document.getElementById('uptime').textContent=j.uptime_s+' s';"
-                "document.getElementById('rssi').textContent=j.rssi_dbm+' dBm';"
-                "document.getElementById('heap').textContent=j.heap_free+' B';"
-                "document.getElementById('psram').textContent=j.psram_free+' B';"
-                "document.getElementById('stream_state').textContent=j.stream_on?'ON':'OFF';"
-                "document.getElementById('flash_state').textContent=j.flash_on?'ON':'OFF';"
-                "if(document.body.dataset.tempFormat==='F'){"
-                  "document.getElementById('cpu_temp_display').textContent=j.cpu_temp_f.toFixed(1)+' °F';"
-                "}else{"
-                  "document.getElementById('cpu_temp_display').textContent=j.cpu_temp_c.toFixed(1)+' °C';"
-                "}"
-                "fetch('/ccd_raw').then(r=>r.text()).then(val=>{"
-                  "const el=document.getElementById('ccd_raw');"
-                  "if(el)el.textContent=val;"
-                "}).catch(()=>{});"
-            "if(j.esp_time!==undefined){"
-              "const espDate=new Date(j.esp_time*1000);"
-              "const browserDate=new Date();"
-              "document.getElementById('esp_time_display').textContent=espDate.toLocaleString();"
-              "document.getElementById('browser_time').textContent=browserDate.toLocaleString();"
-              "const delta=(Date.now()/1000 - j.esp_time);"
-              "document.getElementById('time_delta').textContent=delta.toFixed(1)+' s';"
-              "document.getElementById('cur_time').textContent=espDate.toLocaleString();"
-
-              // ---- Auto clock sync logic ----
-              "const absDelta=Math.abs(delta);"
-              "const nowMs=Date.now();"
-              // Only auto-sync if drift is > 2s and we haven't auto-synced recently
-              "if(absDelta>2){"
-                "if(nowMs - lastAutoSync > 60000){"  // 60s cooldown
-                  "lastAutoSync=nowMs;"
-                  "syncClock();"
-                "}"
-              "}"
-            "}"
-              "}catch(e){}"
-            "}"
-
-            "function refreshSnap(){"
-              "const img=document.getElementById('snap');"
-              "if(!img)return;"
-              "img.src='/snapshot.jpg?ts='+Date.now();"
-            "}"
-
-            "async function loadSettings(){"
-              "try{"
-                "const r=await fetch('/api/get_settings');"
-                "if(!r.ok)return;"
-                "const j=await r.json();"
-                "document.getElementById('tz_display').textContent=j.timezone||'UTC0';"
-                "if(j.temp_format==='F'){"
-                  "document.body.dataset.tempFormat='F';"
-                  "document.getElementById('temp_mode_display').textContent='Fahrenheit';"
-                "}else{"
-                  "document.body.dataset.tempFormat='C';"
-                  "document.getElementById('temp_mode_display').textContent='Celsius';"
-                "}"
-                "document.getElementById('stream_default_display').textContent=j.stream_on?'ON':'OFF';"
-              "}catch(e){}"
-            "}"
-
-            "async function setBrowserTZ(){"
-              "const browserIANA=Intl.DateTimeFormat().resolvedOptions().timeZone;"
-              "const posix=tzMap[browserIANA]||'UTC0';"
-              "await fetch('/api/set_tz?tz='+encodeURIComponent(posix));"
-              "await loadSettings();"
-            "}"
-
-            "async function toggleTempMode(){"
-              "await fetch('/toggle_temp');"
-              "await loadSettings();"
-              "await refreshStatus();"
-            "}"
-
-            "async function toggleStreamDefault(){"
-              "await fetch('/api/toggle_stream_default');"
-              "await loadSettings();"
-            "}"
-
-            "async function loadCameraControls(){"
-              "try{"
-                "const r=await fetch('/api/cam_settings');"
-                "if(!r.ok)return;"
-                "const s=await r.json();"
-                "let html='';"
-
-                "function addSlider(name,label,min,max){"
-                  "html+='<div class=\"label\">'+label+'</div>';"
-                  "html+='<input type=\"range\" min=\"'+min+'\" max=\"'+max+'\" value=\"'+s[name]+'\" id=\"ctl_'+name+'\">';"
-                "}"
-
-                "function addToggle(name,label){"
-                  "const checked=s[name]?'checked':'';"
-                  "html+='<div class=\"label\">'+label+'</div>';"
-                  "html+='<input type=\"checkbox\" id=\"ctl_'+name+'\" '+checked+'>';"
-                "}"
-
-                // Exposure
-                "html+='<div class=\"cam-group-title\">Exposure</div>';"
-                "addSlider('ae_level','AE level',-2,2);"
-                "addSlider('aec_value','AEC value',0,1200);"
-                "addSlider('agc_gain','AGC gain',0,30);"
-                "addToggle('aec2','AEC2');"
-
-                // Color
-                "html+='<div class=\"cam-group-title\">Color</div>';"
-                "addSlider('brightness','Brightness',-2,2);"
-                "addSlider('contrast','Contrast',-2,2);"
-                "addSlider('saturation','Saturation',-2,2);"
-                "addSlider('denoise','Denoise',0,8);"
-                "addToggle('awb','AWB');"
-                "addToggle('awb_gain','AWB gain');"
-
-                // Geometry
-                "html+='<div class=\"cam-group-title\">Geometry</div>';"
-                "addToggle('hmirror','Horizontal mirror');"
-                "addToggle('vflip','Vertical flip');"
-
-                // Quality
-                "html+='<div class=\"cam-group-title\">Quality</div>';"
-                "addSlider('sharpness','Sharpness',-3,3);"
-                "addSlider('quality','JPEG quality',5,63);"
-                "html+='<div class=\"label\">Framesize</div>';"
-                "html+='<select id=\"ctl_framesize\">';"
-                "const fsOptions=[0,1,2,3,4,5,6,7,8,9];"  // 5=QVGA / 8=VGA / 9=SVGA 
-                "for(let i=0;i<fsOptions.length;i++){"
-                  "const f=fsOptions[i];"
-                  "const sel=(s.framesize==f)?' selected':'';"
-                  "html+='<option value=\"'+f+'\"'+sel+'>'+f+'</option>';"
-                "}"
-                "html+='</select>';"
-
-                "document.getElementById('cam_ctrls').innerHTML=html;"
-              "}catch(e){console.log('cam ctrl error',e);}"
-            "}"
-
-            "async function applyCameraSettings(){"
-              "let payload={};"
-              "function grab(n){"
-                 "let el=document.getElementById('ctl_'+n);"
-                 "if(!el)return;"
-                 "payload[n]=(el.type==='checkbox')?(el.checked?1:0):parseInt(el.value);"
-              "}"
-              "grab('brightness');"
-              "grab('contrast');"
-              "grab('saturation');"
-              "grab('sharpness');"
-              "grab('denoise');"
-              "grab('ae_level');"
-              "grab('aec_value');"
-              "grab('agc_gain');"
-              "grab('aec2');"
-              "grab('awb');"
-              "grab('awb_gain');"
-              "grab('hmirror');"
-              "grab('vflip');"
-              "grab('quality');"
-              "let fs=document.getElementById('ctl_framesize');"
-              "payload['framesize']=parseInt(fs.value);"
-              "await fetch('/api/set_cam_params',{"
-                "method:'POST',"
-                "headers:{'Content-Type':'application/json'},"
-                "body:JSON.stringify(payload)"
-              "});"
-              "loadCameraControls();"
-            "}"
-
-            "async function setCamParam(param,value){"
-              "await fetch('/api/set_cam_param?param='+param+'&value='+value);"
-              "loadCameraControls();"
-            "}"
-
-            "function setFlash(val){"
-              "fetch('/flash?val='+val).then(()=>refreshStatus());"
-            "}"
-            "function startStream(){fetch('/start').then(()=>refreshStatus());}"
-            "function stopStream(){fetch('/stop').then(()=>refreshStatus());}"
-            "window.addEventListener('load',()=>{"
-              "loadSettings();"
-              "refreshStatus();"
-              "refreshSnap();"
-              "loadCameraControls();"
-            "});"
-            "setInterval(refreshStatus,5000);"
-            "setInterval(refreshSnap,3000);"
-            "</script>"
-            "</head><body>");
-
-  html += F("<header><div><h1>ESP32-CAM ");
-  html += DEVICE_NAME;
-  html += F("</h1><span>");
-  html += ip.toString();
-  html += F("</span></div><div><span class='label'>CPU temp: </span><span class='value'>");
-  if (show_fahrenheit) {
-    html += String(cpuF, 1);
-    html += F(" °F");
+static void send_web_asset(const char* type, const uint8_t* gz, size_t len,
+                           const char* etag, const char* cache_control) {
+  ui_load_mark();
+  web.sendHeader("Cache-Control", cache_control);
+  web.sendHeader("ETag", etag);
+  const char* inm = web.headerValue("If-None-Match");
+  if (inm[0] && strstr(inm, etag)) {
+    web.send(304);
   } else {
-    html += String(cpuC, 1);
-    html += F(" °C");
-  }
-  html += F("</span></div></header>");
-
-  html += F("<main><div class='grid'>");
-
-  // System card
-  html += F("<div class='card'><h2>System</h2>");
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Device</div><div class='value'>" DEVICE_NAME "</div></div>"
-      "<div class='col'><div class='label'>IP</div><div class='value'>" + ip.toString() + "</div></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Uptime</div><div class='value' id='uptime'>" + String(uptime_s) + " s</div></div>"
-      "<div class='col'><div class='label'>WiFi RSSI</div><div class='value' id='rssi'>" + String(rssi) + " dBm</div></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Heap free</div><div class='value' id='heap'>" + String(heap_free) + " B</div></div>"
-      "<div class='col'><div class='label'>PSRAM free</div><div class='value' id='psram'>" + String(psram_free) + " B</div></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Timezone</div><div class='value' id='tz_display'>--</div></div>"
-      "<div class='col'><button onclick='setBrowserTZ()'>Use Browser Timezone</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>ESP32 Time</div><div class='value' id='esp_time_display'>" + String(time_buf) + "</div></div>"
-      "<div class='col'><div class='label'>Browser Time</div><div class='value' id='browser_time'>--</div></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Delta (Browser - ESP32)</div><div class='value' id='time_delta'>--</div></div>"
-      "<div class='col'><div class='label'>Current Time (ESP)</div><div class='value' id='cur_time'>" + String(time_buf) + "</div></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>CPU Temp</div><div class='value' id='cpu_temp_display'>" +
-        (show_fahrenheit ? String(cpuF,1)+" °F" : String(cpuC,1)+" °C") +
-      "</div></div>"
-      "<div class='col'><div class='label'>CCD Raw</div><div class='value' id='ccd_raw'>" + String(read_ov2640_temp_raw()) + "</div></div>"
-    "</div>";
-
-  html +=
-    "<div style='margin-top:6px;'>"
-      "<button onclick='syncClock()'>Sync Clock (with TZ)</button>"
-    "</div>";
-
-  html += F("</div>");
-
-  // Snapshot card
-  html += F("<div class='card'><h2>Snapshot</h2>"
-            "<div class='label'>Preview (QVG-ish)</div>"
-            "<img id='snap' src='/snapshot.jpg' alt='snapshot'>"
-            "</div>");
-
-  // Settings card
-  html += F("<div class='card'><h2>Settings</h2>");
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Temperature Mode</div><div class='value' id='temp_mode_display'>--</div></div>"
-      "<div class='col'><button onclick='toggleTempMode()'>Toggle C/F</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Stream Default</div><div class='value' id='stream_default_display'>--</div></div>"
-      "<div class='col'><button onclick='toggleStreamDefault()'>Toggle Stream Default</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><div class='label'>Stream state</div><div class='value' id='stream_state'>" +
-        String(stream_on ? "ON" : "OFF") + "</div></div>"
-      "<div class='col'><button onclick='applyCamDefaults()'>Reset Cam Defaults</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row' style='margin-top:6px;'>"
-      "<div class='col'><button onclick='startStream()'>Start Stream</button></div>"
-      "<div class='col'><button onclick='stopStream()'>Stop Stream</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><button onclick='setFlash(0)'>Flash Off</button></div>"
-      "<div class='col'><button onclick='setFlash(64)'>Flash Low</button></div>"
-    "</div>";
-
-  html +=
-    "<div class='row'>"
-      "<div class='col'><button onclick='setFlash(255)'>Flash High</button></div>"
-      "<div class='col'></div>"
-    "</div>";
-
-  html += F("</div>"); // end Settings card
-
-  // Camera Controls card
-  html += F("<div class='card cam-card'><h2>Camera Controls</h2>"
-            "<div id='cam_ctrls'></div>"
-            "<div class='cam-footer'>"
-              "<button onclick='applyCameraSettings()'>Apply Camera Settings</button>"
-            "</div>"
-            "</div>");
-
-  html += F("</div>");
-
-  html += F("<div class='card' style='margin-top:12px;'>"
-            "<h2>API</h2>"
-            "<div class='label'>Status JSON</div>"
-            "<div class='value'><code>GET /api/status</code></div>"
-            "<div class='label'>Snapshot</div>"
-            "<div class='value'><code>GET /snapshot.jpg</code></div>"
-            "<div class='label'>Control</div>"
-            "<div class='value'><code>GET /api/start</code>, <code>/api/stop</code>, "
-            "<code>/api/flash?val=0-255</code></div>"
-            "<div class='label'>Time/Timezone</div>"
-            "<div class='value'><code>POST /api/set_tz?tz=...</code>, "
-            "<code>POST /api/sync_clock?epoch=...&tz=...</code></div>"
-            "</div>");
-
-  html += F("</main></body></html>");
-
-  web.send(200, "text/html", html);
+    web.sendHeader("Content-Encoding", "gzip");
+    web.send_P(200, type, (const char*)gz, len);
+  }
+  ui_load_sample();
+}
+
+static void handle_root() {
+  // The page itself is always revalidated; its CSS/JS references carry a
+  // version so those can be cached for good.
+  send_web_asset("text/html", WEB_INDEX_GZ, WEB_INDEX_GZ_LEN, WEB_INDEX_ETAG, "no-cache");
+}
+
+static void handle_app_css() {
+  send_web_asset("text/css", WEB_APP_CSS_GZ, WEB_APP_CSS_GZ_LEN, WEB_APP_CSS_ETAG,
+                 "public, max-age=31536000, immutable");
+}
+
+static void handle_app_js() {
+  send_web_asset("application/javascript", WEB_APP_JS_GZ, WEB_APP_JS_GZ_LEN, WEB_APP_JS_ETAG,
+                 "public, max-age=31536000, immutable");
 }
 
 // /ccd_raw – expose raw OV2640 temperature register
@@ -853,27 +1549,185 @@ static void handle_ccd_raw() {
   web.send(200, "text/plain", String(val));
 }
 
-// /snapshot.jpg (single frame)
-static void handle_snapshot() {
-  camera_fb_t* fb = esp_camera_fb_get();
-  if (!fb) {
+static void snapshot_unpin(const uint8_t* data) {
+  snapshot_cache.unpin(data);
+}
+
+// /snapshot.jpg requests waiting for the capture task, answered by
+// snapshot_service() from the control loop
+struct ParkedSnapshot {
+  HttpServerLite::Ticket ticket;
+  uint32_t since_ms;
+};
+static ParkedSnapshot snapshot_parked[SNAPSHOT_PARKED_MAX];
+
+// Copies the latest ring frame into the cache if it is recent enough.
+static bool snapshot_refresh() {
+  CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+  if (!frame || millis() - frame.stampMs() > SNAPSHOT_MAX_AGE_MS) return false;
+  if (frame.seq() != snapshot_cache.seq()) {
+    snapshot_cache.store(frame->buf, frame->len, frame.seq(), frame.stampMs());
+  }
+  return true;
+}
+
+// Answers the current request from the snapshot cache
+static void snapshot_reply() {
+  // Without a new frame an old one (with an honest age header) beats a 503
+  if (!snapshot_cache.length()) {
     web.send(503, "text/plain", "Camera busy");
     return;
   }
-  web.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-  web.sendHeader("Pragma", "no-cache");
-  web.sendHeader("Expires", "0");
-  web.send_P(200, "image/jpeg", (const char*)fb->buf, fb->len);
-  esp_camera_fb_return(fb);
+
+  char etag[24];
+  char age[12];
+  snapshot_cache.etag(etag, sizeof(etag));
+  snprintf(age, sizeof(age), "%lu", (unsigned long)(millis() - snapshot_cache.stampMs()));
+
+  // no-cache = revalidate every time, which is what the ETag is for
+  web.sendHeader("Cache-Control", "no-cache");
+  web.sendHeader("ETag", etag);
+  web.sendHeader("X-Frame-Age-Ms", age);
+
+  if (snapshot_cache.matches(web.header("If-None-Match").c_str())) {
+    snapshot_cache.countNotModified();
+    web.send(304);
+    return;
+  }
+  // Sent from the cache itself; a refresh meanwhile goes to its other buffer
+  web.sendBorrowed(200, "image/jpeg", snapshot_cache.pin(), snapshot_cache.length(), snapshot_unpin);
+}
+
+// /snapshot.jpg (single frame, served from the snapshot cache). Without a
+// recent enough frame the request is parked until the capture task has
+// one; the control task must not wait for it here.
+static void handle_snapshot() {
+  if (snapshot_cache.fresh(millis(), snapshot_max_age_ms)) {
+    snapshot_cache.countHit();
+    snapshot_reply();
+    return;
+  }
+  snapshot_cache.countMiss();
+  capture_touch();
+  if (snapshot_refresh()) {
+    snapshot_reply();
+    return;
+  }
+  capture_kick = true;
+  for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) {
+    ParkedSnapshot& p = snapshot_parked[i];
+    if (p.ticket) continue;
+    p.ticket = web.park();
+    p.since_ms = millis();
+    return;
+  }
+  snapshot_reply();   // all slots taken
+}
+
+// Control loop: answers parked snapshots once a fresh frame is in the
+// ring, or after SNAPSHOT_WAIT_MS with whatever the cache holds.
+static void snapshot_service() {
+  bool waiting = false;
+  for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) waiting = waiting || snapshot_parked[i].ticket;
+  if (!waiting) return;
+
+  capture_touch();
+  bool fresh = snapshot_refresh();
+  if (!fresh) capture_kick = true;
+  uint32_t now = millis();
+  for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) {
+    ParkedSnapshot& p = snapshot_parked[i];
+    if (!p.ticket || (!fresh && now - p.since_ms < SNAPSHOT_WAIT_MS)) continue;
+    web.resume(p.ticket, snapshot_reply);   // false: the client already left
+    p.ticket = 0;
+  }
+}
+
+// The MJPEG stream lives on its own port and task; send browsers there.
+static void handle_stream() {
+  char url[64];
+  snprintf(url, sizeof(url), "http://%s:%d/stream",
+           WiFi.localIP().toString().c_str(), MJPEG_PORT);
+  web.sendHeader("Location", url);
+  web.send(302);
 }
 
 // /api/status JSON
 static void handle_api_status() {
-  char json[256];
+  char json[1280];
   build_status_json(json, sizeof(json));
   web.send(200, "application/json", json);
 }
 
+// =============================================================
+//  STATUS PUSH (/events)
+//  Server-Sent Events for the UI: the full status once on
+//  subscribe, then every STATUS_PUSH_MS only the top-level members
+//  that changed. Nothing is built while nobody is subscribed, and
+//  /api/status polling keeps working for older clients.
+// =============================================================
+static const uint32_t STATUS_PUSH_MS = 1000;
+static const uint32_t CCD_PUSH_MS    = 5000;   // the register read briefly reconfigures the sensor
+static const size_t   PUSH_JSON_MAX  = 1408;
+
+static char     push_prev[PUSH_JSON_MAX];      // what subscribers have, "" when there are none
+static uint32_t push_ms     = 0;
+static uint32_t ccd_push_ms = 0;
+static int      ccd_raw     = 0;
+
+// Status JSON plus the raw CCD temperature register (/ccd_raw)
+static void build_push_json(char* out, size_t out_len) {
+  uint32_t now = millis();
+  if (!ccd_push_ms || now - ccd_push_ms >= CCD_PUSH_MS) {
+    ccd_push_ms = now | 1;
+    ccd_raw = read_ov2640_temp_raw();
+  }
+  build_status_json(out, out_len - 20);
+  size_t n = strlen(out);
+  if (n < 2 || out[n - 1] != '}') return;
+  snprintf(out + n - 1, out_len - (n - 1), ",\"ccd_raw\":%d}", ccd_raw);
+}
+
+static void handle_events() {
+  char json[PUSH_JSON_MAX];
+  build_push_json(json, sizeof(json));
+  if (!web.beginEvents("status", json)) {
+    web.send(503, "text/plain", "Too many event subscribers");
+    return;
+  }
+  // First subscriber: deltas start from this snapshot
+  if (!push_prev[0]) memcpy(push_prev, json, strlen(json) + 1);
+}
+
+// Control task: broadcast what changed since the last push.
+static void status_push_tick() {
+  if (!web.eventClientCount()) {
+    push_prev[0] = '\0';
+    return;
+  }
+  uint32_t now = millis();
+  if (now - push_ms < STATUS_PUSH_MS) return;
+  push_ms = now;
+
+  char cur[PUSH_JSON_MAX];
+  char delta[PUSH_JSON_MAX];
+  build_push_json(cur, sizeof(cur));
+  size_t n = json_delta(push_prev[0] ? push_prev : nullptr, cur, delta, sizeof(delta));
+  if (n > 2) web.broadcast("status", delta);
+  memcpy(push_prev, cur, strlen(cur) + 1);
+}
+
+// Per-stage latency histograms; /api/perf?reset=1 starts a new window
+static void handle_api_perf() {
+  char json[1280];
+  if (!perf_stats().writeJson(json, sizeof(json))) {
+    web.send(500, "application/json", "{\"error\":\"perf report too large\"}");
+    return;
+  }
+  if (web.hasArg("reset")) perf_stats().reset();
+  web.send(200, "application/json", json);
+}
+
 // /sync?epoch=... (legacy/manual)
 static void handle_sync() {
   if (web.hasArg("epoch")) {
@@ -910,56 +1764,342 @@ static void handle_api_flash() {
 }
 
 // =============================================================
-//  CAMERA SETTINGS PERSISTENCE
+//  CONFIG LOAD AND SAVED CAMERA SETTINGS
 // =============================================================
-static void apply_saved_camera_settings() {
-    camPrefs.begin("cam", true);  // read-only
+// Keys written by firmware before the config blob
+static const char* const LEGACY_SETTINGS_KEYS[] = {
+  "timezone", "tempF", "stream_default", "abr", "target_fps", "snap_max_age",
+};
+
+static void config_read_legacy(DeviceConfig& c) {
+  String tz = prefs.getString("timezone", c.timezone);
+  strncpy(c.timezone, tz.c_str(), sizeof(c.timezone) - 1);
+  c.temp_f              = prefs.getBool("tempF", c.temp_f);
+  c.stream_default      = prefs.getBool("stream_default", c.stream_default);
+  c.abr                 = prefs.getBool("abr", c.abr);
+  c.target_fps          = prefs.getUShort("target_fps", c.target_fps);
+  c.snapshot_max_age_ms = prefs.getUInt("snap_max_age", c.snapshot_max_age_ms);
+
+  camPrefs.begin("cam", true);
+  for (int i = 0; i < CP_COUNT; ++i) {
+    if (!camPrefs.isKey(CAM_PARAMS[i].name)) continue;
+    c.cam[i] = (int16_t)camPrefs.getInt(CAM_PARAMS[i].name, 0);
+    c.cam_saved |= 1UL << i;
+  }
+  camPrefs.end();
+}
 
-    sensor_t* s = esp_camera_sensor_get();
-    if (!s) {
-        camPrefs.end();
-        return;
+static void config_drop_legacy() {
+  for (size_t i = 0; i < sizeof(LEGACY_SETTINGS_KEYS) / sizeof(LEGACY_SETTINGS_KEYS[0]); ++i) {
+    if (prefs.isKey(LEGACY_SETTINGS_KEYS[i])) prefs.remove(LEGACY_SETTINGS_KEYS[i]);
+  }
+  camPrefs.begin("cam", false);
+  camPrefs.clear();
+  camPrefs.end();
+}
+
+// One NVS read. Without a blob the per-key settings of older firmware are
+// converted once; a corrupt blob falls back to defaults.
+static void config_load() {
+  config_defaults(config);
+
+  // Slack for a longer blob from newer firmware
+  uint8_t blob[DeviceConfigBlob::SIZE + 64];
+  size_t len = prefs.getBytes("config", blob, sizeof(blob));
+  uint16_t stored = 0;
+  DeviceConfigBlob::Result r = DeviceConfigBlob::unpack(blob, len, CONFIG_VERSION, config, &stored);
+  config.timezone[sizeof(config.timezone) - 1] = '\0';
+
+  switch (r) {
+  case DeviceConfigBlob::OK:
+    break;
+  case DeviceConfigBlob::MIGRATED:
+    Serial.printf("Config v%u migrated to v%u\n", (unsigned)stored, (unsigned)CONFIG_VERSION);
+    config_save();
+    break;
+  case DeviceConfigBlob::MISSING:
+    config_read_legacy(config);
+    if (config_save()) {
+      config_drop_legacy();
+      Serial.println("Config converted from per-key settings.");
+    }
+    break;
+  case DeviceConfigBlob::CORRUPT:
+    config_defaults(config);
+    Serial.println("Config blob corrupt, using defaults.");
+    break;
+  }
+}
+
+// Saved baseline for camera_init_auto(), so the sensor starts there
+static framesize_t config_framesize() {
+  return (config.cam_saved & (1UL << CP_FRAMESIZE)) ? (framesize_t)config.cam[CP_FRAMESIZE] : FRAMESIZE_VGA;
+}
+
+static int config_quality() {
+  return (config.cam_saved & (1UL << CP_QUALITY)) ? config.cam[CP_QUALITY] : 10;
+}
+
+// Only what the sensor doesn't already have after init costs SCCB writes,
+// batched like /api/set_cam_params. Returns how many settings differed.
+static unsigned apply_saved_camera_settings() {
+  sensor_t* s = esp_camera_sensor_get();
+  if (!s) return 0;
+
+  int values[CP_COUNT] = { 0 };
+  uint32_t set = 0;
+  unsigned applied = 0;
+  for (int i = 0; i < CP_COUNT; ++i) {
+    if (!(config.cam_saved & (1UL << i))) continue;
+    values[i] = constrain((int)config.cam[i], (int)CAM_PARAMS[i].min, (int)CAM_PARAMS[i].max);
+    set |= 1UL << i;
+    cam_store.load(i, values[i]);
+    if (cam_param_sensor_value(s, i) != values[i]) applied++;
+  }
+  cam_params_apply(s, values, set);
+  return applied;
+}
+
+// =============================================================
+//  WIFI
+//  Association starts before camera init and setup() waits for
+//  the IP event only once everything else is ready. A boot with
+//  a cached AP skips the scan: WiFi.begin() on its BSSID/channel.
+// =============================================================
+static const EventBits_t WIFI_GOT_IP = BIT0;
+static const EventBits_t WIFI_FAILED = BIT1;   // disconnected before getting an IP
+
+static const uint32_t WIFI_CACHED_TIMEOUT_MS  = 4000;    // then scan for any AP of the SSID
+static const uint32_t WIFI_CONNECT_TIMEOUT_MS = 15000;
+
+static EventGroupHandle_t wifi_events = nullptr;
+static bool wifi_cached = false;                 // joining the cached AP
+static volatile bool wifi_cache_stale = false;   // cached AP gone; control task rescans
+
+// Arduino event task
+static void wifi_event(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+    xEventGroupClearBits(wifi_events, WIFI_FAILED);
+    xEventGroupSetBits(wifi_events, WIFI_GOT_IP);
+    break;
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+    xEventGroupClearBits(wifi_events, WIFI_GOT_IP);
+    xEventGroupSetBits(wifi_events, WIFI_FAILED);
+    // Reconnects stay locked to the cached BSSID otherwise
+    if (wifi_cached && info.wifi_sta_disconnected.reason == WIFI_REASON_NO_AP_FOUND) {
+      wifi_cache_stale = true;
     }
+    break;
+  default:
+    break;
+  }
+}
+
+static bool wifi_start() {
+  wifi_events = xEventGroupCreate();
+  if (!wifi_events) return false;
+  WiFi.onEvent(wifi_event);
+  WiFi.mode(WIFI_STA);
+
+  if (strlen(STA_IP) > 0 && strlen(STA_GATEWAY) > 0 && strlen(STA_SUBNET) > 0) {
+    IPAddress ip, gw, sn, dns;
+    ip.fromString(STA_IP);
+    gw.fromString(STA_GATEWAY);
+    sn.fromString(STA_SUBNET);
+    if (strlen(STA_DNS) > 0) dns.fromString(STA_DNS);
+    else dns = gw;
+
+    if (!WiFi.config(ip, gw, sn, dns)) {
+      Serial.println("Static IP config failed, using DHCP.");
+    } else {
+      Serial.printf("Static IP configured: %s\n", ip.toString().c_str());
+    }
+  }
+
+  wifi_cached = config.wifi_channel != 0;
+  if (wifi_cached) {
+    const uint8_t* b = config.wifi_bssid;
+    Serial.printf("Connecting to WiFi SSID '%s' via %02x:%02x:%02x:%02x:%02x:%02x ch %u...\n",
+                  WIFI_SSID, b[0], b[1], b[2], b[3], b[4], b[5], (unsigned)config.wifi_channel);
+    WiFi.begin(WIFI_SSID, WIFI_PASS, config.wifi_channel, config.wifi_bssid);
+  } else {
+    Serial.printf("Connecting to WiFi SSID '%s'...\n", WIFI_SSID);
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+  }
+  return true;
+}
+
+// Any AP of the SSID, with a full scan
+static void wifi_rescan() {
+  wifi_cached = false;
+  xEventGroupClearBits(wifi_events, WIFI_FAILED);
+  WiFi.disconnect();
+  WiFi.begin(WIFI_SSID, WIFI_PASS);
+}
+
+// Blocks setup() until the IP event; false on timeout.
+static bool wifi_wait() {
+  uint32_t start = millis();
+  if (wifi_cached) {
+    EventBits_t bits = xEventGroupWaitBits(wifi_events, WIFI_GOT_IP | WIFI_FAILED, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(WIFI_CACHED_TIMEOUT_MS));
+    if (bits & WIFI_GOT_IP) return true;
+    Serial.printf("Cached AP not joined after %lu ms, scanning.\n", (unsigned long)(millis() - start));
+    wifi_rescan();
+    start = millis();
+  }
+  EventBits_t bits = xEventGroupWaitBits(wifi_events, WIFI_GOT_IP, pdFALSE, pdTRUE,
+                                         pdMS_TO_TICKS(WIFI_CONNECT_TIMEOUT_MS));
+  return (bits & WIFI_GOT_IP) != 0;
+}
+
+// Cache the AP we ended up on for the next boot
+static void wifi_remember_ap() {
+  const uint8_t* bssid = WiFi.BSSID();
+  int32_t channel = WiFi.channel();
+  if (!bssid || channel <= 0 || channel > 14) return;
+  if (config.wifi_channel == channel && memcmp(config.wifi_bssid, bssid, 6) == 0) return;
+  memcpy(config.wifi_bssid, bssid, 6);
+  config.wifi_channel = (uint8_t)channel;
+  config_save();
+}
+
+// Control task
+static void wifi_service() {
+  if (!wifi_cache_stale) return;
+  wifi_cache_stale = false;
+  if (!wifi_cached) return;
+  log_line("WiFi: cached AP gone, scanning", true);
+  wifi_rescan();
+}
+
+// =============================================================
+//  CONTROL TASK
+//  Web, MQTT, OTA, telemetry and the flash timer, on CONTROL_CORE.
+//  Also the only place stream-side log lines reach Serial/MQTT.
+// =============================================================
+static uint32_t task_stats_ms = 0;
+
+static void control_drain_messages() {
+  ControlMsg msg;
+  while (xQueueReceive(control_msg_q, &msg, 0) == pdTRUE) {
+    if (msg.status) publish_status(msg.text);
+    else            log_line(msg.text, true);
+  }
+}
+
+// CPU share per task over the last TASK_STATS_MS window
+static void control_sample_tasks() {
+  uint32_t now = micros();
+  uint32_t window = now - task_stats_ms;
+  if (window < TASK_STATS_MS * 1000UL) return;
+  task_stats_ms = now;
+  for (int i = 0; i < TASK_COUNT; ++i) {
+    TaskInfo& t = task_info[i];
+    uint32_t busy = t.busy_us;
+    uint32_t delta = busy - t.busy_last_us;
+    t.busy_last_us = busy;
+    uint64_t permille = (uint64_t)delta * 1000 / window;
+    t.cpu_permille = (uint16_t)(permille > 1000 ? 1000 : permille);
+  }
+}
+
+static const uint32_t BOOT_SETTLE_MS = 10000;   // report without a first frame after this
+
+#ifndef MQTT_TOPIC_BOOT
+#define MQTT_TOPIC_BOOT MQTT_TOPIC_BASE "/boot"
+#endif
 
-    // macro to reduce boilerplate
-    auto loadInt = [&](const char* key, int def) {
-        return camPrefs.getInt(key, def);
-    };
+static bool boot_logged = false;
+static bool boot_published = false;
 
-    // Exposure
-    s->set_ae_level(s, loadInt("ae_level",      s->status.ae_level));
-    s->set_aec_value(s, loadInt("aec_value",    s->status.aec_value));
-    s->set_agc_gain(s, loadInt("agc_gain",      s->status.agc_gain));
-    s->set_aec2(s,      loadInt("aec2",         s->status.aec2));
+// Once the first frame is in (or nothing asked for one): the timeline to
+// the log and, retained, to MQTT_TOPIC_BOOT once connected.
+static void control_report_boot() {
+  if (boot_published) return;
+  if (!boot.has(BOOT_FIRST_FRAME) && millis() - boot.at(BOOT_SERVICES) < BOOT_SETTLE_MS) return;
 
-    // Color
-    s->set_brightness(s, loadInt("brightness",  s->status.brightness));
-    s->set_contrast(s,   loadInt("contrast",    s->status.contrast));
-    s->set_saturation(s, loadInt("saturation",  s->status.saturation));
-    s->set_denoise(s,    loadInt("denoise",     s->status.denoise));
-    s->set_whitebal(s,   loadInt("awb",         s->status.awb));
-    s->set_awb_gain(s,   loadInt("awb_gain",    s->status.awb_gain));
+  if (!boot_logged) {
+    boot_logged = true;
+    logf("Boot: WiFi up %lu ms, camera %lu ms, first frame %lu ms, config %lu us",
+         (unsigned long)boot.at(BOOT_WIFI_UP), (unsigned long)boot.at(BOOT_CAMERA),
+         (unsigned long)boot.at(BOOT_FIRST_FRAME), (unsigned long)boot_config_us);
+  }
+  if (!mqtt.connected()) return;
+
+  char marks[192];
+  if (!boot.toJson(marks, sizeof(marks))) return;
+  char json[320];
+  int n = snprintf(json, sizeof(json),
+                   "{\"ms\":%s,\"config_us\":%lu,\"cam_applied\":%u,"
+                   "\"wifi\":{\"cached\":%s,\"channel\":%d}}",
+                   marks, (unsigned long)boot_config_us, boot_cam_applied,
+                   wifi_cached ? "true" : "false", (int)WiFi.channel());
+  if (n <= 0 || n >= (int)sizeof(json)) return;
+  boot_published = mqtt.publish(MQTT_TOPIC_BOOT, (const uint8_t*)json, (unsigned int)n, true);
+}
 
-    // Geometry
-    s->set_hmirror(s, loadInt("hmirror", s->status.hmirror));
-    s->set_vflip(s,   loadInt("vflip",   s->status.vflip));
+static void control_task(void*) {
+  task_stats_ms = micros();
+  for (;;) {
+    uint32_t busy_start = micros();
+    {
+      PERF_SCOPE(PERF_LOOP);
 
-    // Quality
-    s->set_sharpness(s, loadInt("sharpness", s->status.sharpness));
-    s->set_quality(s,   loadInt("quality",   s->status.quality));
+      // OTA
+      if (ota_enabled) {
+          ArduinoOTA.handle();
+      }
+
+      // Web
+      {
+        PERF_SCOPE(PERF_WEB);
+        web.poll();
+        ui_load_sample();
+        snapshot_service();
+        status_push_tick();
+      }
 
-    int fs = loadInt("framesize", s->status.framesize);
-    s->set_framesize(s, (framesize_t)fs);
+      // MQTT: connection state machine, then client traffic
+      {
+        PERF_SCOPE(PERF_MQTT);
+        mqtt_service();
+      }
 
-    camPrefs.end();
+      control_drain_messages();
+      cam_store_flush(false);
+      wifi_service();
+      control_report_boot();
+      {
+        PERF_SCOPE(PERF_OUTBOX);
+        outbox.flush(mqtt.connected(), millis(), outbox_publish);
+      }
+
+      // Telemetry
+      if (millis() - last_telem_ms >= TELEMETRY_INTERVAL_MS) {
+        publish_telemetry();
+        last_telem_ms = millis();
+      }
+
+      // Flash auto-off
+      if (led_active && (millis() - led_on_ms > FLASH_AUTO_OFF_MS)) {
+        set_flash(0);
+        log_line("Flash auto-off after timeout", true);
+      }
+    }
+    task_busy(TASK_CONTROL, busy_start);
+    control_sample_tasks();
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
 }
 
 // =============================================================
 //  SETUP
 // =============================================================
 void setup() {
+  boot.mark(BOOT_SETUP, millis());
   Serial.begin(115200);
-  delay(200);
   publish_verbose("Boot start");
 
   Serial.println();
@@ -974,62 +2114,81 @@ void setup() {
                 ESP.getFreePsram(), ESP.getPsramSize());
 
   // Non-Volatile Settings
+  uint32_t config_start = micros();
   prefs.begin("settings", false);
-  String tz = prefs.getString("timezone", "UTC0");  // default UTC
-  setenv("TZ", tz.c_str(), 1);
+  config_load();
+  setenv("TZ", config.timezone, 1);
   tzset();
-  Serial.printf("Loaded TZ: %s\n", tz.c_str());
 
   // Load UI-related preferences
-  show_fahrenheit   = prefs.getBool("tempF", false);
-  stream_default_on = prefs.getBool("stream_default", true);
-  Serial.printf("Loaded tempF=%s, stream_default=%s\n",
+  show_fahrenheit     = config.temp_f;
+  stream_default_on   = config.stream_default;
+  abr_enabled         = config.abr;
+  target_fps          = config.target_fps;
+  snapshot_max_age_ms = config.snapshot_max_age_ms;
+  boot_config_us      = micros() - config_start;   // before any serial output, which blocks on the UART
+  boot.mark(BOOT_CONFIG, millis());
+  Serial.printf("Loaded TZ: %s\n", config.timezone);
+  Serial.printf("Loaded tempF=%s, stream_default=%s, target_fps=%u\n",
                 show_fahrenheit ? "true" : "false",
-                stream_default_on ? "true" : "false");
+                stream_default_on ? "true" : "false",
+                (unsigned)target_fps);
+
+  // --------------------------------------------------------
+  // WiFi: start associating now, wait for it after the camera
+  // (must be up BEFORE any network servers/OTA)
+  // --------------------------------------------------------
+  if (!wifi_start()) {
+    Serial.println("WiFi event group allocation failed, halting.");
+    while (true) delay(1000);
+  }
+  boot.mark(BOOT_WIFI_START, millis());
 
   // Camera
-  if (!camera_init_auto()) {
+  if (!camera_init_auto(config_framesize(), config_quality())) {
     Serial.println("Camera init failed, halting.");
     while (true) delay(1000);
   }
   Serial.println("Camera initialized.");
-  apply_saved_camera_settings();
-  Serial.println("Loaded saved camera settings.");
-
-  // --------------------------------------------------------
-  // WiFi (must be initialized BEFORE any network servers/OTA)
-  // --------------------------------------------------------
-  WiFi.mode(WIFI_STA);
-
-  if (strlen(STA_IP) > 0 && strlen(STA_GATEWAY) > 0 && strlen(STA_SUBNET) > 0) {
-    IPAddress ip, gw, sn, dns;
-    ip.fromString(STA_IP);
-    gw.fromString(STA_GATEWAY);
-    sn.fromString(STA_SUBNET);
-    if (strlen(STA_DNS) > 0) dns.fromString(STA_DNS);
-    else dns = gw;
+  uint32_t apply_start = micros();
+  boot_cam_applied = apply_saved_camera_settings();
+  if (sensor_t* s = esp_camera_sensor_get()) {
+    abr_set_base(s->status.quality, s->status.framesize);
+  }
+  boot_config_us += micros() - apply_start;
+  boot.mark(BOOT_CAMERA, millis());
+  Serial.printf("Applied %u saved camera settings.\n", boot_cam_applied);
 
-    if (!WiFi.config(ip, gw, sn, dns)) {
-      Serial.println("Static IP config failed, using DHCP.");
-    } else {
-      Serial.printf("Static IP configured: %s\n", ip.toString().c_str());
-    }
+  if (!tasks_create_queues()) {
+    Serial.println("Task queues allocation failed, halting.");
+    while (true) delay(1000);
+  }
+  if (!capture_start()) {
+    Serial.println("Capture task failed to start, halting.");
+    while (true) delay(1000);
   }
 
-  Serial.printf("Connecting to WiFi SSID '%s'...\n", WIFI_SSID);
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
+  // MQTT client; the first connect attempt is the control task's
+  mqtt.setServer(MQTT_SERVER, MQTT_PORT);
+  mqtt.setCallback(mqtt_callback);
+  mqtt.setBufferSize(1536);  // telemetry JSON outgrew the 256-byte default
+  mqtt.setSocketTimeout(MQTT_HANDSHAKE_S);
+  mqtt_link.seed(esp_random());
 
-  uint32_t wifi_start = millis();
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(300);
-    Serial.print('.');
-    if (millis() - wifi_start > 15000) {
-      Serial.println("\nWiFi connect timeout. Rebooting.");
-      ESP.restart();
-    }
+  // LED (flash) PWM
+  ledcSetup(0, 5000, 8);
+  ledcAttachPin(LED_PIN, 0);
+  set_flash(0);
+
+  if (!wifi_wait()) {
+    Serial.println("WiFi connect timeout. Rebooting.");
+    ESP.restart();
   }
-  Serial.printf("\nWiFi connected. IP: %s  RSSI: %d dBm\n",
+  boot.mark(BOOT_WIFI_UP, millis());
+  Serial.printf("WiFi connected in %lu ms. IP: %s  RSSI: %d dBm\n",
+                (unsigned long)(boot.at(BOOT_WIFI_UP) - boot.at(BOOT_WIFI_START)),
                 WiFi.localIP().toString().c_str(), WiFi.RSSI());
+  wifi_remember_ap();
 
   // --------------------------------------------------------
   // Stop SNTP from overwriting manually-set browser time
@@ -1047,39 +2206,17 @@ void setup() {
       configTime(0, 0, "pool.ntp.org", "time.nist.gov");
   }
 
-  // MQTT
-  mqtt.setServer(MQTT_SERVER, MQTT_PORT);
-  mqtt.setCallback(mqtt_callback);
-  mqtt_connect_once();  // one attempt at boot; loop() will retry later
-
-  // LED (flash) PWM
-  ledcSetup(0, 5000, 8);
-  ledcAttachPin(LED_PIN, 0);
-  set_flash(0);
-
   // --------------------------------------------------------
   // RTSP server (MUST come AFTER WiFi + camera are initialized)
   // --------------------------------------------------------
-  rtspServer.transport = RTSPServer::VIDEO_ONLY; // video-only for now
-  rtspServer.rtspPort = RTSP_PORT; // from secrets.h
-  rtspServer.maxRTSPClients = 3; // small, sane default
-
-  // Optional auth if you want it later:
-  // rtspServer.setCredentials("user", "pass");
-
-  bool ok = rtspServer.init(
-  RTSPServer::VIDEO_ONLY, // transport
-  RTSP_PORT, // RTSP port
-  0, // sampleRate (0 = no audio)
-  0, 0, 0, // ports (0 = use defaults from class)
-  IPAddress(), // RTP IP (0 = default)
-  255 // TTL (255 = default per header)
-  );
-
-  if (ok) {
+  rtspServer.begin();
   Serial.printf("RTSP server started on port %d\n", RTSP_PORT);
+
+  if (stream_start()) {
+    Serial.printf("MJPEG stream on port %d\n", MJPEG_PORT);
   } else {
-  Serial.println("ERROR: RTSP server failed to start");
+    Serial.println("Stream task failed to start, halting.");
+    while (true) delay(1000);
   }
 
   // --------------------------------------------------------
@@ -1091,8 +2228,17 @@ void setup() {
   // Web routes
   // --------------------------------------------------------
   web.on("/", HTTP_GET, handle_root);
+  web.on("/app.css", HTTP_GET, handle_app_css);
+  web.on("/app.js", HTTP_GET, handle_app_js);
   web.on("/snapshot.jpg", HTTP_GET, handle_snapshot);
+  web.on("/stream", HTTP_GET, handle_stream);
+
+  // Conditional GETs: snapshot cache and UI assets answer 304
+  static const char* snapshot_headers[] = { "If-None-Match" };
+  web.collectHeaders(snapshot_headers, 1);
   web.on("/api/status", HTTP_GET, handle_api_status);
+  web.on("/api/perf", HTTP_GET, handle_api_perf);
+  web.on("/events", HTTP_GET, handle_events);
 
   web.on("/api/cam_settings", HTTP_GET, []() {
       api_log("API /api/cam_settings called");
@@ -1102,6 +2248,7 @@ void setup() {
           web.send(500, "application/json", "{\"error\":\"no sensor\"}");
           return;
       }
+      StreamState st = stream_state();
 
       char json[640];  // bigger buffer for more fields
 
@@ -1148,8 +2295,8 @@ void setup() {
           s->status.raw_gma,
 
           s->status.gainceiling,
-          s->status.quality,
-          s->status.framesize,
+          (int)st.abr_base_quality,      // user setting, not the adaptive step
+          (int)st.abr_base_framesize,
 
           s->status.hmirror,
           s->status.vflip
@@ -1176,43 +2323,47 @@ void setup() {
       }
 
       sensor_t* s = esp_camera_sensor_get();
-
-      // Apply in safest order
-      if (doc.containsKey("aec2"))      s->set_aec2(s, doc["aec2"]);
-      if (doc.containsKey("awb"))       s->set_whitebal(s, doc["awb"]);
-      if (doc.containsKey("awb_gain"))  s->set_awb_gain(s, doc["awb_gain"]);
-      if (doc.containsKey("agc_gain"))  s->set_agc_gain(s, doc["agc_gain"]);
-      if (doc.containsKey("aec_value")) s->set_aec_value(s, doc["aec_value"]);
-      if (doc.containsKey("ae_level"))  s->set_ae_level(s, doc["ae_level"]);
-      if (doc.containsKey("sharpness")) s->set_sharpness(s, doc["sharpness"]);
-      if (doc.containsKey("denoise"))   s->set_denoise(s, doc["denoise"]);
-      if (doc.containsKey("brightness"))s->set_brightness(s, doc["brightness"]);
-      if (doc.containsKey("contrast"))  s->set_contrast(s, doc["contrast"]);
-      if (doc.containsKey("saturation"))s->set_saturation(s, doc["saturation"]);
-      if (doc.containsKey("hmirror"))   s->set_hmirror(s, doc["hmirror"]);
-      if (doc.containsKey("vflip"))     s->set_vflip(s, doc["vflip"]);
-      if (doc.containsKey("quality"))   s->set_quality(s, doc["quality"]);
-
-      if (doc.containsKey("framesize")) {
-          framesize_t fs = (framesize_t)doc["framesize"].as<int>();
-          s->set_framesize(s, fs);
+      if (!s) {
+          web.send(500, "application/json", "{\"error\":\"no sensor\"}");
+          return;
       }
 
-      // Persist to NVS
-      camPrefs.begin("cam", false);
+      // Unknown keys are ignored
+      int values[CP_COUNT] = { 0 };
+      uint32_t set = 0;
       for (JsonPair kv : doc.as<JsonObject>()) {
-          // only ints are used in this structure
-          camPrefs.putInt(kv.key().c_str(), kv.value().as<int>());
+          const char* key = kv.key().c_str();
+          int id = cam_param_find(key, strlen(key));
+          if (id < 0) continue;
+          values[id] = constrain(kv.value().as<int>(), (int)CAM_PARAMS[id].min, (int)CAM_PARAMS[id].max);
+          set |= 1UL << id;
       }
-      camPrefs.end();
 
-      web.send(200, "application/json", "{\"ok\":true}");
+      CamApplyResult res;
+      {
+          SensorLock lock;
+          res = cam_params_apply(s, values, set);
+      }
+      request_abr_base((set & (1UL << CP_QUALITY))   ? values[CP_QUALITY]   : -1,
+                       (set & (1UL << CP_FRAMESIZE)) ? values[CP_FRAMESIZE] : -1);
+
+      // Queue for saving; only changed keys get written
+      uint32_t now = millis();
+      for (int i = 0; i < CP_COUNT; ++i) {
+          if (set & (1UL << i)) cam_store.set(i, values[i], now);
+      }
+
+      char json[64];
+      snprintf(json, sizeof(json), "{\"ok\":true,\"regs\":%d,\"setters\":%u}",
+               (int)res.regs, (unsigned)res.setters);
+      web.send(200, "application/json", json);
   });
 
   // Apply camera defaults
   web.on("/api/cam_defaults", HTTP_ANY, []() {
       api_log("API /api/cam_defaults called");
       sensor_t* s = esp_camera_sensor_get();
+      SensorLock lock;
       s->set_brightness(s, 0);
       s->set_contrast(s, 0);
       s->set_saturation(s, 0);
@@ -1231,42 +2382,14 @@ void setup() {
       String p = web.arg("param");
       int v = web.arg("value").toInt();
 
-      sensor_t* s = esp_camera_sensor_get();
-      if (!s) {
+      if (!esp_camera_sensor_get()) {
           web.send(500, "application/json", "{\"error\":\"no sensor\"}");
           return;
       }
-
-      bool ok = true;
-
-      if (p == "brightness") s->set_brightness(s, v);
-      else if (p == "contrast") s->set_contrast(s, v);
-      else if (p == "saturation") s->set_saturation(s, v);
-      else if (p == "sharpness") s->set_sharpness(s, v);
-      else if (p == "denoise") s->set_denoise(s, v);
-      else if (p == "ae_level") s->set_ae_level(s, v);
-      else if (p == "agc_gain") s->set_agc_gain(s, v);
-      else if (p == "aec2") s->set_aec2(s, v);
-      else if (p == "aec_value") s->set_aec_value(s, v);
-      else if (p == "awb") s->set_whitebal(s, v);
-      else if (p == "awb_gain") s->set_awb_gain(s, v);
-      else if (p == "hmirror") s->set_hmirror(s, v);
-      else if (p == "vflip") s->set_vflip(s, v);
-      else if (p == "quality") s->set_quality(s, v);
-      else if (p == "gainceiling") s->set_gainceiling(s, (gainceiling_t)v);
-      else if (p == "framesize") s->set_framesize(s, (framesize_t)v);
-      else ok = false;
-
-      if (!ok) {
+      if (!set_cam_param(p.c_str(), p.length(), v)) {
           web.send(400, "application/json", "{\"error\":\"unknown param\"}");
           return;
       }
-
-      // Persist single setting
-      camPrefs.begin("cam", false);
-      camPrefs.putInt(p.c_str(), v);
-      camPrefs.end();
-
       web.send(200, "application/json", "{\"ok\":true}");
   });
 
@@ -1277,7 +2400,7 @@ void setup() {
           return;
       }
       String tz_arg = web.arg("tz");
-      prefs.putString("timezone", tz_arg);
+      config_set_timezone(tz_arg.c_str());
       setenv("TZ", tz_arg.c_str(), 1);
       tzset();
 
@@ -1293,7 +2416,7 @@ void setup() {
       // Apply timezone BEFORE setting the clock, so struct tm always aligns
       if (web.hasArg("tz")) {
           String tz_arg = web.arg("tz");
-          prefs.putString("timezone", tz_arg);
+          config_set_timezone(tz_arg.c_str());
           setenv("TZ", tz_arg.c_str(), 1);
           tzset();
           Serial.printf("TZ updated via /api/sync_clock: %s\n", tz_arg.c_str());
@@ -1315,21 +2438,32 @@ void setup() {
 
   // Return stored settings (timezone, temp format, stream state)
   web.on("/api/get_settings", HTTP_GET, []() {
-      String tz = prefs.getString("timezone", "UTC0");
-
-      char json[128];
+      const SettingsStore<CP_COUNT>::Stats& nvs = cam_store.stats();
+      char json[320];
       snprintf(json, sizeof(json),
-               "{\"timezone\":\"%s\",\"stream_on\":%s,\"temp_format\":\"%c\"}",
-               tz.c_str(),
+               "{\"timezone\":\"%s\",\"stream_on\":%s,\"temp_format\":\"%c\",\"target_fps\":%u,"
+               "\"snapshot_max_age_ms\":%lu,"
+               "\"cam_nvs\":{\"sets\":%lu,\"unchanged\":%lu,\"writes\":%lu,\"commits\":%lu,"
+                 "\"failures\":%lu,\"pending\":%u}}",
+               config.timezone,
                stream_default_on ? "true" : "false",
-               show_fahrenheit ? 'F' : 'C');
+               show_fahrenheit ? 'F' : 'C',
+               (unsigned)target_fps,
+               (unsigned long)snapshot_max_age_ms,
+               (unsigned long)nvs.sets,
+               (unsigned long)nvs.unchanged,
+               (unsigned long)nvs.writes,
+               (unsigned long)nvs.commits,
+               (unsigned long)nvs.failures,
+               cam_store.pending());
 
       web.send(200, "application/json", json);
   });
 
   web.on("/api/toggle_stream_default", HTTP_ANY, []() {
       stream_default_on = !stream_default_on;
-      prefs.putBool("stream_default", stream_default_on);
+      config.stream_default = stream_default_on;
+      config_save();
 
       web.send(200, "application/json",
                stream_default_on
@@ -1337,9 +2471,47 @@ void setup() {
                : "{\"ok\":true,\"stream_on\":false}");
   });
 
+  web.on("/api/toggle_abr", HTTP_ANY, []() {
+      bool enabled = !stream_state().abr_enabled;
+      set_abr(enabled);
+
+      web.send(200, "application/json",
+               enabled
+               ? "{\"ok\":true,\"abr\":true}"
+               : "{\"ok\":true,\"abr\":false}");
+  });
+
+  web.on("/api/set_fps", HTTP_ANY, []() {
+      if (!web.hasArg("fps")) {
+          web.send(400, "application/json", "{\"error\":\"missing fps\"}");
+          return;
+      }
+      set_target_fps(web.arg("fps").toInt());
+
+      char json[48];
+      snprintf(json, sizeof(json), "{\"ok\":true,\"target_fps\":%u}", (unsigned)target_fps);
+      web.send(200, "application/json", json);
+  });
+
+  web.on("/api/set_snapshot_age", HTTP_ANY, []() {
+      if (!web.hasArg("ms")) {
+          web.send(400, "application/json", "{\"error\":\"missing ms\"}");
+          return;
+      }
+      snapshot_max_age_ms = constrain(web.arg("ms").toInt(), 0, (long)SNAPSHOT_CACHE_LIMIT_MS);
+      config.snapshot_max_age_ms = snapshot_max_age_ms;
+      config_save();
+
+      char json[64];
+      snprintf(json, sizeof(json), "{\"ok\":true,\"snapshot_max_age_ms\":%lu}",
+               (unsigned long)snapshot_max_age_ms);
+      web.send(200, "application/json", json);
+  });
+
   web.on("/toggle_temp", HTTP_GET, []() {
       show_fahrenheit = !show_fahrenheit;
-      prefs.putBool("tempF", show_fahrenheit);
+      config.temp_f = show_fahrenheit;
+      config_save();
 
       // Lightweight JSON response so fetch() is happy
       web.send(200, "application/json",
@@ -1376,7 +2548,7 @@ void setup() {
   // Favicon
   web.on("/favicon.ico", HTTP_GET, []() {
       web.sendHeader("Content-Type", "image/png");
-      web.send(200, "image/png", FAVICON_BASE64);
+      web.send_P(200, "image/png", FAVICON_BASE64);
   });
 
   web.onNotFound([]() {
@@ -1389,57 +2561,20 @@ void setup() {
   // Start stream according to stored default once everything is ready
   set_stream(stream_default_on);
 
-  last_telem_ms        = millis();
-  last_mqtt_attempt_ms = millis();
+  last_telem_ms = millis();
+  boot.mark(BOOT_SERVICES, millis());
+
+  // The control plane takes over from the Arduino loop task
+  if (!task_start(TASK_CONTROL, control_task, 8192, 2)) {
+    Serial.println("Control task failed to start, halting.");
+    while (true) delay(1000);
+  }
 }
 
 // =============================================================
 //  LOOP
+//  Everything runs in the tasks started by setup().
 // =============================================================
 void loop() {
-  // OTA
-  if (ota_enabled) {
-      ArduinoOTA.handle();
-  }
-
-  // Web
-  web.handleClient();
-
-  // MQTT: non-blocking, rate-limited reconnect
-  if (mqtt.connected()) {
-    mqtt.loop();
-  } else {
-    uint32_t now = millis();
-    if (now - last_mqtt_attempt_ms > MQTT_RETRY_INTERVAL_MS) {
-      last_mqtt_attempt_ms = now;
-      mqtt_connect_once();
-    }
-  }
-
-  // Telemetry
-  if (millis() - last_telem_ms >= TELEMETRY_INTERVAL_MS) {
-    publish_telemetry();
-    last_telem_ms = millis();
-  }
-
-  // Flash auto-off
-  if (led_active && (millis() - led_on_ms > FLASH_AUTO_OFF_MS)) {
-    set_flash(0);
-    log_line("Flash auto-off after timeout", true);
-  }
-
-  // RTSP handling: send frames when server is ready and streaming is enabled
-  if (stream_on && rtspServer.readyToSendFrame()) {
-    camera_fb_t* fb = esp_camera_fb_get();
-    if (fb) {
-      sensor_t* s = esp_camera_sensor_get();
-      int quality = s ? s->status.quality : 10;  // fall back to something sane
-
-      // Use actual frame dimensions from the sensor
-      rtspServer.sendRTSPFrame(fb->buf, fb->len, quality, fb->width, fb->height);
-
-      esp_camera_fb_return(fb);
-    }
-  }
+  vTaskDelete(nullptr);
 }
-
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Replays a directory of recorded JPEGs as the camera.
+ *
+ * Files (*.jpg / *.jpeg) are loaded into memory in name order and handed
+ * out by esp_camera_fb_get() in a loop at the configured sensor rate, from
+ * a small pool of frame buffers like the driver's fb_count. fb_get blocks
+ * until the next sensor frame is due and returns NULL when every buffer is
+ * still held, which is what the real driver does when consumers are slow.
+ */
+bool   sim_camera_load(const char* dir, unsigned sensor_fps);
+size_t sim_camera_frame_count();
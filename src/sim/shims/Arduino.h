@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-ins for the few Arduino core calls the streaming code uses.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+inline uint64_t sim_now_us() {
+    using namespace std::chrono;
+    static const steady_clock::time_point t0 = steady_clock::now();
+    return (uint64_t)duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+
+inline uint32_t millis() { return (uint32_t)(sim_now_us() / 1000); }
+inline uint32_t micros() { return (uint32_t)sim_now_us(); }
+inline int64_t  esp_timer_get_time() { return (int64_t)sim_now_us(); }
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+template <typename T>
+inline T constrain(T v, T lo, T hi) { return v < lo ? lo : (v > hi ? hi : v); }
@@ -0,0 +1,63 @@
+#pragma once
+
+// NVS stand-in: one "key=value" text file per namespace in the working
+// directory, rewritten on every put like NVS commits.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool read_only = false) {
+        mPath = std::string("nvs_") + name + ".txt";
+        mReadOnly = read_only;
+        mValues.clear();
+        FILE* f = fopen(mPath.c_str(), "r");
+        if (!f) return true;
+        char line[256];
+        while (fgets(line, sizeof(line), f)) {
+            std::string s(line);
+            size_t eq = s.find('=');
+            if (eq == std::string::npos) continue;
+            while (!s.empty() && (s.back() == '\n' || s.back() == '\r')) s.pop_back();
+            mValues[s.substr(0, eq)] = s.substr(eq + 1);
+        }
+        fclose(f);
+        return true;
+    }
+    void end() {}
+
+    bool     getBool(const char* k, bool d = false)          { return has(k) ? atoi(mValues[k].c_str()) != 0 : d; }
+    uint16_t getUShort(const char* k, uint16_t d = 0)        { return has(k) ? (uint16_t)strtoul(mValues[k].c_str(), nullptr, 10) : d; }
+    uint32_t getUInt(const char* k, uint32_t d = 0)          { return has(k) ? (uint32_t)strtoul(mValues[k].c_str(), nullptr, 10) : d; }
+    int32_t  getInt(const char* k, int32_t d = 0)            { return has(k) ? (int32_t)strtol(mValues[k].c_str(), nullptr, 10) : d; }
+
+    size_t putBool(const char* k, bool v)         { return put(k, v ? "1" : "0") ? 1 : 0; }
+    size_t putUShort(const char* k, uint16_t v)   { return put(k, std::to_string(v)) ? 2 : 0; }
+    size_t putUInt(const char* k, uint32_t v)     { return put(k, std::to_string(v)) ? 4 : 0; }
+    size_t putInt(const char* k, int32_t v)       { return put(k, std::to_string(v)) ? 4 : 0; }
+
+    bool isKey(const char* k) { return has(k); }
+
+private:
+    bool has(const char* k) const { return mValues.count(k) != 0; }
+
+    bool put(const char* k, const std::string& v) {
+        if (mReadOnly) return false;
+        mValues[k] = v;
+        FILE* f = fopen(mPath.c_str(), "w");
+        if (!f) return false;
+        for (std::map<std::string, std::string>::const_iterator it = mValues.begin(); it != mValues.end(); ++it) {
+            fprintf(f, "%s=%s\n", it->first.c_str(), it->second.c_str());
+        }
+        fclose(f);
+        return true;
+    }
+
+    std::string mPath;
+    bool        mReadOnly = false;
+    std::map<std::string, std::string> mValues;
+};
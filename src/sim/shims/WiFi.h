@@ -0,0 +1,100 @@
+#pragma once
+
+// WiFiClient / WiFiServer over plain POSIX sockets, enough for the
+// non-blocking servers (RtspServerLite, MjpegServer), which only use the
+// client's fd and do their own send()/recv().
+
+#include "Arduino.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+
+class IPAddress {
+public:
+    IPAddress() : mAddr(0) {}
+    explicit IPAddress(uint32_t host_order) : mAddr(host_order) {}
+    uint8_t operator[](int i) const { return (uint8_t)(mAddr >> (24 - 8 * i)); }
+private:
+    uint32_t mAddr;
+};
+
+class WiFiClient {
+public:
+    WiFiClient() {}
+    explicit WiFiClient(int fd) : mFd(std::make_shared<Fd>(fd)) {}
+
+    int  fd() const { return mFd ? mFd->fd : -1; }
+    explicit operator bool() const { return (bool)mFd; }
+    void stop() { mFd.reset(); }
+
+    void setNoDelay(bool on) {
+        int v = on ? 1 : 0;
+        ::setsockopt(fd(), IPPROTO_TCP, TCP_NODELAY, &v, sizeof(v));
+    }
+
+    IPAddress localIP() const {
+        sockaddr_in a;
+        socklen_t len = sizeof(a);
+        if (::getsockname(fd(), (sockaddr*)&a, &len) < 0) return IPAddress();
+        return IPAddress(ntohl(a.sin_addr.s_addr));
+    }
+
+private:
+    // Shared like the ESP32 WiFiClient: copies refer to one socket, the
+    // last one closes it.
+    struct Fd {
+        int fd;
+        explicit Fd(int f) : fd(f) {}
+        ~Fd() { if (fd >= 0) ::close(fd); }
+    };
+    std::shared_ptr<Fd> mFd;
+};
+
+class WiFiServer {
+public:
+    explicit WiFiServer(int port) : mPort(port), mFd(-1) {}
+    ~WiFiServer() { if (mFd >= 0) ::close(mFd); }
+
+    void begin() {
+        mFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (mFd < 0) return;
+        int one = 1;
+        ::setsockopt(mFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in a;
+        memset(&a, 0, sizeof(a));
+        a.sin_family      = AF_INET;
+        a.sin_port        = htons((uint16_t)mPort);
+        a.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (::bind(mFd, (sockaddr*)&a, sizeof(a)) < 0 || ::listen(mFd, 4) < 0) {
+            perror("WiFiServer");
+            ::close(mFd);
+            mFd = -1;
+            return;
+        }
+        ::fcntl(mFd, F_SETFL, ::fcntl(mFd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    void setNoDelay(bool) {}
+
+    // Accepted sockets are non-blocking, like lwip's with MSG_DONTWAIT, and
+    // get lwip's default send buffer (TCP_SND_BUF), so a slow reader stalls
+    // the sender as soon as it would on the device.
+    WiFiClient available() {
+        if (mFd < 0) return WiFiClient();
+        int c = ::accept(mFd, nullptr, nullptr);
+        if (c < 0) return WiFiClient();
+        ::fcntl(c, F_SETFL, ::fcntl(c, F_GETFL, 0) | O_NONBLOCK);
+        int sndbuf = 5744;
+        ::setsockopt(c, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        return WiFiClient(c);
+    }
+
+private:
+    int mPort;
+    int mFd;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Host subset of esp32-camera's API, backed by SimCamera (recorded JPEGs).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef enum {
+    PIXFORMAT_JPEG = 4,
+} pixformat_t;
+
+typedef enum {
+    FRAMESIZE_QVGA = 5,
+    FRAMESIZE_VGA  = 8,
+    FRAMESIZE_SVGA = 9,
+    FRAMESIZE_XGA  = 10,
+    FRAMESIZE_HD   = 11,
+    FRAMESIZE_SXGA = 12,
+    FRAMESIZE_UXGA = 13,
+} framesize_t;
+
+typedef struct {
+    uint8_t*       buf;
+    size_t         len;
+    size_t         width;
+    size_t         height;
+    pixformat_t    format;
+    struct timeval timestamp;
+} camera_fb_t;
+
+typedef struct {
+    framesize_t framesize;
+    int         quality;
+} camera_status_t;
+
+// Quality/framesize are recorded but can't change recorded JPEGs.
+typedef struct _sensor sensor_t;
+struct _sensor {
+    camera_status_t status;
+    int (*set_quality)(sensor_t*, int);
+    int (*set_framesize)(sensor_t*, framesize_t);
+};
+
+camera_fb_t* esp_camera_fb_get();
+void         esp_camera_fb_return(camera_fb_t* fb);
+sensor_t*    esp_camera_sensor_get();
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the Arduino core's pgmspace.h: flash is ordinary memory.
+
+#define PROGMEM
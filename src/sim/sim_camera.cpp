@@ -0,0 +1,136 @@
+#include "SimCamera.h"
+#include "esp_camera.h"
+#include "Arduino.h"
+
+#include <dirent.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const int      SIM_FB_COUNT      = 3;
+static const uint32_t SIM_FB_TIMEOUT_MS = 1000;   // driver gives up after a while too
+
+static std::vector<std::vector<uint8_t> > sim_frames;
+static uint64_t    sim_interval_us = 0;
+static uint64_t    sim_next_us     = 0;
+static size_t      sim_index       = 0;
+static camera_fb_t sim_fbs[SIM_FB_COUNT];
+static bool        sim_fb_busy[SIM_FB_COUNT];
+static std::mutex  sim_lock;
+
+static int sim_set_quality(sensor_t* s, int q) {
+    s->status.quality = q;
+    return 0;
+}
+
+static int sim_set_framesize(sensor_t* s, framesize_t fs) {
+    s->status.framesize = fs;
+    return 0;
+}
+
+static sensor_t sim_sensor = { { FRAMESIZE_VGA, 10 }, sim_set_quality, sim_set_framesize };
+
+static bool has_jpeg_ext(const std::string& name) {
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "jpg" || ext == "jpeg";
+}
+
+// SOF0/SOF1 dimensions, 0x0 if not found
+static void jpeg_size(const std::vector<uint8_t>& j, size_t& w, size_t& h) {
+    w = h = 0;
+    for (size_t i = 2; i + 9 < j.size(); ) {
+        if (j[i] != 0xFF) return;
+        uint8_t m = j[i + 1];
+        size_t seg = ((size_t)j[i + 2] << 8) | j[i + 3];
+        if (m == 0xC0 || m == 0xC1) {
+            h = ((size_t)j[i + 5] << 8) | j[i + 6];
+            w = ((size_t)j[i + 7] << 8) | j[i + 8];
+            return;
+        }
+        if (m == 0xDA) return;
+        i += 2 + seg;
+    }
+}
+
+bool sim_camera_load(const char* dir, unsigned sensor_fps) {
+    DIR* d = opendir(dir);
+    if (!d) {
+        perror(dir);
+        return false;
+    }
+    std::vector<std::string> names;
+    while (dirent* e = readdir(d)) {
+        if (has_jpeg_ext(e->d_name)) names.push_back(e->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        std::string path = std::string(dir) + "/" + names[i];
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) continue;
+        std::vector<uint8_t> data;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+        fclose(f);
+        if (data.size() > 4 && data[0] == 0xFF && data[1] == 0xD8) sim_frames.push_back(data);
+    }
+    sim_interval_us = sensor_fps ? 1000000ULL / sensor_fps : 0;
+    return !sim_frames.empty();
+}
+
+size_t sim_camera_frame_count() {
+    return sim_frames.size();
+}
+
+camera_fb_t* esp_camera_fb_get() {
+    if (sim_frames.empty()) return nullptr;
+
+    // Wait for the sensor's next frame
+    uint64_t now = sim_now_us();
+    if (sim_next_us > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(sim_next_us - now));
+        now = sim_next_us;
+    }
+    sim_next_us = (sim_next_us + sim_interval_us > now) ? sim_next_us + sim_interval_us
+                                                        : now + sim_interval_us;
+
+    uint32_t start = millis();
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> g(sim_lock);
+            for (int i = 0; i < SIM_FB_COUNT; ++i) {
+                if (sim_fb_busy[i]) continue;
+                const std::vector<uint8_t>& j = sim_frames[sim_index];
+                sim_index = (sim_index + 1) % sim_frames.size();
+
+                camera_fb_t& fb = sim_fbs[i];
+                fb.buf    = const_cast<uint8_t*>(j.data());
+                fb.len    = j.size();
+                fb.format = PIXFORMAT_JPEG;
+                jpeg_size(j, fb.width, fb.height);
+                gettimeofday(&fb.timestamp, nullptr);
+                sim_fb_busy[i] = true;
+                return &fb;
+            }
+        }
+        if (millis() - start >= SIM_FB_TIMEOUT_MS) return nullptr;
+        delay(1);
+    }
+}
+
+void esp_camera_fb_return(camera_fb_t* fb) {
+    std::lock_guard<std::mutex> g(sim_lock);
+    for (int i = 0; i < SIM_FB_COUNT; ++i) {
+        if (fb == &sim_fbs[i]) sim_fb_busy[i] = false;
+    }
+}
+
+sensor_t* esp_camera_sensor_get() {
+    return &sim_sensor;
+}
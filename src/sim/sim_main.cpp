@@ -0,0 +1,542 @@
+/*
+ * Host simulator for the streaming pipeline (PlatformIO env:native).
+ *
+ * Runs the same capture ring, frame governor, RTSP server, MJPEG server,
+ * snapshot cache and ABR controller as the firmware, with the camera
+ * replaced by a directory of recorded JPEGs and WiFi by POSIX sockets, so
+ * the data path can be profiled and run under sanitizers without hardware.
+ * Telemetry JSON is printed to stdout; with --mqtt-port it is also
+ * published to a broker (e.g. tools/mqtt_standin.py) over the firmware's
+ * MqttConnector, so broker outages can be replayed against the stream.
+ *
+ *   pio run -e native
+ *   .pio/build/native/program --frames <dir> [--sensor-fps 25] [--fps 0]
+ *       [--rtsp-port 8554] [--mjpeg-port 8081] [--http-port 8080]
+ *       [--telemetry-ms 5000] [--rssi -60] [--seconds 0]
+ *       [--mqtt-host 127.0.0.1] [--mqtt-port 0]
+ *
+ * then e.g.  ffplay rtsp://127.0.0.1:8554/mjpeg
+ *            curl -si http://127.0.0.1:8080/snapshot.jpg
+ *            curl -s  http://127.0.0.1:8080/api/perf
+ *            curl -sN http://127.0.0.1:8080/events
+ *            python tools/http_load.py --http-port 8080 --paths /api/status,/snapshot.jpg
+ *            python tools/mqtt_outage.py --mqtt-port 1883   (sim run with --mqtt-port 1883)
+ */
+
+#include "Arduino.h"
+#include "WiFi.h"
+#include "Preferences.h"
+#include "esp_camera.h"
+#include "SimCamera.h"
+
+#include "AdaptiveBitrate.h"
+#include "FrameGovernor.h"
+#include "FrameRing.h"
+#include "HttpServerLite.h"
+#include "JsonDelta.h"
+#include "MjpegServer.h"
+#include "MqttConnector.h"
+#include "PerfProbe.h"
+#include "RtspServerLite.h"
+#include "SnapshotCache.h"
+
+#include <signal.h>
+#include <sys/time.h>
+#include <atomic>
+#include <thread>
+
+// ---- Options ----
+static const char* opt_frames       = nullptr;
+static unsigned    opt_sensor_fps   = 25;
+static int         opt_fps          = -1;        // -1: use the persisted value
+static int         opt_rtsp_port    = 8554;
+static int         opt_mjpeg_port   = 8081;
+static int         opt_http_port    = 8080;
+static uint32_t    opt_telemetry_ms = 5000;
+static int         opt_rssi         = -60;
+static uint32_t    opt_seconds      = 0;         // 0 = until Ctrl-C
+static const char* opt_mqtt_host    = "127.0.0.1";
+static int         opt_mqtt_port    = 0;         // 0 = no MQTT
+
+// ---- Pipeline (mirrors main.cpp) ----
+static void release_camera_fb(camera_fb_t* fb) {
+    esp_camera_fb_return(fb);
+}
+
+typedef FrameRing<camera_fb_t, 4> CameraFrameRing;
+static CameraFrameRing frame_ring(release_camera_fb);
+
+static FrameGovernor         frame_governor;
+static std::atomic<uint16_t> target_fps(0);
+static RtspServerLite*       rtspServer  = nullptr;   // built in main() once ports are known
+static MjpegServer*          mjpegServer = nullptr;
+static std::atomic<int>      mjpeg_viewers(0);        // read by telemetry on the main thread
+static HttpServerLite*       web         = nullptr;
+static SnapshotCache         snapshot_cache;
+static AdaptiveBitrate       abr;
+static Preferences           prefs;
+static std::atomic<bool>     running(true);
+static MqttConnector         mqtt_link;               // --mqtt-port, see mqtt_tick()
+
+static const uint32_t SNAPSHOT_MAX_AGE_MS = 500;
+static const uint32_t SNAPSHOT_WAIT_MS    = 1000;
+static const int      SNAPSHOT_PARKED_MAX = 4;
+static const uint32_t SNAPSHOT_CACHE_MS   = 1000;
+static const uint32_t ABR_SAMPLE_MS       = 250;
+
+static void capture_thread() {
+    while (running) {
+        if (frame_governor.targetFps() != target_fps) frame_governor.setTargetFps(target_fps);
+
+        uint64_t now_us = esp_timer_get_time();
+        if (!frame_governor.due(now_us)) {
+            uint32_t wait_ms = frame_governor.waitUs(now_us) / 1000;
+            delay(wait_ms ? (wait_ms > 20 ? 20 : wait_ms) : 1);
+            continue;
+        }
+        PERF_BEGIN(grab_start);
+        camera_fb_t* fb = esp_camera_fb_get();
+        PERF_END(grab_start, PERF_CAPTURE);
+        if (!fb) {
+            delay(10);
+            continue;
+        }
+        frame_governor.taken(esp_timer_get_time());
+        frame_ring.publish(fb, millis());
+    }
+    frame_ring.clear();
+}
+
+static void mjpeg_thread() {
+    mjpegServer->begin();
+    uint32_t last_seq = 0;
+    while (running) {
+        if (mjpegServer->hasViewers()) {
+            CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+            if (frame && frame.seq() != last_seq) {
+                last_seq = frame.seq();
+                mjpegServer->publish(frame->buf, frame->len, last_seq);
+            }
+        }
+        bool viewing = mjpegServer->hasViewers();
+        PERF_BEGIN(poll_start);
+        mjpegServer->poll();
+        if (viewing) PERF_END(poll_start, PERF_MJPEG);
+        mjpeg_viewers = mjpegServer->viewerCount();
+        delay(mjpegServer->hasViewers() ? 5 : 20);
+    }
+}
+
+static void build_status_json(char* out, size_t out_len) {
+    const FrameGovernor::Stats& fs = frame_governor.stats();
+    const RtpFanout& fo = rtspServer->fanout();
+    const RtpPacketPool::Stats& pool = fo.poolStats();
+    snprintf(out, out_len,
+        "{\"uptime_ms\":%u,\"rtsp_sessions\":%d,\"mjpeg_clients\":%d,"
+        "\"http\":{\"clients\":%d,\"requests\":%u,\"timeouts\":%u,\"rejected\":%u,"
+        "\"subscribers\":%d,\"event_drops\":%u},"
+        "\"ring\":{\"published\":%u,\"dropped\":%u},"
+        "\"rtp\":{\"published\":%u,\"failed\":%u,\"sent\":%u,\"dropped\":%u,\"packets_last\":%u,"
+        "\"hdr_hits\":%u,\"hdr_misses\":%u},"
+        "\"rtp_pool\":{\"slots\":%u,\"in_use\":%u,\"high_water\":%u,\"frames_hw\":%u,\"exhausted\":%u},"
+        "\"fps\":{\"target\":%u,\"actual\":%.2f,\"min_ms\":%.1f,\"avg_ms\":%.1f,\"max_ms\":%.1f},"
+        "\"snapshot\":{\"hits\":%u,\"misses\":%u,\"not_modified\":%u},"
+        "\"abr\":{\"level\":%d,\"quality\":%d,\"framesize\":%d,\"reason\":\"%s\"},"
+        "\"mqtt\":{\"state\":\"%s\",\"attempts\":%u,\"connects\":%u,\"retry_ms\":%u}}",
+        millis(), rtspServer->sessionCount(), mjpeg_viewers.load(),
+        web->clientCount(), web->requests(), web->timeouts(), web->rejected(),
+        web->eventClientCount(), web->eventDrops(),
+        (unsigned)frame_ring.published(), (unsigned)frame_ring.dropped(),
+        fo.framesPublished(), fo.framesFailed(), fo.framesSent(), fo.framesDropped(),
+        (unsigned)fo.lastPacketCount(), fo.scanner().hits(), fo.scanner().misses(),
+        (unsigned)(pool.internal_slots + pool.psram_slots), (unsigned)pool.in_use,
+        (unsigned)pool.high_water, (unsigned)pool.frames_high_water, pool.exhausted,
+        (unsigned)target_fps.load(), frame_governor.actualFpsX100() / 100.0f,
+        fs.min_us / 1000.0f, fs.avg_us / 1000.0f, fs.max_us / 1000.0f,
+        snapshot_cache.hits(), snapshot_cache.misses(), snapshot_cache.notModified(),
+        abr.level(), abr.quality(), abr.framesize(), AdaptiveBitrate::reasonName(abr.reason()),
+        MqttConnector::stateName(mqtt_link.state()), mqtt_link.attempts(), mqtt_link.connects(),
+        mqtt_link.retryInMs(millis()));
+}
+
+// ---- HTTP (/snapshot.jpg, /api/status, /api/perf) on the firmware's server ----
+static void snapshot_unpin(const uint8_t* data) {
+    snapshot_cache.unpin(data);
+}
+
+// Same policy as handle_snapshot(): requests without a recent enough
+// frame are parked and answered by snapshot_service()
+struct ParkedSnapshot {
+    HttpServerLite::Ticket ticket;
+    uint32_t               since_ms;
+};
+static ParkedSnapshot snapshot_parked[SNAPSHOT_PARKED_MAX];
+
+static bool snapshot_refresh() {
+    CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+    if (!frame || millis() - frame.stampMs() > SNAPSHOT_MAX_AGE_MS) return false;
+    if (frame.seq() != snapshot_cache.seq()) {
+        snapshot_cache.store(frame->buf, frame->len, frame.seq(), frame.stampMs());
+    }
+    return true;
+}
+
+static void snapshot_reply() {
+    if (!snapshot_cache.length()) {
+        web->send(503, "text/plain", "Camera busy");
+        return;
+    }
+
+    char etag[24];
+    char age[12];
+    snapshot_cache.etag(etag, sizeof(etag));
+    snprintf(age, sizeof(age), "%u", millis() - snapshot_cache.stampMs());
+    web->sendHeader("Cache-Control", "no-cache");
+    web->sendHeader("ETag", etag);
+    web->sendHeader("X-Frame-Age-Ms", age);
+    if (snapshot_cache.matches(web->headerValue("If-None-Match"))) {
+        snapshot_cache.countNotModified();
+        web->send(304);
+        return;
+    }
+    web->sendBorrowed(200, "image/jpeg", snapshot_cache.pin(), snapshot_cache.length(), snapshot_unpin);
+}
+
+static void handle_snapshot() {
+    if (snapshot_cache.fresh(millis(), SNAPSHOT_CACHE_MS)) {
+        snapshot_cache.countHit();
+        snapshot_reply();
+        return;
+    }
+    snapshot_cache.countMiss();
+    if (snapshot_refresh()) {
+        snapshot_reply();
+        return;
+    }
+    for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) {
+        ParkedSnapshot& p = snapshot_parked[i];
+        if (p.ticket) continue;
+        p.ticket   = web->park();
+        p.since_ms = millis();
+        return;
+    }
+    snapshot_reply();
+}
+
+static void snapshot_service() {
+    bool waiting = false;
+    for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) waiting = waiting || snapshot_parked[i].ticket;
+    if (!waiting) return;
+
+    bool fresh = snapshot_refresh();
+    uint32_t now = millis();
+    for (int i = 0; i < SNAPSHOT_PARKED_MAX; ++i) {
+        ParkedSnapshot& p = snapshot_parked[i];
+        if (!p.ticket || (!fresh && now - p.since_ms < SNAPSHOT_WAIT_MS)) continue;
+        web->resume(p.ticket, snapshot_reply);
+        p.ticket = 0;
+    }
+}
+
+static void handle_api_status() {
+    char json[1280];
+    build_status_json(json, sizeof(json));
+    web->send(200, "application/json", json);
+}
+
+static void handle_api_perf() {
+    char json[1280];
+    if (!perf_stats().writeJson(json, sizeof(json))) {
+        web->send(500, "application/json", "{\"error\":\"perf report too large\"}");
+        return;
+    }
+    if (web->hasArg("reset")) perf_stats().reset();
+    web->send(200, "application/json", json);
+}
+
+// Same push policy as the firmware's /events (without the CCD register)
+static const uint32_t STATUS_PUSH_MS = 1000;
+static char     push_prev[1408];
+static uint32_t push_ms = 0;
+
+static void handle_events() {
+    char json[1408];
+    build_status_json(json, sizeof(json));
+    if (!web->beginEvents("status", json)) {
+        web->send(503, "text/plain", "Too many event subscribers");
+        return;
+    }
+    if (!push_prev[0]) memcpy(push_prev, json, strlen(json) + 1);
+}
+
+static void status_push_tick() {
+    if (!web->eventClientCount()) {
+        push_prev[0] = '\0';
+        return;
+    }
+    uint32_t now = millis();
+    if (now - push_ms < STATUS_PUSH_MS) return;
+    push_ms = now;
+    char cur[1408];
+    char delta[1408];
+    build_status_json(cur, sizeof(cur));
+    if (json_delta(push_prev[0] ? push_prev : nullptr, cur, delta, sizeof(delta)) > 2) {
+        web->broadcast("status", delta);
+    }
+    memcpy(push_prev, cur, strlen(cur) + 1);
+}
+
+// ---- MQTT (--mqtt-port) ----
+// MqttConnector as in the firmware; a minimal MQTT 3.1.1 client (CONNECT,
+// CONNACK, QoS 0 PUBLISH) stands in for PubSubClient. Its handshake doesn't
+// block either, so nothing here ever holds up the RTSP push in the same loop.
+static const uint32_t MQTT_HANDSHAKE_MS = 2000;
+static const char*    MQTT_SIM_TOPIC    = "sim/telemetry";
+
+static int      mqtt_fd = -1;
+static uint32_t mqtt_handshake_ms = 0;
+
+static size_t mqtt_header(uint8_t* out, uint8_t type, size_t remaining) {
+    size_t n = 0;
+    out[n++] = type;
+    do {
+        uint8_t b = remaining % 128;
+        remaining /= 128;
+        out[n++] = (uint8_t)(remaining ? (b | 0x80) : b);
+    } while (remaining);
+    return n;
+}
+
+static bool mqtt_send(const uint8_t* p, size_t n) {
+    // A short write means the broker stopped reading: treat as gone
+    return ::send(mqtt_fd, p, n, MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t)n;
+}
+
+static void mqtt_close() {
+    if (mqtt_fd >= 0) ::close(mqtt_fd);
+    mqtt_fd = -1;
+}
+
+static bool mqtt_send_connect() {
+    static const char* id = "esp32_camera_sim";
+    size_t idl = strlen(id);
+    uint8_t pkt[64];
+    size_t n = mqtt_header(pkt, 0x10, 10 + 2 + idl);
+    static const uint8_t var[] = { 0, 4, 'M', 'Q', 'T', 'T', 4, 0x02, 0, 0 };  // clean session, no keepalive
+    memcpy(pkt + n, var, sizeof(var));
+    n += sizeof(var);
+    pkt[n++] = 0;
+    pkt[n++] = (uint8_t)idl;
+    memcpy(pkt + n, id, idl);
+    return mqtt_send(pkt, n + idl);
+}
+
+static void mqtt_publish(const char* payload) {
+    if (mqtt_link.state() != MqttConnector::CONNECTED) return;
+    size_t tl = strlen(MQTT_SIM_TOPIC);
+    size_t pl = strlen(payload);
+    uint8_t pkt[1536];
+    size_t n = mqtt_header(pkt, 0x30, 2 + tl + pl);
+    if (n + 2 + tl + pl > sizeof(pkt)) return;
+    pkt[n++] = (uint8_t)(tl >> 8);
+    pkt[n++] = (uint8_t)tl;
+    memcpy(pkt + n, MQTT_SIM_TOPIC, tl);
+    memcpy(pkt + n + tl, payload, pl);
+    if (!mqtt_send(pkt, n + tl + pl)) {
+        mqtt_close();
+        mqtt_link.lost(millis());
+        printf("mqtt: lost (publish failed), retry in %u ms\n", mqtt_link.retryInMs(millis()));
+    }
+}
+
+static void mqtt_tick() {
+    if (!opt_mqtt_port) return;
+    uint32_t now = millis();
+    uint8_t buf[256];
+    switch (mqtt_link.state()) {
+    case MqttConnector::WAITING:
+        if (mqtt_link.due(now) &&
+            !mqtt_link.begin(inet_addr(opt_mqtt_host), (uint16_t)opt_mqtt_port, now)) {
+            printf("mqtt: %s, retry in %u ms\n", strerror(mqtt_link.lastError()), mqtt_link.retryInMs(now));
+        }
+        break;
+
+    case MqttConnector::CONNECTING: {
+        int fd = mqtt_link.poll(now);
+        if (fd >= 0) {
+            mqtt_fd = fd;
+            mqtt_handshake_ms = now;
+            if (!mqtt_send_connect()) {
+                mqtt_close();
+                mqtt_link.failed(EPIPE, now);
+            }
+        } else if (mqtt_link.state() == MqttConnector::WAITING) {
+            printf("mqtt: connect failed (%s), retry in %u ms\n",
+                   strerror(mqtt_link.lastError()), mqtt_link.retryInMs(now));
+        }
+        break;
+    }
+
+    case MqttConnector::HANDSHAKE: {
+        ssize_t r = ::recv(mqtt_fd, buf, 4, MSG_DONTWAIT | MSG_PEEK);
+        if (r == 4 && buf[0] == 0x20 && buf[3] == 0) {
+            ::recv(mqtt_fd, buf, 4, 0);
+            mqtt_link.established(now);
+            printf("mqtt: connected (attempt %u)\n", mqtt_link.attempts());
+        } else if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) || (r == 4) ||
+                   now - mqtt_handshake_ms >= MQTT_HANDSHAKE_MS) {
+            mqtt_close();
+            mqtt_link.failed(r == 4 ? ECONNREFUSED : ETIMEDOUT, now);
+            printf("mqtt: handshake failed, retry in %u ms\n", mqtt_link.retryInMs(now));
+        }
+        break;
+    }
+
+    case MqttConnector::CONNECTED: {
+        ssize_t r = ::recv(mqtt_fd, buf, sizeof(buf), MSG_DONTWAIT);   // nothing subscribed: discard
+        if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            mqtt_close();
+            mqtt_link.lost(now);
+            printf("mqtt: lost, retry in %u ms\n", mqtt_link.retryInMs(now));
+        }
+        break;
+    }
+    }
+}
+
+static void abr_update(uint32_t now) {
+    const RtpFanout& fo = rtspServer->fanout();
+    AdaptiveBitrate::Sample sample;
+    sample.frames_sent       = fo.framesSent();
+    sample.frames_dropped    = fo.framesDropped();
+    sample.backlog_frames    = fo.maxBacklog();
+    sample.send_ms           = fo.maxSendMs();
+    sample.frame_interval_ms = rtspServer->frameIntervalMs();
+    sample.rssi_dbm          = opt_rssi;
+    if (!abr.update(now, sample)) return;
+
+    sensor_t* s = esp_camera_sensor_get();
+    s->set_quality(s, abr.quality());
+    s->set_framesize(s, (framesize_t)abr.framesize());
+    printf("ABR: level %d quality %d framesize %d (%s)\n", abr.level(), abr.quality(),
+           abr.framesize(), AdaptiveBitrate::reasonName(abr.reason()));
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+static bool parse_args(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* k = argv[i];
+        const char* v = argv[i + 1];
+        if      (!strcmp(k, "--frames"))       opt_frames       = v;
+        else if (!strcmp(k, "--sensor-fps"))   opt_sensor_fps   = (unsigned)atoi(v);
+        else if (!strcmp(k, "--fps"))          opt_fps          = atoi(v);
+        else if (!strcmp(k, "--rtsp-port"))    opt_rtsp_port    = atoi(v);
+        else if (!strcmp(k, "--mjpeg-port"))   opt_mjpeg_port   = atoi(v);
+        else if (!strcmp(k, "--http-port"))    opt_http_port    = atoi(v);
+        else if (!strcmp(k, "--telemetry-ms")) opt_telemetry_ms = (uint32_t)atoi(v);
+        else if (!strcmp(k, "--rssi"))         opt_rssi         = atoi(v);
+        else if (!strcmp(k, "--seconds"))      opt_seconds      = (uint32_t)atoi(v);
+        else if (!strcmp(k, "--mqtt-host"))    opt_mqtt_host    = v;
+        else if (!strcmp(k, "--mqtt-port"))    opt_mqtt_port    = atoi(v);
+        else return false;
+    }
+    return opt_frames != nullptr && (argc % 2) == 1;
+}
+
+int main(int argc, char** argv) {
+    if (!parse_args(argc, argv)) {
+        fprintf(stderr, "usage: %s --frames <dir> [--sensor-fps N] [--fps N] [--rtsp-port P] "
+                        "[--mjpeg-port P] [--http-port P] [--telemetry-ms MS] [--rssi DBM] "
+                        "[--seconds S] [--mqtt-host H] [--mqtt-port P]\n", argv[0]);
+        return 2;
+    }
+    if (!sim_camera_load(opt_frames, opt_sensor_fps)) {
+        fprintf(stderr, "no JPEGs in %s\n", opt_frames);
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    prefs.begin("settings", false);
+    if (opt_fps >= 0) prefs.putUShort("target_fps", (uint16_t)opt_fps);
+    target_fps = prefs.getUShort("target_fps", 0);
+
+    sensor_t* s = esp_camera_sensor_get();
+    abr.setBase(s->status.quality, s->status.framesize);
+
+    RtspServerLite rtsp(opt_rtsp_port, "esp32_camera_sim");
+    MjpegServer mjpeg(opt_mjpeg_port);
+    rtspServer  = &rtsp;
+    mjpegServer = &mjpeg;
+    HttpServerLite http(opt_http_port);
+    web = &http;
+    static const char* snapshot_headers[] = { "If-None-Match" };
+    http.collectHeaders(snapshot_headers, 1);
+    http.on("/snapshot.jpg", HTTP_GET, handle_snapshot);
+    http.on("/api/status", HTTP_GET, handle_api_status);
+    http.on("/api/perf", HTTP_GET, handle_api_perf);
+    http.on("/events", HTTP_GET, handle_events);
+    rtsp.begin();
+    http.begin();
+
+    printf("sim: %zu frames at %u fps sensor, target %u fps; rtsp :%d, mjpeg :%d, http :%d\n",
+           sim_camera_frame_count(), opt_sensor_fps, (unsigned)target_fps.load(),
+           opt_rtsp_port, opt_mjpeg_port, opt_http_port);
+
+    std::thread capture(capture_thread);
+    std::thread mjpeg_task(mjpeg_thread);
+
+    uint32_t rtsp_last_seq = 0, last_abr_ms = 0, last_telem_ms = millis();
+    const uint32_t start_ms = millis();
+    while (running) {
+        rtsp.poll();
+        if (rtsp.hasViewers()) {
+            CameraFrameRing::Ref frame = frame_ring.acquireLatest();
+            if (frame && frame.seq() != rtsp_last_seq) {
+                rtsp_last_seq = frame.seq();
+                sensor_t* s = esp_camera_sensor_get();
+                rtsp.pushFrame(frame->buf, frame->len, frame.stampMs(),
+                               JpegScanner::key(s->status.quality, s->status.framesize));
+            }
+            uint32_t now = millis();
+            if (now - last_abr_ms >= ABR_SAMPLE_MS) {
+                last_abr_ms = now;
+                abr_update(now);
+            }
+        }
+        {
+            PERF_SCOPE(PERF_WEB);
+            http.poll();
+            snapshot_service();
+            status_push_tick();
+        }
+        {
+            PERF_SCOPE(PERF_MQTT);
+            mqtt_tick();
+        }
+
+        uint32_t now = millis();
+        if (opt_telemetry_ms && now - last_telem_ms >= opt_telemetry_ms) {
+            last_telem_ms = now;
+            char json[1024];
+            build_status_json(json, sizeof(json));
+            printf("%s\n", json);
+            fflush(stdout);
+            mqtt_publish(json);
+        }
+        if (opt_seconds && now - start_ms >= opt_seconds * 1000) running = false;
+        delay(1);
+    }
+
+    capture.join();
+    mjpeg_task.join();
+    mqtt_close();
+    rtspServer  = nullptr;
+    mjpegServer = nullptr;
+    web         = nullptr;
+    return 0;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+// Check macros and shared fixtures for the host tests (env:native_test).
+
+#include "Arduino.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+struct TestContext {
+    int checks;
+    int failures;
+    int port_base;      // each test owns port_base .. port_base+9
+};
+
+extern TestContext test_ctx;
+
+#define CHECK(cond) \
+    test_check((cond), __FILE__, __LINE__, #cond)
+
+#define CHECK_EQ(a, b) \
+    test_check_eq((long long)(a), (long long)(b), __FILE__, __LINE__, #a " == " #b)
+
+static inline bool test_check(bool ok, const char* file, int line, const char* what) {
+    test_ctx.checks++;
+    if (!ok) {
+        test_ctx.failures++;
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, what);
+    }
+    return ok;
+}
+
+static inline bool test_check_eq(long long a, long long b, const char* file, int line, const char* what) {
+    test_ctx.checks++;
+    if (a != b) {
+        test_ctx.failures++;
+        fprintf(stderr, "%s:%d: CHECK(%s) failed: %lld vs %lld\n", file, line, what, a, b);
+    }
+    return a == b;
+}
+
+// Baseline 4:2:2 JPEG the packetizer accepts: two quant tables filled from
+// q, SOF0 with the given size, scan_len bytes of scan data (no 0xFF), EOI.
+static inline std::vector<uint8_t> test_jpeg(uint16_t width, uint16_t height, size_t scan_len,
+                                             uint8_t q = 10) {
+    static const uint8_t sof_tail[] = { 0x03, 0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01 };
+    static const uint8_t sos[] = {
+        0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00,
+    };
+    std::vector<uint8_t> j;
+    j.push_back(0xFF); j.push_back(0xD8);
+    for (uint8_t t = 0; t < 2; ++t) {
+        j.push_back(0xFF); j.push_back(0xDB); j.push_back(0x00); j.push_back(0x43);
+        j.push_back(t);
+        for (int i = 0; i < 64; ++i) j.push_back((uint8_t)(q + i + t));
+    }
+    j.push_back(0xFF); j.push_back(0xC0); j.push_back(0x00); j.push_back(0x11);
+    j.push_back(0x08);
+    j.push_back((uint8_t)(height >> 8)); j.push_back((uint8_t)height);
+    j.push_back((uint8_t)(width >> 8));  j.push_back((uint8_t)width);
+    j.insert(j.end(), sof_tail, sof_tail + sizeof(sof_tail));
+    j.insert(j.end(), sos, sos + sizeof(sos));
+    for (size_t i = 0; i < scan_len; ++i) j.push_back((uint8_t)((i * 7 + q) & 0x7F));
+    j.push_back(0xFF); j.push_back(0xD9);
+    return j;
+}
+
+// ---- Loopback sockets ----
+
+static inline void test_set_nonblocking(int fd) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// Connected, non-blocking TCP socket to 127.0.0.1:port, or -1. A non-zero
+// rcvbuf shrinks the receive buffer so a test can stall the sender; a
+// non-zero mss makes the server split each write into several segments,
+// so a full send buffer can cut an RTP packet (loopback's 64 KB segments
+// otherwise make every write all-or-nothing).
+static inline int test_tcp_connect(int port, int rcvbuf = 0, int mss = 0) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (rcvbuf) ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    if (mss)    ::setsockopt(fd, IPPROTO_TCP, TCP_MAXSEG, &mss, sizeof(mss));
+    sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons((uint16_t)port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, (sockaddr*)&a, sizeof(a)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    test_set_nonblocking(fd);
+    return fd;
+}
+
+// Non-blocking UDP socket bound to 127.0.0.1:port, or -1.
+static inline int test_udp_bind(int port) {
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons((uint16_t)port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(fd, (sockaddr*)&a, sizeof(a)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    test_set_nonblocking(fd);
+    return fd;
+}
+
+// Appends whatever is readable (up to max bytes). False once the peer
+// has closed the connection.
+static inline bool test_recv_some(int fd, std::string& in, size_t max = 65536) {
+    char buf[4096];
+    while (max) {
+        ssize_t n = ::recv(fd, buf, max < sizeof(buf) ? max : sizeof(buf), MSG_DONTWAIT);
+        if (n == 0) return false;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        in.append(buf, (size_t)n);
+        max -= (size_t)n;
+    }
+    return true;
+}
+
+static inline bool test_send_all(int fd, const std::string& s) {
+    return ::send(fd, s.data(), s.size(), 0) == (ssize_t)s.size();
+}
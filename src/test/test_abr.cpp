@@ -0,0 +1,175 @@
+// AdaptiveBitrate against synthetic congestion traces: a step, a slow
+// ramp and an oscillation, sampled every 100 ms like the firmware does.
+
+#include "HostTest.h"
+#include "AdaptiveBitrate.h"
+
+namespace {
+
+const uint32_t TICK_MS     = 100;
+const uint32_t INTERVAL_MS = 100;     // 10 fps stream
+
+struct Conditions {
+    uint32_t backlog;
+    uint32_t send_ms;
+};
+
+typedef Conditions (*Trace)(uint32_t t_ms);
+
+struct Change {
+    uint32_t t_ms;
+    int      level;
+    int      quality;
+    int      framesize;
+};
+
+// Feeds `trace` for `duration_ms`, recording every change the controller
+// asks for. Also checks that each change moves the level by exactly one
+// and never goes past the base settings or the limits.
+std::vector<Change> run(AdaptiveBitrate& abr, Trace trace, uint32_t duration_ms) {
+    std::vector<Change> out;
+    AdaptiveBitrate::Sample s;
+    memset(&s, 0, sizeof(s));
+    s.frame_interval_ms = INTERVAL_MS;
+    s.rssi_dbm = -60;
+    int level = abr.level();
+    for (uint32_t t = 0; t <= duration_ms; t += TICK_MS) {
+        Conditions c = trace(t);
+        s.frames_sent++;
+        s.backlog_frames = c.backlog;
+        s.send_ms = c.send_ms;
+        if (!abr.update(t, s)) continue;
+        Change ch = { t, abr.level(), abr.quality(), abr.framesize() };
+        out.push_back(ch);
+        int moved = ch.level > level ? ch.level - level : level - ch.level;
+        CHECK_EQ(moved, 1);
+        CHECK(ch.quality >= abr.baseQuality() && ch.quality <= AdaptiveBitrate::QUALITY_CEILING);
+        CHECK(ch.framesize <= abr.baseFramesize() && ch.framesize >= 5);
+        level = ch.level;
+    }
+    return out;
+}
+
+// Clear for 10.5 s, backlogged for 60 s, then clear
+const uint32_t STEP_AT = 10500, STEP_END = 70500;
+
+Conditions step_trace(uint32_t t) {
+    Conditions c = { 0, 20 };
+    if (t >= STEP_AT && t < STEP_END) c.backlog = 3;
+    return c;
+}
+
+// Send time climbs from 0 to 200 ms over 80 s
+Conditions ramp_trace(uint32_t t) {
+    Conditions c = { 0, t / 400 };
+    return c;
+}
+
+// Index of the controller window a sample falls in. Windows start at the
+// first sample (t = 0) and each one ends with the sample that closes it.
+uint32_t window_of(uint32_t t) {
+    return (t + AdaptiveBitrate::WINDOW_MS - 1) / AdaptiveBitrate::WINDOW_MS;
+}
+
+// Congested and clear windows alternating
+Conditions oscillating_trace(uint32_t t) {
+    Conditions c = { 0, 20 };
+    if (window_of(t) % 2 == 1) c.backlog = 3;
+    return c;
+}
+
+// Two congested windows, then one clear, repeating
+Conditions two_one_trace(uint32_t t) {
+    Conditions c = { 0, 20 };
+    if (window_of(t) % 3 != 0) c.backlog = 3;
+    return c;
+}
+
+}  // namespace
+
+void test_abr() {
+    // Base quality 12 reaches the ceiling of 40 in six steps, the last one
+    // short (37 -> 40); XGA (10) then has three ladder sizes below it.
+    const int base_q = 12, base_fs = 10;
+    const int max_level = 6 + 3;
+
+    // ---- Step: down every two windows to the floor, back up every five ----
+    {
+        AdaptiveBitrate abr;
+        abr.setBase(base_q, base_fs);
+        std::vector<Change> ch = run(abr, step_trace, 220000);
+        int downs = 0, ups = 0, peak = 0;
+        for (size_t i = 0; i < ch.size(); ++i) {
+            if (ch[i].t_ms < STEP_END) downs++;
+            else ups++;
+            if (ch[i].level > peak) peak = ch[i].level;
+        }
+        CHECK_EQ(downs, max_level);
+        CHECK_EQ(peak, max_level);
+        CHECK_EQ(ups, max_level);
+        if (CHECK(ch.size() > 8)) {
+            // Nothing before the step; the first change once two whole
+            // windows have been congested
+            CHECK(ch[0].t_ms >= STEP_AT + AdaptiveBitrate::WINDOW_MS);
+            CHECK(ch[0].t_ms <= STEP_AT + 2 * AdaptiveBitrate::WINDOW_MS);
+            CHECK(ch[1].t_ms - ch[0].t_ms == 2 * AdaptiveBitrate::WINDOW_MS);
+            // Quality first, to the ceiling, then framesize
+            CHECK_EQ(ch[5].quality, AdaptiveBitrate::QUALITY_CEILING);
+            CHECK_EQ(ch[5].framesize, base_fs);
+            CHECK_EQ(ch[5].level, 6);
+            CHECK_EQ(ch[6].framesize, 9);
+            CHECK_EQ(ch[8].framesize, 5);
+            // Recovery is slower: five clear windows per step
+            CHECK(ch[max_level + 1].t_ms - ch[max_level].t_ms == 5 * AdaptiveBitrate::WINDOW_MS);
+        }
+        // At the floor further congestion changes nothing
+        CHECK(ch.size() >= 10 && ch[8].t_ms < STEP_END && ch[9].t_ms > STEP_END);
+        CHECK_EQ(abr.quality(), base_q);
+        CHECK_EQ(abr.framesize(), base_fs);
+        CHECK_EQ(abr.level(), 0);
+    }
+
+    // ---- Ramp: no change while send time is under the frame interval ----
+    {
+        AdaptiveBitrate abr;
+        abr.setBase(base_q, base_fs);
+        std::vector<Change> ch = run(abr, ramp_trace, 80000);
+        CHECK(!ch.empty());
+        // send_ms passes INTERVAL_MS at t = 40 s
+        if (!ch.empty()) CHECK(ch[0].t_ms > 40000 + AdaptiveBitrate::WINDOW_MS);
+        CHECK_EQ(abr.reason(), AdaptiveBitrate::SLOW_SEND);
+    }
+
+    // ---- Oscillating: single congested windows never move it ----
+    {
+        AdaptiveBitrate abr;
+        abr.setBase(base_q, base_fs);
+        std::vector<Change> ch = run(abr, oscillating_trace, 120000);
+        CHECK_EQ(ch.size(), 0);
+        CHECK_EQ(abr.level(), 0);
+    }
+
+    // ---- Two congested, one clear: steps down, never back up ----
+    {
+        AdaptiveBitrate abr;
+        abr.setBase(base_q, base_fs);
+        std::vector<Change> ch = run(abr, two_one_trace, 120000);
+        CHECK(!ch.empty());
+        for (size_t i = 1; i < ch.size(); ++i) CHECK(ch[i].level > ch[i - 1].level);
+        CHECK_EQ(abr.level(), max_level);
+    }
+
+    // ---- Level at the ceiling and off-ladder framesizes ----
+    {
+        AdaptiveBitrate abr;
+        abr.setBase(38, 7);                 // HVGA sits between QVGA and VGA
+        std::vector<Change> ch = run(abr, step_trace, STEP_END);
+        CHECK_EQ(ch.size(), 2);             // 38 -> 40, then HVGA -> QVGA
+        if (ch.size() == 2) {
+            CHECK_EQ(ch[0].quality, 40);
+            CHECK_EQ(ch[0].level, 1);
+            CHECK_EQ(ch[1].framesize, 5);
+            CHECK_EQ(ch[1].level, 2);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+// CommandParser: MQTT command payloads as a flat JSON object or as compact
+// key=value / key:value fields, bare start/stop, and the value readers.
+// Fields are applied the way main.cpp's command_apply() does for the stream
+// and flash keys, so a payload that merely mentions "start" can't start the
+// stream.
+
+#include "CommandParser.h"
+#include "HostTest.h"
+
+namespace {
+
+struct Device {
+    int  stream;        // -1 untouched
+    long flash;         // -1 untouched
+    int  applied;
+    int  rejected;
+};
+
+// command_apply()'s stream/flash branches; every other key is rejected.
+bool apply(Device& d, const CommandField& f) {
+    long n;
+    bool b;
+    if (f.value_len == 0) {
+        if (cmd_is(f.key, f.key_len, "start")) d.stream = 1;
+        else if (cmd_is(f.key, f.key_len, "stop")) d.stream = 0;
+        else return false;
+    } else if (cmd_is(f.key, f.key_len, "stream")) {
+        if (!cmd_bool(f.value, f.value_len, b)) return false;
+        d.stream = b;
+    } else if (cmd_is(f.key, f.key_len, "flash")) {
+        if (cmd_int(f.value, f.value_len, n))       n = n < 0 ? 0 : n > 255 ? 255 : n;
+        else if (cmd_bool(f.value, f.value_len, b)) n = b ? 255 : 0;
+        else return false;
+        d.flash = n;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Device run(const char* payload, size_t buf_len = 384) {
+    Device d = { -1, -1, 0, 0 };
+    std::vector<char> buf(buf_len);
+    CommandReader reader(buf.data(), buf.size(), (const uint8_t*)payload, strlen(payload));
+    CommandField f;
+    while (reader.next(f)) {
+        if (apply(d, f)) d.applied++;
+        else d.rejected++;
+    }
+    return d;
+}
+
+// Every field of payload as "key=value|" pairs.
+std::string fields(const char* payload) {
+    char buf[384];
+    CommandReader reader(buf, sizeof(buf), (const uint8_t*)payload, strlen(payload));
+    std::string out;
+    CommandField f;
+    while (reader.next(f)) {
+        out.append(f.key, f.key_len);
+        out += '=';
+        out.append(f.value, f.value_len);
+        out += '|';
+    }
+    return out;
+}
+
+bool int_of(const char* s, long& out) { return cmd_int(s, strlen(s), out); }
+bool bool_of(const char* s, bool& out) { return cmd_bool(s, strlen(s), out); }
+
+}  // namespace
+
+void test_command_parser() {
+    // Flat JSON object: quotes stripped, numbers and words as written
+    CHECK(fields("{\"brightness\":1,\"stream\":\"ON\"}") == "brightness=1|stream=ON|");
+    CHECK(fields(" { \"fps\" : 12 , \"tz\" : \"a,b\" } ") == "fps=12|tz=a,b|");
+    CHECK(fields("{}") == "");
+    Device d = run("{\"stream\":\"on\",\"flash\":64}");
+    CHECK_EQ(d.stream, 1);
+    CHECK_EQ(d.flash, 64);
+    CHECK_EQ(d.applied, 2);
+    CHECK_EQ(d.rejected, 0);
+
+    // Compact fields: = or :, separated by , ; & or whitespace
+    CHECK(fields("brightness=1, stream=on") == "brightness=1|stream=on|");
+    CHECK(fields("a:1;b=2&c:3\td=4\r\ne=5") == "a=1|b=2|c=3|d=4|e=5|");
+    CHECK(fields(",, ;a=1&&") == "a=1|");
+    CHECK(fields("tz=\"a, b\" fps=3") == "tz=a, b|fps=3|");
+    CHECK(fields("") == "");
+
+    // Bare start/stop, and flash:128
+    d = run("start");
+    CHECK_EQ(d.stream, 1);
+    CHECK_EQ(d.applied, 1);
+    CHECK_EQ(run("  STOP\n").stream, 0);
+    d = run("flash:128");
+    CHECK_EQ(d.flash, 128);
+    CHECK_EQ(d.stream, -1);
+    CHECK_EQ(run("stop flash=on").flash, 255);
+    CHECK_EQ(run("flash=999").flash, 255);
+    CHECK_EQ(run("flash=-4").flash, 0);
+
+    // Mentioning start isn't starting
+    d = run("restart");
+    CHECK_EQ(d.stream, -1);
+    CHECK_EQ(d.rejected, 1);
+    d = run("{\"note\":\"start\"}");
+    CHECK_EQ(d.stream, -1);
+    CHECK_EQ(d.rejected, 1);
+    CHECK_EQ(run("starting").stream, -1);
+    CHECK_EQ(run("note=start").stream, -1);
+    CHECK_EQ(run("{\"start\":\"\"}").stream, 1);    // bare key, JSON form
+
+    // Booleans, any case
+    const char* yes[] = { "ON", "on", "true", "TRUE", "1", " \"On\" " };
+    const char* no[]  = { "OFF", "off", "false", "False", "0", "\"0\"" };
+    for (size_t i = 0; i < sizeof(yes) / sizeof(yes[0]); ++i) {
+        bool b = false;
+        CHECK(bool_of(yes[i], b) && b);
+        b = true;
+        CHECK(bool_of(no[i], b) && !b);
+    }
+    bool b = true;
+    CHECK(!bool_of("yes", b));
+    CHECK(!bool_of("2", b));
+    CHECK(!bool_of("", b));
+    CHECK(!bool_of("onn", b));
+    CHECK(b);                                       // untouched on failure
+    CHECK_EQ(run("stream=ON").stream, 1);
+    CHECK_EQ(run("stream:false").stream, 0);
+
+    // Integers: sign, fraction truncated, junk and overflow rejected
+    long n = 7;
+    CHECK(int_of("-12", n) && n == -12);
+    CHECK(int_of("+3", n) && n == 3);
+    CHECK(int_of("3.9", n) && n == 3);
+    CHECK(int_of(" \"42\" ", n) && n == 42);
+    CHECK(int_of("1000000000", n) && n == 1000000000L);
+    n = 7;
+    CHECK(!int_of("", n));
+    CHECK(!int_of("-", n));
+    CHECK(!int_of("1x", n));
+    CHECK(!int_of("1.2.3", n));
+    CHECK(!int_of(".5", n));
+    CHECK(!int_of("10000000000", n));
+    CHECK(!int_of("{\"a\":1}", n));
+    CHECK_EQ(n, 7);
+
+    // Rejected fields don't stop the rest
+    d = run("stream=maybe, flash=bright, fps=, flash=9");
+    CHECK_EQ(d.stream, -1);
+    CHECK_EQ(d.flash, 9);
+    CHECK_EQ(d.applied, 1);
+    CHECK_EQ(d.rejected, 3);
+    d = run("{\"stream\":{\"on\":1},\"flash\":[1],\"flash\":2}");
+    CHECK_EQ(d.stream, -1);
+    CHECK_EQ(d.flash, 2);
+    CHECK_EQ(d.rejected, 2);
+
+    // Over-long: a payload that doesn't fit the buffer is read as nothing
+    std::string big = "flash=1," + std::string(400, ' ') + "start";
+    d = run(big.c_str());
+    CHECK_EQ(d.applied + d.rejected, 0);
+    CHECK_EQ(d.flash, -1);
+    char small[8];
+    CommandReader fits(small, sizeof(small), (const uint8_t*)"flash=1", 7);
+    CHECK(fits.ok());
+    CommandReader tight(small, sizeof(small), (const uint8_t*)"flash=12", 8);
+    CHECK(!tight.ok());
+    CHECK_EQ(small[0], '\0');
+    CommandField f;
+    CHECK(!tight.next(f));
+    CHECK_EQ(run("flash=1", 7).applied, 0);         // needs room for the NUL
+    CHECK_EQ(run("flash=1", 8).flash, 1);
+}
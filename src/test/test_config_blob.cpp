@@ -0,0 +1,130 @@
+// ConfigBlob: a settings struct survives a round trip, older and newer
+// layouts migrate by prefix, and damaged blobs are reported as CORRUPT
+// without touching the caller's defaults.
+
+#include "ConfigBlob.h"
+#include "HostTest.h"
+
+namespace {
+
+// v1 of a config, and v2 with fields appended. Both pad explicitly, as
+// ConfigBlob requires.
+struct ConfigV1 {
+    uint32_t fps;
+    char     tz[16];
+    uint8_t  flags;
+    uint8_t  reserved[3];
+};
+
+struct ConfigV2 {
+    uint32_t fps;
+    char     tz[16];
+    uint8_t  flags;
+    uint8_t  reserved[3];
+    uint16_t snapshot_ms;
+    int8_t   ae_level;
+    uint8_t  reserved2;
+};
+
+ConfigV1 v1_sample() {
+    ConfigV1 c;
+    memset(&c, 0, sizeof(c));
+    c.fps = 12;
+    strcpy(c.tz, "CET-1CEST");
+    c.flags = 0x05;
+    return c;
+}
+
+ConfigV2 v2_defaults() {
+    ConfigV2 c;
+    memset(&c, 0, sizeof(c));
+    c.fps = 0;
+    strcpy(c.tz, "UTC0");
+    c.flags = 0x02;
+    c.snapshot_ms = 1000;
+    c.ae_level = -1;
+    return c;
+}
+
+}  // namespace
+
+void test_config_blob() {
+    typedef ConfigBlob<ConfigV1> Blob1;
+    typedef ConfigBlob<ConfigV2> Blob2;
+
+    // CRC-32 (IEEE) check value
+    CHECK_EQ(Blob2::crc32("123456789", 9), 0xCBF43926u);
+
+    // Round trip at the same version and size
+    ConfigV2 saved = v2_defaults();
+    saved.fps = 15;
+    strcpy(saved.tz, "EST5EDT");
+    saved.snapshot_ms = 250;
+    saved.ae_level = 2;
+    uint8_t blob2[Blob2::SIZE];
+    CHECK_EQ(Blob2::pack(saved, 2, blob2), Blob2::SIZE);
+    ConfigV2 loaded = v2_defaults();
+    uint16_t stored = 0;
+    CHECK_EQ(Blob2::unpack(blob2, sizeof(blob2), 2, loaded, &stored), Blob2::OK);
+    CHECK_EQ(stored, 2);
+    CHECK(memcmp(&loaded, &saved, sizeof(saved)) == 0);
+
+    // Same size, other version: MIGRATED, payload loaded, version handed back
+    loaded = v2_defaults();
+    CHECK_EQ(Blob2::unpack(blob2, sizeof(blob2), 3, loaded, &stored), Blob2::MIGRATED);
+    CHECK_EQ(stored, 2);
+    CHECK(memcmp(&loaded, &saved, sizeof(saved)) == 0);
+
+    // Older, shorter blob: the front loads, appended fields keep defaults
+    ConfigV1 old = v1_sample();
+    uint8_t blob1[Blob1::SIZE];
+    Blob1::pack(old, 1, blob1);
+    loaded = v2_defaults();
+    CHECK_EQ(Blob2::unpack(blob1, sizeof(blob1), 2, loaded, &stored), Blob2::MIGRATED);
+    CHECK_EQ(stored, 1);
+    CHECK_EQ(loaded.fps, 12);
+    CHECK(strcmp(loaded.tz, "CET-1CEST") == 0);
+    CHECK_EQ(loaded.flags, 0x05);
+    CHECK_EQ(loaded.snapshot_ms, 1000);
+    CHECK_EQ(loaded.ae_level, -1);
+
+    // Newer, longer blob read by older firmware: its prefix loads
+    ConfigV1 from_new;
+    memset(&from_new, 0, sizeof(from_new));
+    CHECK_EQ(Blob1::unpack(blob2, sizeof(blob2), 1, from_new, &stored), Blob1::MIGRATED);
+    CHECK_EQ(stored, 2);
+    CHECK_EQ(from_new.fps, 15);
+    CHECK(strcmp(from_new.tz, "EST5EDT") == 0);
+
+    // Nothing stored
+    loaded = v2_defaults();
+    CHECK_EQ(Blob2::unpack(blob2, 0, 2, loaded), Blob2::MISSING);
+
+    // Damage of every kind is CORRUPT and leaves the defaults untouched
+    const ConfigV2 defaults = v2_defaults();
+    const size_t header = sizeof(Blob2::Header);
+    for (size_t i = 0; i < Blob2::SIZE; ++i) {
+        uint8_t bad[Blob2::SIZE];
+        memcpy(bad, blob2, sizeof(bad));
+        bad[i] ^= 0x10;
+        loaded = defaults;
+        Blob2::Result r = Blob2::unpack(bad, sizeof(bad), 2, loaded);
+        // The version field isn't covered: a flip there reads as another version
+        if (i == 4 || i == 5) {
+            CHECK_EQ(r, Blob2::MIGRATED);
+            continue;
+        }
+        if (!CHECK_EQ(r, Blob2::CORRUPT)) printf("{\"config_blob_flip\":%zu}\n", i);
+        CHECK(memcmp(&loaded, &defaults, sizeof(defaults)) == 0);
+    }
+    loaded = defaults;
+    CHECK_EQ(Blob2::unpack(blob2, header - 1, 2, loaded), Blob2::CORRUPT);          // short header
+    CHECK_EQ(Blob2::unpack(blob2, sizeof(blob2) - 1, 2, loaded), Blob2::CORRUPT);   // truncated
+    uint8_t padded[Blob2::SIZE + 4];
+    memcpy(padded, blob2, Blob2::SIZE);
+    memset(padded + Blob2::SIZE, 0, 4);
+    CHECK_EQ(Blob2::unpack(padded, sizeof(padded), 2, loaded), Blob2::CORRUPT);      // trailing bytes
+    CHECK(memcmp(&loaded, &defaults, sizeof(defaults)) == 0);
+
+    CHECK(strcmp(Blob2::resultName(Blob2::CORRUPT), "corrupt") == 0);
+}
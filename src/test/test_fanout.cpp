@@ -0,0 +1,79 @@
+// RtpFanout with a reader that stops mid-packet: the pool must not run dry
+// for the subscribers that keep up.
+
+#include "HostTest.h"
+#include "RtpFanout.h"
+
+namespace {
+
+// Takes every packet whole, or stalls for good after `budget` bytes.
+struct TestSink {
+    size_t   budget;         // bytes left before stalling; SIZE_MAX = never
+    uint32_t packets;
+
+    explicit TestSink(size_t b = (size_t)-1) : budget(b), packets(0) {}
+
+    size_t wireLength(const RtpFrame& f, size_t i) { return f.length(i); }
+
+    int write(const RtpFrame& f, size_t i, size_t off) {
+        size_t n = f.length(i) - off;
+        if (n > budget) n = budget;
+        if (!n) return 0;
+        if (budget != (size_t)-1) budget -= n;
+        if (off + n == f.length(i)) packets++;
+        return (int)n;
+    }
+};
+
+}  // namespace
+
+void test_rtp_pool_stalled_reader() {
+    RtpFanout fanout(0x1234);
+    if (!CHECK(fanout.reserve())) return;
+
+    // ~100 packets a frame: a stalled queue (in-flight + two pending)
+    // holds 300 of the pool's 336 slots
+    std::vector<uint8_t> jpeg = test_jpeg(1600, 1200, 136000);
+    const int frames = 30;
+
+    int fast_a = fanout.subscribe();
+    int fast_b = fanout.subscribe();
+    int slow   = fanout.subscribe();
+    TestSink sink_a, sink_b;
+    TestSink stalled(700);           // half of the first packet, then nothing
+
+    int published = 0;
+    for (int i = 0; i < frames; ++i) {
+        published += fanout.publish(jpeg.data(), jpeg.size(), (uint32_t)i * 9000, (uint32_t)i) ? 1 : 0;
+        CHECK(fanout.drain(fast_a, sink_a, 1000) >= 0);
+        CHECK(fanout.drain(fast_b, sink_b, 1000) >= 0);
+        CHECK(fanout.drain(slow, stalled, 1000) >= 0);
+    }
+    uint16_t per_frame = fanout.lastPacketCount();
+    CHECK(per_frame >= 95);
+
+    CHECK_EQ(published, frames);
+    CHECK_EQ(fanout.framesFailed(), 0);
+    CHECK_EQ(fanout.stats(fast_a).frames_sent, frames);
+    CHECK_EQ(fanout.stats(fast_b).frames_sent, frames);
+    CHECK_EQ(fanout.stats(fast_a).frames_dropped, 0);
+    CHECK(fanout.poolStats().exhausted > 0);      // eviction was needed
+    CHECK(fanout.midPacket(slow));
+    CHECK_EQ(fanout.stats(slow).frames_sent, 0);
+    CHECK(fanout.stats(slow).frames_dropped > 0);
+
+    // The stalled reader resumes: it finishes the frame it was in, then
+    // gets the newest one -- whole frames only.
+    stalled.budget = (size_t)-1;
+    CHECK(fanout.drain(slow, stalled, 1000) >= 0);
+    CHECK(fanout.idle(slow));
+    uint32_t slow_frames = fanout.stats(slow).frames_sent;
+    CHECK(slow_frames >= 2);
+    CHECK_EQ(fanout.stats(slow).packets_sent, slow_frames * per_frame);
+    CHECK_EQ(slow_frames + fanout.stats(slow).frames_dropped, frames);
+
+    fanout.unsubscribe(fast_a);
+    fanout.unsubscribe(fast_b);
+    fanout.unsubscribe(slow);
+    CHECK_EQ(fanout.poolStats().in_use, 0);
+}
@@ -0,0 +1,170 @@
+// FrameRing: a reader that pins every slot, the order frames are handed back
+// to the driver, and one producer against several consumer threads.
+
+#include "HostTest.h"
+#include "FrameRing.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct TestFrame {
+    uint32_t         id;
+    std::atomic<int> live;
+};
+
+// Release log for the single-threaded cases
+uint32_t released_ids[64];
+size_t   released_count;
+
+void release_logged(TestFrame* f) {
+    if (released_count < 64) released_ids[released_count] = f->id;
+    released_count++;
+    f->live.store(0);
+}
+
+// Threaded case: frames are heap-allocated and freed on release, so a
+// consumer touching a released frame trips ASan.
+std::atomic<uint32_t> threaded_released(0);
+
+void release_deleting(TestFrame* f) {
+    if (f->live.exchange(0) != 1) fprintf(stderr, "frame %u released twice\n", f->id);
+    threaded_released.fetch_add(1);
+    delete f;
+}
+
+void reset_log() {
+    released_count = 0;
+}
+
+}  // namespace
+
+void test_frame_ring() {
+    typedef FrameRing<TestFrame, 4> Ring;
+    TestFrame frames[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        frames[i].id = i;
+        frames[i].live.store(1);
+    }
+
+    // ---- Reader overrun: every slot pinned, the new frame is dropped ----
+    {
+        reset_log();
+        Ring ring(release_logged);
+        CHECK(!ring.acquireLatest());
+        Ring::Ref held[4];
+        for (int i = 0; i < 4; ++i) {
+            CHECK(ring.publish(&frames[i], 100 + i));
+            held[i] = ring.acquireLatest();
+            CHECK(held[i] && held[i]->id == (uint32_t)i);
+            CHECK_EQ(held[i].seq(), i + 1);
+            CHECK_EQ(held[i].stampMs(), 100 + i);
+        }
+        CHECK_EQ(released_count, 0);
+
+        CHECK(!ring.publish(&frames[4], 104));           // nowhere to put it
+        CHECK_EQ(ring.dropped(), 1);
+        CHECK_EQ(released_count, 1);                      // handed straight back
+        CHECK_EQ(released_ids[0], 4);
+        CHECK_EQ(ring.latestSeq(), 4);                    // latest is unchanged
+        CHECK(ring.acquireLatest()->id == 3);
+
+        // A reader falls behind: its frame stays valid while newer ones
+        // rotate through the two slots the others gave back
+        held[1].reset();
+        held[2].reset();
+        CHECK_EQ(released_count, 3);
+        for (int i = 5; i < 9; ++i) CHECK(ring.publish(&frames[i], 100 + i));
+        CHECK_EQ(ring.published(), 8);
+        CHECK(held[0]->live.load() == 1 && held[0]->id == 0);
+        CHECK_EQ(ring.acquireLatest().seq(), 8);          // seq counts published frames only
+        CHECK(ring.latestSeq() - held[0].seq() > 1);      // the reader can see it skipped
+
+        for (int i = 0; i < 4; ++i) held[i].reset();
+        ring.clear();
+        CHECK(!ring.acquireLatest());
+        CHECK_EQ(released_count, 9);                      // every frame back exactly once
+    }
+
+    // ---- Release order: the last reference hands the frame back ----
+    {
+        reset_log();
+        Ring ring(release_logged);
+        ring.publish(&frames[10], 0);
+        Ring::Ref a = ring.acquireLatest();
+        ring.publish(&frames[11], 1);                     // ring lets go of 10; a still holds it
+        Ring::Ref b = ring.acquireLatest();
+        Ring::Ref b2 = ring.acquireLatest();
+        ring.publish(&frames[12], 2);
+        CHECK_EQ(released_count, 0);
+
+        b.reset();                                        // 11 still pinned by b2
+        CHECK_EQ(released_count, 0);
+        Ring::Ref moved(std::move(b2));                   // moving doesn't release
+        CHECK(!b2);
+        CHECK_EQ(released_count, 0);
+        moved.reset();
+        CHECK_EQ(released_count, 1);
+        CHECK_EQ(released_ids[0], 11);
+
+        a = ring.acquireLatest();                         // move-assign drops the old ref
+        CHECK_EQ(released_count, 2);
+        CHECK_EQ(released_ids[1], 10);
+        CHECK(a->id == 12);
+
+        ring.clear();                                     // a still pins 12
+        CHECK_EQ(released_count, 2);
+        a.reset();
+        CHECK_EQ(released_count, 3);
+        CHECK_EQ(released_ids[2], 12);
+    }
+
+    // ---- One producer, three consumers ----
+    {
+        typedef FrameRing<TestFrame, 3> SmallRing;
+        static SmallRing ring(release_deleting);
+        const uint32_t total = 200000;
+        threaded_released.store(0);
+        std::atomic<bool> done(false);
+        std::atomic<uint32_t> bad(0), acquired(0);
+
+        std::thread consumers[3];
+        for (int c = 0; c < 3; ++c) {
+            consumers[c] = std::thread([&, c]() {
+                uint32_t last_seq = 0;
+                SmallRing::Ref keep;                      // consumer 0 pins a frame for a while
+                while (!done.load()) {
+                    SmallRing::Ref r = ring.acquireLatest();
+                    if (!r) continue;
+                    acquired.fetch_add(1);
+                    // Frame ids equal their seq; it must stay live while pinned
+                    if (r->live.load() != 1 || r->id != r.seq() || r.stampMs() != r.seq()) bad.fetch_add(1);
+                    if (r.seq() < last_seq) bad.fetch_add(1);   // never goes backwards
+                    last_seq = r.seq();
+                    if (c == 0 && (last_seq & 0x3FF) == 0) keep = std::move(r);
+                }
+            });
+        }
+
+        uint32_t id = 1;
+        for (uint32_t i = 0; i < total; ++i) {
+            TestFrame* f = new TestFrame;
+            f->live.store(1);
+            // A dropped frame doesn't use up a seq, so only count the ones
+            // that made it into the ring
+            f->id = id;
+            if (ring.publish(f, id)) id++;
+        }
+        done.store(true);
+        for (int c = 0; c < 3; ++c) consumers[c].join();
+        ring.clear();
+
+        CHECK_EQ(bad.load(), 0);
+        CHECK(acquired.load() > 0);
+        CHECK_EQ(ring.published() + ring.dropped(), total);
+        CHECK_EQ(threaded_released.load(), total);        // every frame back exactly once
+        printf("{\"frame_ring\":{\"published\":%u,\"dropped\":%u,\"acquired\":%u}}\n",
+               ring.published(), ring.dropped(), acquired.load());
+    }
+}
@@ -0,0 +1,127 @@
+// HttpServerLite parked requests: a handler parks, the server keeps
+// answering other clients, and resume() answers it later with its method,
+// path and headers intact.
+
+#include "HostTest.h"
+#include "HttpServerLite.h"
+
+namespace {
+
+HttpServerLite*        server = nullptr;
+HttpServerLite::Ticket parked = 0;
+uint32_t               longest_poll_ms = 0;
+
+void handle_slow() {
+    parked = server->park();
+}
+
+void handle_fast() {
+    server->send(200, "text/plain", "fast");
+}
+
+// Echoes what the parked request kept
+void answer_parked() {
+    char body[96];
+    snprintf(body, sizeof(body), "%s %s %s", server->method() == HTTP_HEAD ? "HEAD" : "GET",
+             server->uri(), server->headerValue("If-None-Match"));
+    server->send(200, "text/plain", body);
+}
+
+void poll_once() {
+    uint32_t start = millis();
+    server->poll();
+    uint32_t took = millis() - start;
+    if (took > longest_poll_ms) longest_poll_ms = took;
+}
+
+// Polls until fd's response is complete (the server closes it) or timeout.
+std::string response(int fd, uint32_t timeout_ms = 1000) {
+    std::string in;
+    uint32_t start = millis();
+    while (millis() - start < timeout_ms) {
+        poll_once();
+        if (!test_recv_some(fd, in)) break;
+        delay(1);
+    }
+    return in;
+}
+
+// Sends a request to /slow and polls until it is parked.
+int park_request(int port, const char* method, const char* etag) {
+    int fd = test_tcp_connect(port);
+    if (fd < 0) return -1;
+    char req[128];
+    snprintf(req, sizeof(req), "%s /slow HTTP/1.1\r\nHost: x\r\nIf-None-Match: %s\r\n\r\n", method, etag);
+    test_send_all(fd, req);
+    parked = 0;
+    uint32_t start = millis();
+    while (!parked && millis() - start < 1000) {
+        poll_once();
+        delay(1);
+    }
+    return fd;
+}
+
+}  // namespace
+
+void test_http_parked() {
+    const int port = test_ctx.port_base;
+    HttpServerLite srv(port);
+    server = &srv;
+    static const char* headers[] = { "If-None-Match" };
+    srv.collectHeaders(headers, 1);
+    srv.on("/slow", handle_slow);
+    srv.on("/fast", HTTP_GET, handle_fast);
+    srv.begin();
+
+    // Parked: nothing comes back, and other clients are served meanwhile
+    int a = park_request(port, "GET", "\"abc\"");
+    HttpServerLite::Ticket ta = parked;
+    if (!CHECK(a >= 0 && ta != 0)) return;
+    int b = test_tcp_connect(port);
+    CHECK(test_send_all(b, "GET /fast HTTP/1.1\r\nHost: x\r\n\r\n"));
+    std::string rb = response(b);
+    CHECK(rb.find("200 OK") != std::string::npos);
+    CHECK(rb.find("\r\n\r\nfast") != std::string::npos);
+    std::string ra;
+    CHECK(test_recv_some(a, ra));
+    CHECK(ra.empty());
+
+    // Resumed: answered with the request's own method, path and header
+    CHECK(srv.resume(ta, answer_parked));
+    ra = response(a);
+    CHECK(ra.find("200 OK") != std::string::npos);
+    CHECK(ra.find("\r\n\r\nGET /slow \"abc\"") != std::string::npos);
+    CHECK(!srv.resume(ta, answer_parked));              // answered already
+
+    // HEAD survives parking: headers only
+    int c = park_request(port, "HEAD", "\"h\"");
+    HttpServerLite::Ticket tc = parked;
+    CHECK(tc != 0 && tc != ta);
+    CHECK(srv.resume(tc, answer_parked));
+    std::string rc = response(c);
+    CHECK(rc.find("Content-Length: 14\r\n") != std::string::npos);
+    CHECK(rc.size() >= 4 && rc.compare(rc.size() - 4, 4, "\r\n\r\n") == 0);
+
+    // A client that leaves while parked frees its slot; resume() says so
+    int d = park_request(port, "GET", "\"d\"");
+    HttpServerLite::Ticket td = parked;
+    CHECK(td != 0);
+    ::close(d);
+    uint32_t start = millis();
+    while (srv.clientCount() > 0 && millis() - start < 1000) {
+        poll_once();
+        delay(1);
+    }
+    CHECK_EQ(srv.clientCount(), 0);
+    CHECK(!srv.resume(td, answer_parked));
+
+    // Parking never held up poll()
+    CHECK(longest_poll_ms < 20);
+    CHECK_EQ(srv.requests(), 4);
+
+    ::close(a);
+    ::close(b);
+    ::close(c);
+    server = nullptr;
+}
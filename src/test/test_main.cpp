@@ -0,0 +1,90 @@
+/*
+ * Host tests for the streaming classes (PlatformIO env:native_test).
+ *
+ * Each test drives the firmware's headers directly -- loopback sockets in
+ * place of WiFi, synthetic JPEGs in place of the camera -- and prints one
+ * JSON object with its check and failure counts. Failed checks are
+ * reported on stderr with file and line; the exit status is non-zero if
+ * any check failed:
+ *
+ *   pio run -e native_test
+ *   .pio/build/native_test/program [--only <test>] [--port-base 28500]
+ *
+ * Tests that listen use ports port_base + 10*i .. + 10*i + 9.
+ */
+
+#include "HostTest.h"
+
+#include <stdlib.h>
+
+TestContext test_ctx;
+
+void test_abr();
+void test_command_parser();
+void test_config_blob();
+void test_frame_ring();
+void test_http_parked();
+void test_mjpeg_pool();
+void test_rtsp_loopback();
+void test_rtsp_session_timeout();
+void test_rtp_udp_loopback();
+void test_rtp_udp_silent_receiver();
+void test_rtp_pool_stalled_reader();
+void test_web_ui();
+
+struct TestCase {
+    const char* name;
+    void      (*run)();
+};
+
+static const TestCase tests[] = {
+    { "abr_traces",       test_abr },
+    { "command_parser",   test_command_parser },
+    { "config_blob",      test_config_blob },
+    { "frame_ring",       test_frame_ring },
+    { "http_parked",      test_http_parked },
+    { "mjpeg_pool",       test_mjpeg_pool },
+    { "rtsp_loopback",    test_rtsp_loopback },
+    { "rtsp_timeout",     test_rtsp_session_timeout },
+    { "rtp_udp_loopback", test_rtp_udp_loopback },
+    { "rtp_udp_silent",   test_rtp_udp_silent_receiver },
+    { "rtp_pool_stalled", test_rtp_pool_stalled_reader },
+    { "web_ui",           test_web_ui },
+};
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    int port_base = 28500;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--only") && i + 1 < argc) {
+            only = argv[++i];
+        } else if (!strcmp(argv[i], "--port-base") && i + 1 < argc) {
+            port_base = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--only <test>] [--port-base P]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int total_failures = 0, ran = 0;
+    const size_t count = sizeof(tests) / sizeof(tests[0]);
+    for (size_t i = 0; i < count; ++i) {
+        if (only && strcmp(only, tests[i].name) != 0) continue;
+        test_ctx.checks    = 0;
+        test_ctx.failures  = 0;
+        test_ctx.port_base = port_base + 10 * (int)i;
+        uint32_t start = millis();
+        tests[i].run();
+        printf("{\"test\":\"%s\",\"checks\":%d,\"failures\":%d,\"ms\":%u}\n",
+               tests[i].name, test_ctx.checks, test_ctx.failures, (unsigned)(millis() - start));
+        fflush(stdout);
+        total_failures += test_ctx.failures;
+        ran++;
+    }
+    if (!ran) {
+        fprintf(stderr, "no test named %s\n", only);
+        return 2;
+    }
+    printf("{\"summary\":true,\"tests\":%d,\"failures\":%d}\n", ran, total_failures);
+    return total_failures ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// MjpegServer over loopback: frames come out of the fixed buffer pool
+// intact while one viewer stalls and pins a buffer.
+
+#include "HostTest.h"
+#include "MjpegServer.h"
+
+namespace {
+
+// Frame i: a distinct size and content, so a part can be matched to it
+std::vector<uint8_t> frame_for(int i) {
+    return test_jpeg(320, 240, 2000 + (size_t)i * 37, (uint8_t)(i & 0x3F));
+}
+
+// Takes complete parts off `in`; returns how many matched their frame.
+int take_parts(std::string& in, int& bad) {
+    static const char hdr[] = "\r\n--frame\r\nContent-Type: image/jpeg\r\nContent-Length: ";
+    int good = 0;
+    for (;;) {
+        size_t p = in.find(hdr);
+        if (p == std::string::npos) return good;
+        size_t end = in.find("\r\n\r\n", p + sizeof(hdr) - 1);
+        if (end == std::string::npos) return good;
+        size_t len = (size_t)atoi(in.c_str() + p + sizeof(hdr) - 1);
+        if (in.size() < end + 4 + len) return good;
+        std::vector<uint8_t> want = frame_for((int)((len - frame_for(0).size()) / 37));
+        if (want.size() == len && memcmp(want.data(), in.data() + end + 4, len) == 0) good++;
+        else bad++;
+        in.erase(0, end + 4 + len);
+    }
+}
+
+}  // namespace
+
+void test_mjpeg_pool() {
+    const int port = test_ctx.port_base;
+    MjpegServer srv(port);
+    srv.begin();
+
+    int a = test_tcp_connect(port);
+    int b = test_tcp_connect(port, 4096);
+    if (!CHECK(a >= 0 && b >= 0)) return;
+    CHECK(test_send_all(a, "GET /stream HTTP/1.1\r\nHost: x\r\n\r\n"));
+    CHECK(test_send_all(b, "GET /stream HTTP/1.1\r\nHost: x\r\n\r\n"));
+    uint32_t start = millis();
+    while (srv.viewerCount() < 2 && millis() - start < 1000) {
+        srv.poll();
+        delay(1);
+    }
+    CHECK_EQ(srv.viewerCount(), 2);
+
+    const int frames = 60;
+    std::string in_a;
+    int good = 0, bad = 0;
+    for (int i = 0; i < frames; ++i) {
+        std::vector<uint8_t> f = frame_for(i);
+        srv.publish(f.data(), f.size(), (uint32_t)i + 1);
+        for (int k = 0; k < 20; ++k) {
+            srv.poll();
+            test_recv_some(a, in_a);
+            good += take_parts(in_a, bad);
+            delay(1);
+        }
+    }
+
+    // b never reads: it pins the buffer it's stuck in, a keeps going
+    CHECK_EQ(bad, 0);
+    CHECK(good >= frames - 2);
+    CHECK_EQ(srv.framesPublished() + srv.framesDropped(), frames);
+    CHECK(srv.framesPublished() >= (uint32_t)frames - 2);
+
+    // Nothing fits a frame bigger than a buffer
+    std::vector<uint8_t> huge(MjpegServer::FRAME_BYTES + 1, 0);
+    uint32_t dropped = srv.framesDropped();
+    CHECK(!srv.publish(huge.data(), huge.size(), frames + 1));
+    CHECK_EQ(srv.framesDropped(), dropped + 1);
+
+    ::close(a);
+    ::close(b);
+    start = millis();
+    while (srv.hasViewers() && millis() - start < 1000) {
+        srv.poll();
+        delay(1);
+    }
+    CHECK(!srv.hasViewers());
+}
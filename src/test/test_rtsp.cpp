@@ -0,0 +1,508 @@
+// RtspServerLite over loopback TCP: the OPTIONS / DESCRIBE / SETUP / PLAY /
+// TEARDOWN exchange, pipelined requests, and a keep-alive that arrives while
+// an interleaved RTP packet is half written. Over UDP: packet pacing, and a
+// viewer that goes silent losing its session. Idle sessions expire in every
+// state unless a keep-alive arrives.
+
+#include "HostTest.h"
+#include "RtspServerLite.h"
+
+namespace {
+
+// Client end of an RTSP connection: replies and interleaved packets are
+// split out of the byte stream, and every RTP packet is checked so a reply
+// written into the middle of one shows up as garbage or a broken frame.
+struct RtspClient {
+    int         fd;
+    bool        open;
+    std::string in;
+    uint32_t    packets;
+    uint32_t    frames;          // RTP packets with the marker bit
+    uint32_t    garbage;         // bytes that were neither a reply nor a packet
+    uint32_t    broken;          // packets out of order within a frame
+    bool        in_frame;
+    uint16_t    next_seq;
+    uint32_t    last_frag;
+
+    explicit RtspClient(int f)
+        : fd(f), open(f >= 0), packets(0), frames(0), garbage(0), broken(0),
+          in_frame(false), next_seq(0), last_frag(0) {}
+    ~RtspClient() { if (fd >= 0) ::close(fd); }
+
+    void checkRtp(const uint8_t* p, size_t len) {
+        if (len < RTP_HEADER_SIZE + 8 || (p[0] >> 6) != 2) {
+            broken++;
+            return;
+        }
+        uint16_t seq  = (uint16_t)((p[2] << 8) | p[3]);
+        uint32_t frag = ((uint32_t)p[13] << 16) | ((uint32_t)p[14] << 8) | p[15];
+        if (in_frame) {
+            if (seq != next_seq || frag <= last_frag) broken++;
+        } else if (frag != 0) {
+            broken++;
+        }
+        packets++;
+        next_seq  = (uint16_t)(seq + 1);
+        last_frag = frag;
+        in_frame  = !(p[1] & 0x80);
+        if (!in_frame) frames++;
+    }
+
+    // Takes one reply off the stream into `reply`, checking any packets in
+    // front of it. False when no complete reply is buffered yet.
+    bool takeReply(std::string& reply) {
+        static const char prefix[] = "RTSP/1.0 ";
+        while (!in.empty()) {
+            if (in[0] == '$') {
+                if (in.size() < 4) return false;
+                size_t len = ((uint8_t)in[2] << 8) | (uint8_t)in[3];
+                if (in.size() < 4 + len) return false;
+                if (in[1] == 0) checkRtp((const uint8_t*)in.data() + 4, len);
+                in.erase(0, 4 + len);
+                continue;
+            }
+            size_t cmp = in.size() < sizeof(prefix) - 1 ? in.size() : sizeof(prefix) - 1;
+            if (in.compare(0, cmp, prefix, cmp) != 0) {
+                garbage += (uint32_t)in.size();
+                in.clear();
+                return false;
+            }
+            size_t end = in.find("\r\n\r\n");
+            if (end == std::string::npos) return false;
+            size_t body = 0;
+            size_t cl = in.find("Content-Length: ");
+            if (cl != std::string::npos && cl < end) body = (size_t)atoi(in.c_str() + cl + 16);
+            if (in.size() < end + 4 + body) return false;
+            reply = in.substr(0, end + 4 + body);
+            in.erase(0, end + 4 + body);
+            return true;
+        }
+        return false;
+    }
+};
+
+int cseq_of(const std::string& reply) {
+    size_t p = reply.find("CSeq: ");
+    return p == std::string::npos ? -1 : atoi(reply.c_str() + p + 6);
+}
+
+// Polls the server and reads the client until the reply to `cseq` arrives.
+bool await_reply(RtspServerLite& srv, RtspClient& c, int cseq, std::string& reply,
+                 uint32_t timeout_ms = 3000) {
+    uint32_t start = millis();
+    while (millis() - start < timeout_ms) {
+        srv.poll();
+        if (c.open) c.open = test_recv_some(c.fd, c.in);
+        while (c.takeReply(reply)) {
+            if (cseq_of(reply) == cseq) return true;
+        }
+        if (!c.open && c.in.empty()) return false;
+        delay(1);
+    }
+    return false;
+}
+
+// Polls until `frames` complete frames have reached the client.
+bool await_frames(RtspServerLite& srv, RtspClient& c, uint32_t frames, uint32_t timeout_ms = 3000) {
+    uint32_t start = millis();
+    std::string reply;
+    while (c.frames < frames && millis() - start < timeout_ms) {
+        srv.poll();
+        if (c.open) c.open = test_recv_some(c.fd, c.in);
+        while (c.takeReply(reply)) {}
+        delay(1);
+    }
+    return c.frames >= frames;
+}
+
+std::string request(const char* method, const char* url, int cseq, const char* headers = "") {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s %s RTSP/1.0\r\nCSeq: %d\r\n%s\r\n", method, url, cseq, headers);
+    return buf;
+}
+
+// Empty RTCP receiver report from fd to the server's RTCP port
+void send_rr(int fd, int port) {
+    static const uint8_t rr[8] = { 0x80, 201, 0, 1, 0x12, 0x34, 0x56, 0x78 };
+    sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family      = AF_INET;
+    to.sin_port        = htons((uint16_t)port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::sendto(fd, rr, sizeof(rr), 0, (const sockaddr*)&to, sizeof(to));
+}
+
+// RTP datagrams waiting on fd
+uint32_t drain_udp(int fd) {
+    uint8_t p[1500];
+    uint32_t n = 0;
+    while (::recv(fd, p, sizeof(p), MSG_DONTWAIT) > 0) n++;
+    return n;
+}
+
+}  // namespace
+
+void test_rtsp_loopback() {
+    const int port = test_ctx.port_base;
+    RtspServerLite srv(port, "test", (uint16_t)(port + 2));
+    srv.begin();
+
+    char url[64], track[80];
+    snprintf(url, sizeof(url), "rtsp://127.0.0.1:%d/mjpeg/", port);
+    snprintf(track, sizeof(track), "%strack1", url);
+
+    // Small receive buffer and segments so a frame fills the path and the
+    // server stalls part way into a packet
+    RtspClient c(test_tcp_connect(port, 4096, 536));
+    if (!CHECK(c.fd >= 0)) return;
+    std::string reply;
+
+    // OPTIONS twice in one segment: the second must not be lost
+    CHECK(test_send_all(c.fd, request("OPTIONS", url, 1) + request("OPTIONS", url, 2)));
+    CHECK(await_reply(srv, c, 1, reply));
+    CHECK(reply.find("RTSP/1.0 200 OK") == 0);
+    CHECK(reply.find("Public: ") != std::string::npos);
+    CHECK(await_reply(srv, c, 2, reply));
+
+    // DESCRIBE: Content-Base is the URL with exactly one trailing slash
+    CHECK(test_send_all(c.fd, request("DESCRIBE", url, 3, "Accept: application/sdp\r\n")));
+    CHECK(await_reply(srv, c, 3, reply));
+    CHECK(reply.find(std::string("Content-Base: ") + url + "\r\n") != std::string::npos);
+    CHECK(reply.find("m=video 0 RTP/AVP 26") != std::string::npos);
+
+    std::string no_slash(url, strlen(url) - 1);
+    CHECK(test_send_all(c.fd, request("DESCRIBE", no_slash.c_str(), 4)));
+    CHECK(await_reply(srv, c, 4, reply));
+    CHECK(reply.find("Content-Base: " + no_slash + "/\r\n") != std::string::npos);
+
+    // PLAY before SETUP is refused
+    CHECK(test_send_all(c.fd, request("PLAY", url, 5)));
+    CHECK(await_reply(srv, c, 5, reply));
+    CHECK(reply.find("RTSP/1.0 455") == 0);
+
+    CHECK(test_send_all(c.fd, request("SETUP", track, 6,
+                                      "Transport: RTP/AVP/TCP;unicast;interleaved=0-1\r\n")));
+    CHECK(await_reply(srv, c, 6, reply));
+    CHECK(reply.find("Transport: RTP/AVP/TCP;unicast;interleaved=0-1") != std::string::npos);
+
+    CHECK(test_send_all(c.fd, request("PLAY", url, 7)));
+    CHECK(await_reply(srv, c, 7, reply));
+    CHECK(reply.find("RTSP/1.0 200 OK") == 0);
+    CHECK(srv.hasViewers());
+
+    // A small frame goes straight through
+    std::vector<uint8_t> small = test_jpeg(320, 240, 3000);
+    CHECK(srv.pushFrame(small.data(), small.size(), millis()));
+    CHECK(await_frames(srv, c, 1));
+
+    // Keep-alive while a frame is mid-send: stop reading until the server
+    // is stuck inside a packet, then send two pipelined GET_PARAMETERs. The
+    // first reply is held back until the packet is out; the second request
+    // waits in the session meanwhile.
+    std::vector<uint8_t> big = test_jpeg(640, 480, 120000);
+    CHECK(srv.pushFrame(big.data(), big.size(), millis()));
+    bool mid = false;
+    for (int i = 0; i < 4000 && !mid; ++i) {
+        srv.poll();
+        mid = srv.fanout().midPacket(0);
+        // Stopped on a packet boundary: let a few hundred bytes through
+        if (!mid && i % 50 == 49) test_recv_some(c.fd, c.in, 300);
+    }
+    CHECK(mid);
+    CHECK(test_send_all(c.fd, request("GET_PARAMETER", url, 8, "Session: 1\r\n") +
+                              request("GET_PARAMETER", url, 9, "Session: 1\r\n")));
+    for (int i = 0; i < 50; ++i) {
+        srv.poll();
+        delay(1);
+    }
+    CHECK(await_reply(srv, c, 8, reply));
+    CHECK(reply.find("RTSP/1.0 200 OK") == 0);
+    CHECK(await_reply(srv, c, 9, reply));
+    CHECK(await_frames(srv, c, 2));
+    CHECK_EQ(c.garbage, 0);
+    CHECK_EQ(c.broken, 0);
+
+    // Another frame after the keep-alive still arrives intact
+    CHECK(srv.pushFrame(small.data(), small.size(), millis()));
+    CHECK(await_frames(srv, c, 3));
+    CHECK_EQ(c.garbage, 0);
+    CHECK_EQ(c.broken, 0);
+
+    // UDP SETUP on a second connection: the '-' in a later parameter is not
+    // the RTCP port
+    RtspClient u(test_tcp_connect(port));
+    if (CHECK(u.fd >= 0)) {
+        CHECK(test_send_all(u.fd, request("SETUP", track, 1,
+                                          "Transport: RTP/AVP;unicast;client_port=40000;source=a-b\r\n")));
+        CHECK(await_reply(srv, u, 1, reply));
+        CHECK(reply.find("client_port=40000-40001;") != std::string::npos);
+        CHECK(test_send_all(u.fd, request("TEARDOWN", url, 2)));
+        CHECK(await_reply(srv, u, 2, reply));
+    }
+
+    // TEARDOWN: reply, then the server closes the connection
+    CHECK(test_send_all(c.fd, request("TEARDOWN", url, 10)));
+    CHECK(await_reply(srv, c, 10, reply));
+    uint32_t start = millis();
+    while (c.open && millis() - start < 1000) {
+        srv.poll();
+        c.open = test_recv_some(c.fd, c.in);
+        delay(1);
+    }
+    CHECK(!c.open);
+    CHECK_EQ(srv.sessionCount(), 0);
+    CHECK(!srv.hasViewers());
+}
+
+// RTP over UDP: sequence numbers run on without gaps across frames, and
+// the packets of each frame are spread over the frame interval by RtpPacer
+// instead of leaving in one burst.
+void test_rtp_udp_loopback() {
+    const int port = test_ctx.port_base;
+    const int client_rtp = port + 4;
+    const uint32_t interval_ms = 100;
+    const int frames = 8;
+
+    RtspServerLite srv(port, "test", (uint16_t)(port + 2));
+    srv.begin();
+    int rtp_fd = test_udp_bind(client_rtp);
+    int rtcp_fd = test_udp_bind(client_rtp + 1);
+    RtspClient c(test_tcp_connect(port));
+    if (!CHECK(rtp_fd >= 0 && rtcp_fd >= 0 && c.fd >= 0)) return;
+
+    char url[64], transport[96];
+    snprintf(url, sizeof(url), "rtsp://127.0.0.1:%d/mjpeg/", port);
+    snprintf(transport, sizeof(transport), "Transport: RTP/AVP;unicast;client_port=%d-%d\r\n",
+             client_rtp, client_rtp + 1);
+    std::string reply;
+    CHECK(test_send_all(c.fd, request("SETUP", (std::string(url) + "track1").c_str(), 1, transport)));
+    CHECK(await_reply(srv, c, 1, reply));
+    CHECK(reply.find("RTSP/1.0 200 OK") == 0);
+    CHECK(test_send_all(c.fd, request("PLAY", url, 2)));
+    CHECK(await_reply(srv, c, 2, reply));
+
+    // ~15 packets per frame
+    std::vector<uint8_t> jpeg = test_jpeg(640, 480, 20000);
+    uint32_t packets = 0, seq_gaps = 0, broken = 0, max_span_us = 0, min_span_us = 0xFFFFFFFFu;
+    uint16_t next_seq = 0;
+    uint32_t frame_first_us = 0, frame_packets = 0, pushed = 0;
+    uint32_t next_push = millis();
+    const uint32_t end = next_push + interval_ms * (frames + 2);
+
+    while (millis() < end) {
+        if (pushed < (uint32_t)frames && (int32_t)(millis() - next_push) >= 0) {
+            CHECK(srv.pushFrame(jpeg.data(), jpeg.size(), next_push));
+            next_push += interval_ms;
+            pushed++;
+        }
+        srv.poll();
+
+        uint8_t p[1500];
+        ssize_t n;
+        while ((n = ::recv(rtp_fd, p, sizeof(p), MSG_DONTWAIT)) > 0) {
+            uint32_t now_us = micros();
+            if (n < (ssize_t)(RTP_HEADER_SIZE + 8) || (p[0] >> 6) != 2) {
+                broken++;
+                continue;
+            }
+            uint16_t seq  = (uint16_t)((p[2] << 8) | p[3]);
+            uint32_t frag = ((uint32_t)p[13] << 16) | ((uint32_t)p[14] << 8) | p[15];
+            if (packets && seq != next_seq) seq_gaps++;
+            next_seq = (uint16_t)(seq + 1);
+            packets++;
+            if (frag == 0) {
+                frame_first_us = now_us;
+                frame_packets = 0;
+            }
+            frame_packets++;
+            if (p[1] & 0x80) {
+                // Frame complete. The first goes out before an interval
+                // has been learned and is sent unpaced.
+                uint32_t span = now_us - frame_first_us;
+                if (packets > frame_packets) {
+                    if (span > max_span_us) max_span_us = span;
+                    if (span < min_span_us) min_span_us = span;
+                }
+            }
+        }
+        usleep(200);
+    }
+
+    CHECK_EQ(pushed, frames);
+    CHECK_EQ(packets, srv.fanout().stats(0).packets_sent);
+    CHECK_EQ(srv.fanout().stats(0).frames_sent, frames);
+    CHECK_EQ(seq_gaps, 0);
+    CHECK_EQ(broken, 0);
+    CHECK_EQ(srv.frameIntervalMs(), interval_ms);
+    // Paced over SPREAD_PERCENT of the interval: a frame takes most of
+    // 75 ms to go out, never longer than the interval itself.
+    CHECK(min_span_us >= interval_ms * 1000 * RtpPacer::SPREAD_PERCENT / 100 * 3 / 4);
+    CHECK(max_span_us < interval_ms * 1000);
+    printf("{\"rtp_udp\":{\"packets\":%u,\"min_frame_span_us\":%u,\"max_frame_span_us\":%u}}\n",
+           packets, min_span_us, max_span_us);
+
+    CHECK(test_send_all(c.fd, request("TEARDOWN", url, 3)));
+    CHECK(await_reply(srv, c, 3, reply));
+    ::close(rtp_fd);
+    ::close(rtcp_fd);
+}
+
+void test_rtp_udp_silent_receiver() {
+    const int port = test_ctx.port_base;
+    const int server_rtp = port + 2;
+    const int client_rtp = port + 4;
+    const uint32_t timeout_ms = 600;
+
+    RtspServerLite srv(port, "test", (uint16_t)server_rtp);
+    srv.setSessionTimeoutMs(timeout_ms);
+    srv.begin();
+    int rtp_fd = test_udp_bind(client_rtp);
+    int rtcp_fd = test_udp_bind(client_rtp + 1);
+    int stray_fd = test_udp_bind(client_rtp + 2);       // right host, wrong port
+    RtspClient c(test_tcp_connect(port));
+    if (!CHECK(rtp_fd >= 0 && rtcp_fd >= 0 && stray_fd >= 0 && c.fd >= 0)) return;
+
+    char url[64], transport[96];
+    snprintf(url, sizeof(url), "rtsp://127.0.0.1:%d/mjpeg/", port);
+    snprintf(transport, sizeof(transport), "Transport: RTP/AVP;unicast;client_port=%d-%d\r\n",
+             client_rtp, client_rtp + 1);
+    std::string reply;
+    CHECK(test_send_all(c.fd, request("SETUP", (std::string(url) + "track1").c_str(), 1, transport)));
+    CHECK(await_reply(srv, c, 1, reply));
+    CHECK(test_send_all(c.fd, request("PLAY", url, 2)));
+    CHECK(await_reply(srv, c, 2, reply));
+
+    // The RTSP connection stays silent throughout: only receiver reports
+    // from the client RTCP port keep the session, well past the timeout.
+    std::vector<uint8_t> jpeg = test_jpeg(320, 240, 4000);
+    uint32_t received = 0;
+    uint32_t start = millis(), last_push = 0, last_rr = start;
+    while (millis() - start < timeout_ms * 3) {
+        uint32_t now = millis();
+        if (now - last_push >= 100) {
+            srv.pushFrame(jpeg.data(), jpeg.size(), now);
+            last_push = now;
+        }
+        if (now - last_rr >= timeout_ms / 4) {
+            send_rr(rtcp_fd, server_rtp + 1);
+            send_rr(stray_fd, server_rtp + 1);
+            last_rr = now;
+        }
+        srv.poll();
+        received += drain_udp(rtp_fd);
+        delay(1);
+    }
+    CHECK_EQ(srv.sessionCount(), 1);
+    CHECK(srv.hasViewers());
+    CHECK(received > 0);
+
+    // Viewer gone without a FIN: reports stop (the stray ones don't count)
+    uint32_t silent = millis();
+    while (srv.sessionCount() && millis() - silent < timeout_ms * 3) {
+        uint32_t now = millis();
+        if (now - last_push >= 100) {
+            srv.pushFrame(jpeg.data(), jpeg.size(), now);
+            last_push = now;
+        }
+        if (now - last_rr >= timeout_ms / 4) {
+            send_rr(stray_fd, server_rtp + 1);
+            last_rr = now;
+        }
+        srv.poll();
+        drain_udp(rtp_fd);
+        delay(1);
+    }
+    uint32_t reclaimed_ms = millis() - silent;
+    CHECK_EQ(srv.sessionCount(), 0);
+    CHECK(!srv.hasViewers());
+    CHECK(reclaimed_ms >= timeout_ms / 2);             // last report up to timeout/4 earlier
+    CHECK(reclaimed_ms <= timeout_ms + 100);
+
+    // No more RTP for the dead address, and the slot is free again
+    drain_udp(rtp_fd);
+    for (int i = 0; i < 5; ++i) {
+        srv.pushFrame(jpeg.data(), jpeg.size(), millis());
+        for (int k = 0; k < 20; ++k) {
+            srv.poll();
+            delay(1);
+        }
+    }
+    CHECK_EQ(drain_udp(rtp_fd), 0);
+    c.open = test_recv_some(c.fd, c.in);
+    CHECK(!c.open);
+    RtspClient d(test_tcp_connect(port));
+    CHECK(test_send_all(d.fd, request("OPTIONS", url, 1)));
+    CHECK(await_reply(srv, d, 1, reply));
+    CHECK_EQ(srv.sessionCount(), 1);
+    printf("{\"rtp_udp_silent\":{\"timeout_ms\":%u,\"reclaimed_after_ms\":%u}}\n",
+           timeout_ms, reclaimed_ms);
+
+    ::close(rtp_fd);
+    ::close(rtcp_fd);
+    ::close(stray_fd);
+}
+
+void test_rtsp_session_timeout() {
+    const int port = test_ctx.port_base;
+    const uint32_t timeout_ms = 1000;
+
+    RtspServerLite srv(port, "test", (uint16_t)(port + 2));
+    srv.setSessionTimeoutMs(timeout_ms);
+    srv.begin();
+
+    // Two interleaved viewers, stream off (no frames): nothing is ever
+    // sent to them, so a vanished peer can't show up as a failed write.
+    char url[64];
+    snprintf(url, sizeof(url), "rtsp://127.0.0.1:%d/mjpeg/", port);
+    const char* transport = "Transport: RTP/AVP/TCP;unicast;interleaved=0-1\r\n";
+    RtspClient live(test_tcp_connect(port));
+    RtspClient gone(test_tcp_connect(port));
+    if (!CHECK(live.fd >= 0 && gone.fd >= 0)) return;
+    std::string reply;
+    RtspClient* viewers[2] = { &live, &gone };
+    for (int i = 0; i < 2; ++i) {
+        RtspClient& c = *viewers[i];
+        CHECK(test_send_all(c.fd, request("SETUP", (std::string(url) + "track1").c_str(), 1, transport)));
+        CHECK(await_reply(srv, c, 1, reply));
+        CHECK(reply.find(";timeout=1\r\n") != std::string::npos);   // what is enforced
+        CHECK(test_send_all(c.fd, request("PLAY", url, 2)));
+        CHECK(await_reply(srv, c, 2, reply));
+    }
+    CHECK_EQ(srv.sessionCount(), 2);
+    CHECK(srv.hasViewers());
+
+    // live sends GET_PARAMETER keep-alives, gone sends nothing
+    int cseq = 3;
+    uint32_t start = millis(), last_ka = start, gone_closed_ms = 0;
+    while (millis() - start < timeout_ms * 3) {
+        if (millis() - last_ka >= timeout_ms / 3) {
+            CHECK(test_send_all(live.fd, request("GET_PARAMETER", url, cseq)));
+            CHECK(await_reply(srv, live, cseq, reply));
+            cseq++;
+            last_ka = millis();
+        }
+        srv.poll();
+        if (gone.open) {
+            gone.open = test_recv_some(gone.fd, gone.in);
+            if (!gone.open) gone_closed_ms = millis() - start;
+        }
+        delay(1);
+    }
+    CHECK(!gone.open);
+    CHECK(gone_closed_ms >= timeout_ms);
+    CHECK(gone_closed_ms <= timeout_ms + 100);
+    CHECK(live.open);
+    CHECK_EQ(srv.sessionCount(), 1);
+    CHECK(srv.hasViewers());
+
+    // Keep-alives stop: live goes the same way
+    start = millis();
+    while (live.open && millis() - start < timeout_ms * 2) {
+        srv.poll();
+        live.open = test_recv_some(live.fd, live.in);
+        delay(1);
+    }
+    CHECK(!live.open);
+    CHECK_EQ(srv.sessionCount(), 0);
+    CHECK(!srv.hasViewers());
+}
@@ -0,0 +1,134 @@
+// The web UI (web_assets.h) through HttpServerLite, served the way
+// main.cpp's send_web_asset() does: gzip bodies straight from the arrays,
+// ETag revalidation, and no heap allocation inside poll() for a full page
+// load (/, /app.css, /app.js) beyond the socket handle each accepted client
+// gets (a shared_ptr, in WiFiClient here as in the ESP32 core).
+
+#include "HostTest.h"
+#include "HttpServerLite.h"
+#include "web_assets.h"
+
+// ASan/LSan provide these; without a sanitizer the heap check is skipped.
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*)(const volatile void*, size_t),
+                                                         void (*)(const volatile void*))
+    __attribute__((weak));
+
+namespace {
+
+HttpServerLite* server = nullptr;
+bool            counting = false;
+uint32_t        poll_allocs = 0;
+size_t          poll_alloc_bytes = 0;
+uint32_t        connections = 0;
+
+void on_malloc(const volatile void*, size_t n) {
+    if (!counting) return;
+    poll_allocs++;
+    poll_alloc_bytes += n;
+}
+
+void on_free(const volatile void*) {}
+
+// As main.cpp's, less its heap probe
+void send_web_asset(const char* type, const uint8_t* gz, size_t len,
+                    const char* etag, const char* cache_control) {
+    server->sendHeader("Cache-Control", cache_control);
+    server->sendHeader("ETag", etag);
+    const char* inm = server->headerValue("If-None-Match");
+    if (inm[0] && strstr(inm, etag)) {
+        server->send(304);
+    } else {
+        server->sendHeader("Content-Encoding", "gzip");
+        server->send_P(200, type, (const char*)gz, len);
+    }
+}
+
+void handle_root() {
+    send_web_asset("text/html", WEB_INDEX_GZ, WEB_INDEX_GZ_LEN, WEB_INDEX_ETAG, "no-cache");
+}
+
+void handle_app_css() {
+    send_web_asset("text/css", WEB_APP_CSS_GZ, WEB_APP_CSS_GZ_LEN, WEB_APP_CSS_ETAG,
+                   "public, max-age=31536000, immutable");
+}
+
+void handle_app_js() {
+    send_web_asset("application/javascript", WEB_APP_JS_GZ, WEB_APP_JS_GZ_LEN, WEB_APP_JS_ETAG,
+                   "public, max-age=31536000, immutable");
+}
+
+// GET path on a fresh connection; the whole response once the server closes.
+std::string fetch(int port, const char* path, const char* etag = nullptr) {
+    std::string in;
+    int fd = test_tcp_connect(port);
+    if (fd < 0) return in;
+    connections++;
+    char req[160];
+    snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: x\r\n%s%s%s\r\n", path,
+             etag ? "If-None-Match: " : "", etag ? etag : "", etag ? "\r\n" : "");
+    test_send_all(fd, req);
+    uint32_t start = millis();
+    while (millis() - start < 1000) {
+        counting = true;
+        server->poll();
+        counting = false;
+        if (!test_recv_some(fd, in)) break;
+        delay(1);
+    }
+    ::close(fd);
+    return in;
+}
+
+bool body_is(const std::string& resp, const uint8_t* gz, size_t len) {
+    size_t p = resp.find("\r\n\r\n");
+    return p != std::string::npos && resp.size() - p - 4 == len &&
+           memcmp(resp.data() + p + 4, gz, len) == 0;
+}
+
+}  // namespace
+
+void test_web_ui() {
+    const int port = test_ctx.port_base;
+    HttpServerLite srv(port);
+    server = &srv;
+    static const char* headers[] = { "If-None-Match" };
+    srv.collectHeaders(headers, 1);
+    srv.on("/", HTTP_GET, handle_root);
+    srv.on("/app.css", HTTP_GET, handle_app_css);
+    srv.on("/app.js", HTTP_GET, handle_app_js);
+    srv.begin();
+    bool hooked = __sanitizer_install_malloc_and_free_hooks &&
+                  __sanitizer_install_malloc_and_free_hooks(on_malloc, on_free);
+
+    // First visit: everything, gzip, byte for byte
+    std::string root = fetch(port, "/");
+    std::string css  = fetch(port, "/app.css");
+    std::string js   = fetch(port, "/app.js");
+    uint32_t first_allocs = poll_allocs - connections;
+    size_t first_bytes = poll_alloc_bytes;
+    CHECK(root.find("HTTP/1.1 200 OK\r\n") == 0);
+    CHECK(root.find("Content-Encoding: gzip\r\n") != std::string::npos);
+    CHECK(root.find("Cache-Control: no-cache\r\n") != std::string::npos);
+    CHECK(body_is(root, WEB_INDEX_GZ, WEB_INDEX_GZ_LEN));
+    CHECK(body_is(css, WEB_APP_CSS_GZ, WEB_APP_CSS_GZ_LEN));
+    CHECK(body_is(js, WEB_APP_JS_GZ, WEB_APP_JS_GZ_LEN));
+    CHECK(js.find("immutable") != std::string::npos);
+
+    // Repeat visit: the page revalidates to a 304, no body
+    std::string again = fetch(port, "/", WEB_INDEX_ETAG);
+    CHECK(again.find("HTTP/1.1 304 Not Modified\r\n") == 0);
+    CHECK(again.find("Content-Length: 0\r\n") != std::string::npos);
+    std::string stale = fetch(port, "/", "\"0000000000000000\"");
+    CHECK(body_is(stale, WEB_INDEX_GZ, WEB_INDEX_GZ_LEN));
+
+    if (hooked) {
+        CHECK_EQ(first_allocs, 0);
+        CHECK_EQ(poll_allocs, connections);
+    }
+    // Page load: allocations past the per-client handles, and all bytes
+    printf("{\"web_ui\":{\"heap_checked\":%s,\"page_load_wire_bytes\":%zu,"
+           "\"request_allocs\":%u,\"poll_alloc_bytes\":%zu}}\n",
+           hooked ? "true" : "false", root.size() + css.size() + js.size(), first_allocs, first_bytes);
+    if (hooked) __sanitizer_install_malloc_and_free_hooks(nullptr, nullptr);
+    server = nullptr;
+}
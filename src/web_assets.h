@@ -0,0 +1,309 @@
+#pragma once
+#include <pgmspace.h>
+
+/*
+ * Web UI from web/, gzip-compressed, in PROGMEM.
+ * Generated by tools/embed_web.py -- edit web/ and rebuild, not this file.
+ */
+
+// app.css: 1608 bytes raw, 720 bytes gzip
+static const char   WEB_APP_CSS_ETAG[] = "\"f0b33ef5ec4e9656\"";
+static const size_t WEB_APP_CSS_GZ_LEN = 720;
+const uint8_t WEB_APP_CSS_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x94, 0xc1, 0x8e, 0x9b, 0x30,
+  0x10, 0x86, 0xef, 0x79, 0x0a, 0xa4, 0x68, 0xb5, 0xbb, 0x12, 0xde, 0x62, 0x42, 0xa3, 0xc8, 0xdc,
+  0x7a, 0xa8, 0xd4, 0x43, 0x4f, 0x55, 0xcf, 0x95, 0x31, 0x03, 0x71, 0xd7, 0xd8, 0xc8, 0x36, 0xbb,
+  0x49, 0x51, 0xde, 0xbd, 0x63, 0x27, 0x24, 0x24, 0x5d, 0xb5, 0xab, 0xca, 0x12, 0x02, 0x33, 0xe3,
+  0xf9, 0xe7, 0x9b, 0x19, 0x57, 0xa6, 0xde, 0x8f, 0x1d, 0xb7, 0xad, 0xd4, 0x2c, 0x2b, 0x7b, 0x5e,
+  0xd7, 0x52, 0xb7, 0xf8, 0xd6, 0x18, 0xed, 0x49, 0xc3, 0x3b, 0xa9, 0xf6, 0xcc, 0xed, 0x9d, 0x87,
+  0x8e, 0x0c, 0x32, 0x25, 0xbc, 0xef, 0x15, 0x90, 0xe3, 0x46, 0xfa, 0x49, 0x49, 0xfd, 0xfc, 0x95,
+  0x8b, 0x6f, 0xf1, 0xf3, 0x33, 0x7a, 0xa4, 0xf7, 0xdf, 0xa0, 0x35, 0x90, 0x7c, 0xff, 0x72, 0x9f,
+  0x3a, 0xae, 0x1d, 0x71, 0x60, 0x65, 0x53, 0x56, 0x5c, 0x3c, 0xb7, 0xd6, 0x0c, 0xba, 0x66, 0x4b,
+  0x4a, 0x69, 0x29, 0x8c, 0x32, 0x96, 0x2d, 0x01, 0xe0, 0xb0, 0xd8, 0x02, 0xaf, 0xc1, 0x8e, 0x73,
+  0x93, 0x3c, 0xcf, 0xcf, 0x4a, 0x68, 0xd6, 0xef, 0x12, 0xba, 0xee, 0x77, 0x65, 0x2d, 0x5d, 0xaf,
+  0xf8, 0x9e, 0x35, 0x0a, 0x76, 0xe5, 0xcf, 0xc1, 0x79, 0xd9, 0xec, 0x89, 0xc0, 0xa0, 0xa0, 0x3d,
+  0x73, 0x3d, 0x17, 0x40, 0x2a, 0xf0, 0xaf, 0x00, 0xba, 0xe4, 0x4a, 0xb6, 0x9a, 0x48, 0x14, 0xe5,
+  0x98, 0xc0, 0xdf, 0x60, 0xcb, 0xca, 0x58, 0x0c, 0x43, 0x2a, 0xe3, 0xbd, 0xe9, 0x18, 0xc5, 0x43,
+  0x9d, 0x51, 0xb2, 0x4e, 0x96, 0xab, 0xd5, 0x6a, 0x12, 0x91, 0x6c, 0xe9, 0x05, 0x45, 0x04, 0xe0,
+  0xe4, 0x2f, 0x60, 0x74, 0xd3, 0xef, 0xce, 0x26, 0x18, 0x48, 0x8f, 0xb3, 0x7f, 0x39, 0x2a, 0x3b,
+  0xa5, 0xc3, 0x39, 0x3f, 0x2c, 0x3a, 0x2e, 0xf5, 0x78, 0x16, 0x9f, 0xbf, 0x29, 0x3e, 0x3c, 0x48,
+  0x2d, 0x2d, 0x08, 0x2f, 0x8d, 0x66, 0xe8, 0x3e, 0x74, 0xba, 0x6c, 0x79, 0x1f, 0x1d, 0x0e, 0x8b,
+  0xa7, 0xd6, 0xca, 0x7a, 0x9c, 0x5c, 0xc2, 0x47, 0x19, 0x1e, 0x04, 0xf3, 0xc1, 0x1d, 0x0f, 0xe4,
+  0xe8, 0xe1, 0x98, 0x85, 0x1e, 0xb8, 0x7f, 0xe0, 0x83, 0x37, 0xa4, 0x91, 0x3e, 0xed, 0xa4, 0xee,
+  0xf8, 0xee, 0x21, 0xcf, 0x11, 0x5a, 0x4a, 0x1b, 0xfb, 0xf8, 0x38, 0x3f, 0x55, 0x70, 0x5b, 0x5f,
+  0x71, 0xa6, 0x3c, 0xac, 0x13, 0x9a, 0x1b, 0x26, 0x13, 0x30, 0xcb, 0x6b, 0x39, 0x38, 0x86, 0x08,
+  0x6e, 0x4a, 0x12, 0x12, 0xaf, 0xcc, 0x2e, 0x60, 0x08, 0x9b, 0x67, 0xbe, 0x53, 0xa4, 0x64, 0x9b,
+  0x9f, 0x61, 0x26, 0x59, 0x52, 0xa0, 0xcf, 0x15, 0xd4, 0xe2, 0x02, 0xae, 0xc9, 0xc2, 0x42, 0x3f,
+  0xc5, 0x2b, 0x50, 0x73, 0xba, 0xf4, 0x62, 0xb4, 0xd9, 0x6c, 0xd0, 0xe2, 0x85, 0xab, 0x01, 0xe6,
+  0x16, 0xab, 0x98, 0x9a, 0x35, 0xaf, 0xe3, 0x22, 0x49, 0xae, 0x28, 0xe3, 0x77, 0x04, 0xfd, 0x6a,
+  0x11, 0x41, 0x78, 0x84, 0x9d, 0xbf, 0xf7, 0x0d, 0x1a, 0x1c, 0x25, 0x4f, 0x7d, 0x12, 0x44, 0x2e,
+  0x42, 0x42, 0x46, 0x8d, 0xa7, 0xf3, 0x18, 0x4d, 0x68, 0x22, 0xb8, 0x12, 0x0f, 0x1f, 0xb3, 0xbb,
+  0x84, 0x24, 0x48, 0xe6, 0xf1, 0xe2, 0xc8, 0xf2, 0x98, 0x27, 0xfa, 0x54, 0x03, 0x9e, 0xa0, 0xd3,
+  0xe4, 0xa9, 0xf2, 0xfa, 0x5c, 0x4b, 0xa9, 0x71, 0x64, 0x30, 0x9e, 0x32, 0xe2, 0xf9, 0xcc, 0x73,
+  0x1d, 0x70, 0x66, 0x11, 0xe7, 0x1c, 0xf9, 0xfa, 0xbc, 0x33, 0x2f, 0x4d, 0x51, 0x14, 0x57, 0xe3,
+  0x94, 0x57, 0x61, 0xcd, 0x26, 0xaa, 0xbc, 0x69, 0x4e, 0x0f, 0x3b, 0x4f, 0x6a, 0x10, 0xc6, 0xf2,
+  0xd8, 0x6d, 0xda, 0x68, 0x28, 0xc5, 0x60, 0x1d, 0xda, 0xf7, 0x46, 0xc6, 0xe1, 0x98, 0x69, 0x8f,
+  0xfa, 0x93, 0x6c, 0xd2, 0xcf, 0xb6, 0xe6, 0x05, 0x6c, 0x1a, 0x92, 0x38, 0xbe, 0x5e, 0x35, 0xd0,
+  0xaa, 0x0a, 0xeb, 0xb0, 0x90, 0x5d, 0x8b, 0xb5, 0x46, 0xd4, 0xb2, 0xf6, 0x5b, 0xec, 0x8f, 0xec,
+  0xae, 0xdc, 0x82, 0x6c, 0xb7, 0x9e, 0x85, 0xd6, 0x7c, 0x57, 0x5e, 0x71, 0x0c, 0x85, 0xa9, 0xe1,
+  0xb6, 0xfc, 0xf3, 0x78, 0x59, 0x76, 0xb9, 0xa2, 0x82, 0xd0, 0xe2, 0x0f, 0x68, 0xc5, 0xa9, 0xd3,
+  0x3b, 0x12, 0xbb, 0xfd, 0x1d, 0x63, 0x77, 0x58, 0x2c, 0xd1, 0xfc, 0x87, 0xf0, 0x56, 0xb9, 0xf1,
+  0x58, 0xe0, 0xf2, 0xff, 0x47, 0x8f, 0xae, 0x2f, 0xa3, 0x87, 0x4d, 0x11, 0xa6, 0xaf, 0x98, 0xa6,
+  0xe5, 0x78, 0x2b, 0x4d, 0x9d, 0x17, 0xd5, 0x38, 0xcf, 0xad, 0x2f, 0x4f, 0x8a, 0x43, 0x96, 0x3d,
+  0xf1, 0xd2, 0x2b, 0x18, 0x63, 0xd0, 0x63, 0x2c, 0x46, 0x3f, 0x10, 0x7a, 0x2a, 0x11, 0xf1, 0xa6,
+  0x8f, 0x00, 0xdf, 0x9e, 0x11, 0xbc, 0x81, 0x42, 0xd4, 0x58, 0x72, 0x6f, 0xf1, 0xfe, 0x6d, 0x8c,
+  0xed, 0xd8, 0xd0, 0xf7, 0x60, 0x05, 0x77, 0x50, 0x2a, 0xf0, 0x58, 0x6e, 0x12, 0x9a, 0x3e, 0xde,
+  0xf2, 0x4f, 0x59, 0x01, 0xdd, 0x14, 0xbe, 0x31, 0x06, 0x7f, 0x8e, 0xb3, 0x40, 0x9b, 0x7f, 0xdd,
+  0xba, 0x31, 0x07, 0xd0, 0x35, 0x1e, 0xf1, 0x1b, 0xfc, 0x01, 0xdb, 0xa2, 0x48, 0x06, 0x00, 0x00,
+};
+
+// app.js: 8117 bytes raw, 2509 bytes gzip
+static const char   WEB_APP_JS_ETAG[] = "\"c16820070d31d6e8\"";
+static const size_t WEB_APP_JS_GZ_LEN = 2509;
+const uint8_t WEB_APP_JS_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x59, 0xed, 0x72, 0xdb, 0x36,
+  0x16, 0xfd, 0x9f, 0xa7, 0x60, 0xfd, 0xa3, 0x20, 0x57, 0x34, 0x25, 0xdb, 0xdb, 0x6e, 0xd6, 0x0a,
+  0xad, 0xb1, 0x15, 0x3b, 0x4d, 0x27, 0x8e, 0xbd, 0x2b, 0x75, 0x3b, 0xd3, 0x8c, 0x47, 0x03, 0x91,
+  0x90, 0x44, 0x07, 0x22, 0x58, 0x00, 0xf2, 0x67, 0xf4, 0x4e, 0x7d, 0x86, 0x3e, 0xd9, 0x5e, 0x00,
+  0xfc, 0x00, 0x25, 0xca, 0x52, 0xb2, 0x9d, 0xd9, 0x1f, 0x89, 0x09, 0xe0, 0xe2, 0xe0, 0xe2, 0x00,
+  0xf7, 0xe2, 0x00, 0x8a, 0x58, 0x2a, 0xa4, 0x23, 0x9f, 0x2e, 0x71, 0x16, 0x3e, 0xef, 0x9d, 0xce,
+  0x09, 0x4f, 0x22, 0xdc, 0xfe, 0xc0, 0xc4, 0xe8, 0x34, 0x9d, 0x12, 0x4a, 0xc4, 0xde, 0xf1, 0xde,
+  0xf5, 0x60, 0xf8, 0xfa, 0xfa, 0xed, 0xd0, 0xbf, 0x3c, 0x0a, 0x0e, 0x83, 0x4e, 0xfb, 0xd0, 0xbf,
+  0x3c, 0x38, 0x08, 0x0e, 0xd4, 0xd7, 0xde, 0xb2, 0xfb, 0x8a, 0x12, 0xe9, 0x50, 0x2c, 0xe4, 0xe9,
+  0x42, 0xb2, 0xc1, 0x63, 0x1a, 0x85, 0x9d, 0xee, 0x2b, 0x2c, 0xe0, 0xc3, 0x99, 0x2c, 0xd2, 0x48,
+  0x26, 0x2c, 0x75, 0x54, 0xa9, 0x4f, 0x59, 0xf4, 0xd9, 0xf5, 0x9e, 0x5f, 0x39, 0x4e, 0xa4, 0xc7,
+  0x24, 0x19, 0x8b, 0x66, 0xe1, 0x25, 0x96, 0xb3, 0x60, 0x42, 0x19, 0xe3, 0xee, 0x5b, 0x2c, 0x49,
+  0x90, 0xb2, 0x7b, 0xd7, 0x6b, 0x1f, 0x74, 0x3a, 0x1d, 0xaf, 0x5b, 0x9a, 0x8e, 0x39, 0xbb, 0x17,
+  0x84, 0xbf, 0x3f, 0xfd, 0x78, 0x1a, 0xbe, 0x4f, 0x25, 0x0d, 0x94, 0xe9, 0x30, 0x99, 0x93, 0x0b,
+  0xc6, 0xe7, 0x58, 0xba, 0x5e, 0xc0, 0x89, 0x60, 0xf4, 0x8e, 0xc4, 0x57, 0x99, 0x1a, 0x50, 0x40,
+  0x8d, 0x84, 0xe6, 0xdf, 0x58, 0x4a, 0x2a, 0x94, 0x8c, 0x89, 0xe4, 0x21, 0xd4, 0x53, 0xfd, 0x64,
+  0x21, 0xde, 0x7c, 0xf9, 0x82, 0x7e, 0x19, 0xf6, 0x3b, 0x48, 0x59, 0xe2, 0x7b, 0x9c, 0x48, 0x67,
+  0x42, 0x64, 0x34, 0x73, 0x51, 0x1b, 0x67, 0x49, 0x5b, 0xf9, 0x3e, 0x8a, 0x94, 0xf3, 0x3d, 0xe3,
+  0x31, 0x6a, 0xe9, 0xbf, 0x2d, 0xf4, 0xbd, 0x7c, 0x52, 0x85, 0x34, 0x62, 0x31, 0xf9, 0xe5, 0xdf,
+  0xef, 0xfb, 0x6c, 0x9e, 0xc1, 0x78, 0xa9, 0x74, 0xf5, 0x40, 0x9e, 0x57, 0xe1, 0x71, 0x32, 0x01,
+  0x07, 0x67, 0x03, 0x89, 0xe5, 0x02, 0x7c, 0xeb, 0xbe, 0x5a, 0x6a, 0xd6, 0x84, 0x2e, 0x87, 0xcf,
+  0x39, 0x89, 0x19, 0xa3, 0x54, 0x4d, 0x8a, 0x87, 0xe9, 0x82, 0xd2, 0x35, 0x12, 0x57, 0x40, 0x14,
+  0x91, 0x92, 0x3f, 0xaa, 0x3f, 0xc5, 0x04, 0x79, 0xd8, 0xe0, 0xbe, 0x36, 0x47, 0xda, 0x19, 0xc7,
+  0x49, 0x26, 0xee, 0x77, 0x3c, 0x60, 0x9f, 0x3d, 0x4e, 0xe4, 0x82, 0xa7, 0xa6, 0x92, 0x93, 0x34,
+  0x26, 0x3c, 0xc7, 0xcd, 0x1d, 0x0e, 0x6e, 0x05, 0x4b, 0x5d, 0x2f, 0xef, 0x56, 0x00, 0x46, 0x51,
+  0x3c, 0xe2, 0xf8, 0x1e, 0x01, 0xbb, 0x33, 0x92, 0xba, 0x3c, 0x3c, 0xe1, 0x81, 0x24, 0x0f, 0xb0,
+  0x00, 0x79, 0xcd, 0x1d, 0xa6, 0xe1, 0x89, 0x71, 0xa9, 0x72, 0x8b, 0xd0, 0x30, 0x66, 0xd1, 0x62,
+  0x0e, 0xd4, 0x04, 0x53, 0x22, 0xcf, 0x29, 0x51, 0x9f, 0x67, 0x8f, 0xef, 0x63, 0x17, 0x95, 0x88,
+  0xdd, 0xb2, 0x13, 0xf8, 0x48, 0xa8, 0x47, 0xa8, 0x46, 0xee, 0xb3, 0x54, 0x82, 0x71, 0x08, 0xc0,
+  0xc6, 0x62, 0xe9, 0x05, 0x11, 0x56, 0xde, 0xb8, 0x1e, 0x8c, 0xb4, 0xd4, 0xfd, 0x96, 0xa6, 0x86,
+  0x78, 0xcf, 0x4b, 0x60, 0xd6, 0x22, 0xcc, 0x9a, 0xd7, 0x6d, 0x9d, 0xb0, 0xd2, 0x21, 0x99, 0x48,
+  0x4a, 0x42, 0x74, 0x3e, 0xb8, 0x3e, 0x3a, 0xdc, 0xef, 0x9f, 0x5e, 0x3a, 0xfb, 0x0e, 0x6a, 0xdd,
+  0x06, 0x31, 0xb9, 0x4b, 0x22, 0xd2, 0xad, 0xdb, 0xae, 0x3a, 0xaf, 0xfb, 0x2a, 0x32, 0x2c, 0x47,
+  0x2d, 0xa4, 0x9d, 0x71, 0x8c, 0xd1, 0x0a, 0xd0, 0x8e, 0x7d, 0x67, 0x31, 0x1f, 0x25, 0xd9, 0x5a,
+  0xdf, 0x24, 0xdb, 0xd2, 0xef, 0x5b, 0xfa, 0x2c, 0x32, 0x15, 0x54, 0x6b, 0xfd, 0x4c, 0xf5, 0x48,
+  0xb4, 0x90, 0x23, 0xd0, 0x16, 0x08, 0x2e, 0x44, 0xb2, 0x06, 0xa0, 0x2a, 0x47, 0xf1, 0x78, 0x0e,
+  0x00, 0xf1, 0xd9, 0x7c, 0x1b, 0xc4, 0x8c, 0xe0, 0x75, 0xdf, 0x55, 0xe5, 0x08, 0xe2, 0x83, 0x00,
+  0xc6, 0xd9, 0x36, 0x84, 0x4c, 0x70, 0x3c, 0x5f, 0x83, 0xd0, 0xb5, 0x3b, 0x63, 0x08, 0xc9, 0x09,
+  0x98, 0xab, 0xf0, 0x5a, 0x67, 0x24, 0x6f, 0x64, 0x69, 0x0f, 0x5d, 0x7d, 0x44, 0xc7, 0xe8, 0xea,
+  0xe2, 0x62, 0x1b, 0xde, 0x04, 0x52, 0xe8, 0x6c, 0x03, 0x9c, 0x69, 0x6b, 0x40, 0x83, 0x50, 0x81,
+  0xd6, 0x4c, 0x78, 0x45, 0xc8, 0x6d, 0x86, 0xcf, 0xc4, 0x28, 0x4e, 0x44, 0x46, 0xf1, 0xe3, 0x0a,
+  0x7c, 0xde, 0xd3, 0x00, 0x05, 0x12, 0x73, 0xe8, 0xda, 0xb3, 0x0b, 0xc7, 0x68, 0x8e, 0x1f, 0x90,
+  0x07, 0xa4, 0xb4, 0xf5, 0x96, 0x56, 0x2d, 0x38, 0x92, 0x0b, 0x0c, 0x11, 0xca, 0x2e, 0x92, 0x07,
+  0x12, 0xbb, 0x07, 0xaa, 0x15, 0xea, 0x73, 0xb7, 0x96, 0x56, 0x4e, 0x92, 0x64, 0x9e, 0x55, 0xe1,
+  0x3f, 0x66, 0xf1, 0x63, 0x10, 0x63, 0x89, 0x05, 0x81, 0xd0, 0x83, 0x26, 0x93, 0xc0, 0xc3, 0x30,
+  0x44, 0x17, 0x48, 0xf7, 0x82, 0xa1, 0xa3, 0x6c, 0x31, 0x52, 0x6d, 0xa3, 0x49, 0x7d, 0x80, 0x3f,
+  0xff, 0xc8, 0x6d, 0x8e, 0x2d, 0x9b, 0x68, 0xd5, 0xa6, 0xbf, 0x8d, 0xe9, 0xb2, 0x6b, 0x33, 0x1f,
+  0xaa, 0x69, 0x87, 0x98, 0x53, 0x66, 0x1b, 0x7b, 0xea, 0x75, 0xc9, 0x53, 0xdb, 0x77, 0x61, 0xb8,
+  0x80, 0x3c, 0x34, 0x49, 0x52, 0x12, 0x97, 0xeb, 0xf4, 0x0d, 0x89, 0xb1, 0x31, 0x2d, 0x96, 0xa3,
+  0xd8, 0xc4, 0xeb, 0xd1, 0x89, 0xc8, 0x46, 0x2a, 0x2c, 0x5f, 0x1a, 0x5e, 0x64, 0xea, 0x1c, 0x0d,
+  0x53, 0x72, 0xef, 0xa8, 0x0f, 0xab, 0xd7, 0xdf, 0xca, 0x03, 0xb8, 0x32, 0xcf, 0x8f, 0xcc, 0x7a,
+  0x97, 0xd2, 0x66, 0xe3, 0x44, 0x0a, 0xc8, 0x0d, 0x74, 0xe7, 0x4e, 0xc0, 0x2a, 0x7e, 0x60, 0x11,
+  0xa6, 0x64, 0x20, 0x79, 0x92, 0x4e, 0x77, 0xc0, 0xcd, 0xdd, 0x19, 0x35, 0xa4, 0x24, 0xcb, 0xd3,
+  0x8d, 0xb8, 0x66, 0x4e, 0x31, 0xa1, 0x12, 0x87, 0xab, 0xca, 0x03, 0xce, 0x80, 0x8a, 0x8a, 0xed,
+  0x9e, 0x98, 0xd9, 0x29, 0xa4, 0x15, 0x3f, 0x74, 0x5d, 0x7d, 0x7f, 0x16, 0x21, 0xf2, 0xd2, 0xfe,
+  0x5c, 0x34, 0x4e, 0x6a, 0x1b, 0x51, 0x66, 0x42, 0x78, 0x2c, 0xde, 0xea, 0x39, 0x69, 0x5d, 0x05,
+  0x25, 0x57, 0x3b, 0xb1, 0x62, 0x05, 0x53, 0xbd, 0x14, 0x61, 0x35, 0x6b, 0x6b, 0x8f, 0x15, 0x00,
+  0x27, 0x87, 0xde, 0xb3, 0x7d, 0x24, 0xeb, 0x2e, 0x40, 0x8c, 0xad, 0xf4, 0x9c, 0x13, 0xe7, 0xc7,
+  0x8e, 0xda, 0x28, 0x95, 0xa5, 0x53, 0x97, 0x82, 0xba, 0x57, 0xd7, 0x6a, 0xb5, 0x94, 0x60, 0x55,
+  0xbd, 0x7c, 0x65, 0xff, 0x5d, 0xae, 0x9d, 0xe8, 0xed, 0xb6, 0x63, 0x4e, 0x71, 0x27, 0x5b, 0x88,
+  0x19, 0x89, 0x1d, 0x76, 0x47, 0xb8, 0xd3, 0x26, 0x77, 0xc0, 0x8b, 0x38, 0x76, 0x40, 0x79, 0x80,
+  0x4a, 0xa2, 0xd4, 0x61, 0xe3, 0x5b, 0x12, 0x81, 0xfc, 0x49, 0xb8, 0x90, 0xbe, 0xaa, 0x4e, 0x9d,
+  0x68, 0x86, 0x41, 0xc6, 0xc6, 0xce, 0x9c, 0xcc, 0xc7, 0x84, 0x8b, 0x40, 0x61, 0x5d, 0x83, 0xce,
+  0x02, 0xea, 0x1c, 0x89, 0x3f, 0x13, 0x61, 0xb0, 0xee, 0x67, 0x09, 0x25, 0x1a, 0xc8, 0xa4, 0x6e,
+  0x27, 0x11, 0xb0, 0x40, 0xf7, 0xa9, 0xc3, 0xb8, 0xb3, 0x48, 0xc5, 0x22, 0xcb, 0x18, 0x97, 0x24,
+  0x0e, 0x2a, 0x71, 0x01, 0x99, 0x9a, 0xcb, 0x1c, 0xc9, 0x88, 0x31, 0xa5, 0xad, 0x4a, 0x09, 0xe7,
+  0x55, 0x62, 0x0e, 0x52, 0x1d, 0x68, 0x56, 0xc2, 0x41, 0xc2, 0xb8, 0x35, 0x0d, 0xe7, 0xff, 0x60,
+  0x82, 0x6c, 0xb9, 0x82, 0x7a, 0xae, 0xe7, 0x55, 0x81, 0xde, 0x27, 0x29, 0xf8, 0x12, 0xe8, 0xea,
+  0x01, 0x5b, 0xf0, 0x08, 0x68, 0xa9, 0x0f, 0xdf, 0xcd, 0xe5, 0xdc, 0xb2, 0x12, 0xd7, 0x42, 0xc7,
+  0xa8, 0xd5, 0x07, 0xe4, 0x9b, 0x21, 0xcc, 0xa4, 0x14, 0x02, 0x49, 0x3c, 0x8e, 0x75, 0xfb, 0x87,
+  0x44, 0xc0, 0x0e, 0x23, 0x5c, 0x1d, 0x6a, 0x5a, 0x2c, 0xfa, 0xa4, 0x10, 0x71, 0x57, 0x9a, 0xd1,
+  0x00, 0xc3, 0x01, 0x3d, 0x4d, 0x5d, 0xd3, 0xec, 0xff, 0x3c, 0xb8, 0xfa, 0x18, 0x64, 0x98, 0x0b,
+  0xe2, 0x12, 0x9d, 0xcc, 0x0b, 0x99, 0x58, 0x13, 0x5c, 0xc6, 0xd8, 0xe8, 0xb3, 0x62, 0x44, 0x96,
+  0xb2, 0x8c, 0xa4, 0xa1, 0x96, 0x6e, 0x45, 0xaa, 0xaa, 0x28, 0x7b, 0x8e, 0x28, 0xc1, 0xbc, 0xe4,
+  0xaa, 0x6a, 0xe8, 0xae, 0x28, 0x63, 0xbd, 0x43, 0x4a, 0x48, 0xc2, 0x39, 0xe3, 0x1a, 0x73, 0x85,
+  0x94, 0xba, 0x16, 0x34, 0xc4, 0xa7, 0x38, 0xb3, 0xef, 0x20, 0xc9, 0x7c, 0xba, 0x39, 0x05, 0x8b,
+  0x54, 0x09, 0x8d, 0x6e, 0xbe, 0x0a, 0x60, 0x6a, 0xa9, 0x66, 0x28, 0x05, 0x82, 0x47, 0x21, 0x6a,
+  0x2b, 0x2b, 0x31, 0x63, 0x32, 0xb8, 0xcd, 0xa6, 0x3d, 0x29, 0xe0, 0x46, 0x60, 0xc7, 0x55, 0x2e,
+  0xf4, 0xc1, 0xc6, 0x56, 0xf6, 0x2b, 0xbb, 0x88, 0x83, 0xd0, 0x23, 0xf7, 0x7f, 0x99, 0x5f, 0x36,
+  0x25, 0x39, 0xcd, 0x56, 0xad, 0xf1, 0xc0, 0x2c, 0x97, 0xc5, 0x49, 0x75, 0x3f, 0x28, 0x9d, 0xf5,
+  0x2a, 0xb7, 0x9b, 0xf6, 0x30, 0x34, 0xfa, 0x47, 0xc5, 0x31, 0xb1, 0x5c, 0x21, 0x45, 0x47, 0x11,
+  0x52, 0xf3, 0x5f, 0xb9, 0xc5, 0x50, 0x86, 0xe3, 0x01, 0x91, 0x12, 0x96, 0x68, 0xf7, 0x4b, 0x0c,
+  0x30, 0x30, 0x12, 0x79, 0xa7, 0x17, 0xaf, 0x32, 0x06, 0xe2, 0x36, 0xac, 0xdf, 0x62, 0xb6, 0xc9,
+  0xf8, 0xa7, 0x0d, 0x67, 0xd3, 0xad, 0xbe, 0x44, 0x3e, 0x01, 0x73, 0xf6, 0x15, 0x31, 0x3f, 0x60,
+  0x8d, 0x42, 0xb1, 0xe4, 0xcb, 0xba, 0x08, 0xdb, 0xa4, 0x76, 0xd0, 0xc5, 0xf6, 0x53, 0x40, 0xc3,
+  0xcf, 0xe1, 0x66, 0xb9, 0xc1, 0x37, 0x74, 0x81, 0x67, 0x10, 0x6f, 0x33, 0x92, 0xc8, 0x42, 0x75,
+  0x11, 0x2a, 0xc8, 0xee, 0x3e, 0xf4, 0xff, 0x02, 0x1f, 0xfa, 0x30, 0x64, 0xb2, 0xa8, 0xcb, 0xbe,
+  0x6d, 0x8a, 0x19, 0xb4, 0x08, 0x5e, 0x50, 0xb9, 0x91, 0xf2, 0x6f, 0xd1, 0xce, 0x20, 0x6e, 0x93,
+  0x34, 0x5b, 0x48, 0x00, 0x83, 0x1d, 0xba, 0x20, 0x6a, 0xe5, 0xb4, 0x76, 0x1d, 0x41, 0xd3, 0xfa,
+  0x0d, 0x71, 0xf5, 0x75, 0x82, 0xc8, 0x33, 0xa3, 0x18, 0x86, 0xbf, 0xd9, 0x41, 0xf8, 0x7f, 0x7d,
+  0x75, 0x00, 0xdf, 0xe5, 0x53, 0x6f, 0xe7, 0x17, 0x86, 0x7a, 0x58, 0x35, 0xc4, 0x9d, 0x64, 0xd3,
+  0x29, 0x25, 0x43, 0x58, 0xd1, 0x4b, 0x00, 0x33, 0xd3, 0xac, 0x0f, 0x6b, 0x2c, 0x72, 0x61, 0xbb,
+  0x19, 0xf9, 0x85, 0x37, 0x8d, 0x75, 0x5e, 0x87, 0x7a, 0x15, 0x2e, 0x32, 0x61, 0xf3, 0x7a, 0x17,
+  0xea, 0xc3, 0x03, 0x28, 0x75, 0x77, 0x5f, 0x52, 0xef, 0xcb, 0x97, 0xce, 0x66, 0xaa, 0xc0, 0xbc,
+  0x07, 0xff, 0x80, 0xac, 0xbb, 0xaf, 0x27, 0x65, 0xa0, 0x77, 0xdc, 0x5b, 0xb3, 0x2f, 0x9b, 0x98,
+  0x51, 0xa3, 0xe4, 0xec, 0xd4, 0x37, 0x31, 0xfa, 0x9a, 0xc1, 0x94, 0x41, 0x1f, 0x43, 0x36, 0xc5,
+  0x6a, 0xb3, 0x73, 0x46, 0x77, 0xcf, 0x7f, 0x91, 0xba, 0x69, 0xee, 0x9e, 0xff, 0x44, 0x63, 0xfe,
+  0x53, 0x07, 0xd1, 0x4c, 0xce, 0x69, 0x88, 0xf2, 0x78, 0x2a, 0x3d, 0x03, 0x21, 0x30, 0xa0, 0x09,
+  0x1c, 0xdd, 0x6e, 0x0a, 0xfe, 0xf9, 0x14, 0x8f, 0x09, 0xf5, 0xe7, 0x49, 0xea, 0xc3, 0xc5, 0xaf,
+  0xcc, 0x6a, 0xaa, 0x6b, 0x2b, 0x44, 0x6f, 0xe2, 0xe4, 0xce, 0x89, 0x40, 0xe4, 0x89, 0x70, 0x4f,
+  0x1b, 0xee, 0x9d, 0xa0, 0x96, 0xfe, 0x68, 0xa1, 0x37, 0x6d, 0x68, 0x3c, 0x29, 0xf3, 0x4a, 0xd1,
+  0x43, 0xaf, 0xa3, 0x23, 0x1f, 0x33, 0x12, 0xee, 0x71, 0x25, 0xc7, 0xf6, 0x1c, 0x00, 0x0f, 0xf7,
+  0x50, 0x0b, 0xfe, 0xb4, 0x10, 0x94, 0xf0, 0x83, 0x2e, 0xe1, 0x07, 0x55, 0x32, 0x11, 0x0c, 0x65,
+  0xf1, 0x49, 0xb9, 0x73, 0xa3, 0xea, 0x92, 0x38, 0xdc, 0x8b, 0x24, 0x1d, 0xa1, 0x96, 0xaa, 0x82,
+  0x9a, 0x93, 0x5a, 0xce, 0xb1, 0x67, 0x32, 0xd4, 0x0b, 0x65, 0xcd, 0x64, 0xe5, 0xd6, 0x13, 0xcd,
+  0x48, 0xf4, 0x99, 0xc4, 0x61, 0x8e, 0xde, 0x43, 0x79, 0x05, 0xa4, 0x9a, 0x35, 0xcf, 0xff, 0xb7,
+  0xb9, 0x6a, 0xe0, 0x31, 0x7b, 0x68, 0x70, 0x1f, 0x2e, 0xd2, 0xf9, 0xb0, 0x2d, 0x54, 0x9f, 0x4a,
+  0xc3, 0xd0, 0xb0, 0xfa, 0xfb, 0x53, 0xce, 0x16, 0xd9, 0xbe, 0x7e, 0x70, 0xda, 0x3b, 0x39, 0x7f,
+  0x80, 0xf8, 0x5f, 0x70, 0x52, 0xf3, 0xa1, 0x5a, 0x44, 0x84, 0xc9, 0x88, 0x82, 0xd6, 0xa3, 0xc8,
+  0x47, 0xa7, 0xe7, 0x4e, 0xfe, 0xb9, 0x7f, 0xe8, 0x1f, 0x7a, 0x0d, 0xa6, 0xd1, 0x48, 0x13, 0xae,
+  0x6d, 0xfb, 0x4e, 0xfe, 0xdd, 0xf1, 0x0f, 0x0e, 0xcb, 0x0b, 0xa0, 0x6d, 0x3e, 0x8d, 0x46, 0x53,
+  0x9c, 0xa4, 0xca, 0xfa, 0x5d, 0xdf, 0x31, 0x9f, 0x1d, 0x90, 0x01, 0x95, 0x69, 0xce, 0xbf, 0x42,
+  0x3e, 0x34, 0xa0, 0x87, 0xc5, 0x96, 0xdd, 0x65, 0x6e, 0x7d, 0x46, 0x19, 0xdf, 0x34, 0xb1, 0x31,
+  0x4f, 0xa6, 0x33, 0x99, 0x12, 0x01, 0x1a, 0x15, 0x9d, 0x59, 0x85, 0xe6, 0xc9, 0x45, 0x2a, 0xce,
+  0xe0, 0x3a, 0x02, 0xc6, 0xfd, 0xf2, 0xb3, 0xd9, 0x54, 0x40, 0x16, 0xe3, 0x58, 0xed, 0x21, 0x30,
+  0x1e, 0x58, 0x85, 0x66, 0xf3, 0x98, 0xa4, 0x2c, 0x11, 0x8a, 0xb4, 0xb7, 0xc5, 0x57, 0xc7, 0x7f,
+  0xdd, 0x40, 0xc2, 0xfd, 0x58, 0x71, 0xf0, 0xeb, 0x19, 0x6a, 0x6c, 0x2b, 0xb9, 0xfc, 0xf5, 0xcc,
+  0x70, 0xf9, 0x15, 0x44, 0xbd, 0x23, 0x6c, 0x4e, 0x20, 0x77, 0xac, 0x72, 0x55, 0xc0, 0xcf, 0xe6,
+  0x89, 0xd2, 0x7b, 0x80, 0xfe, 0x13, 0xe3, 0x09, 0x88, 0x18, 0x89, 0xa9, 0x93, 0xd7, 0xad, 0x3b,
+  0x73, 0x37, 0xa1, 0x49, 0x06, 0xb6, 0xff, 0x21, 0x5c, 0x26, 0x70, 0xbd, 0x74, 0x74, 0xf9, 0x2b,
+  0xdc, 0xf9, 0xd7, 0x02, 0xd3, 0x44, 0x3e, 0x6e, 0x5a, 0x39, 0x31, 0xc3, 0x3c, 0xcb, 0x17, 0x6e,
+  0x50, 0x7d, 0xef, 0x1f, 0xf9, 0x47, 0xeb, 0xec, 0xfe, 0x6e, 0xb0, 0xc0, 0xf4, 0xe7, 0xeb, 0xf3,
+  0x77, 0x4e, 0x59, 0xfc, 0xc1, 0xff, 0xf1, 0x68, 0xb3, 0x4b, 0x79, 0x84, 0x5e, 0x70, 0x08, 0x31,
+  0x91, 0x3c, 0xd5, 0xa3, 0xa3, 0xb0, 0x17, 0x84, 0xaa, 0x2b, 0x62, 0x11, 0x90, 0x93, 0xc2, 0xb8,
+  0x4c, 0x28, 0x26, 0x49, 0x4c, 0x44, 0x7e, 0xa4, 0x87, 0x9f, 0x20, 0x14, 0xfc, 0x43, 0xff, 0xc8,
+  0xff, 0xbb, 0x1a, 0xde, 0xff, 0x87, 0xff, 0xda, 0xff, 0xe7, 0x4d, 0x9e, 0x3f, 0x19, 0x77, 0x55,
+  0x52, 0x4d, 0xc2, 0x4e, 0x37, 0x79, 0x53, 0x76, 0x09, 0x28, 0x49, 0xa7, 0x72, 0xd6, 0x4d, 0x5a,
+  0xad, 0x95, 0xd4, 0x33, 0x09, 0x4b, 0xa3, 0x4f, 0xc9, 0x4d, 0xfd, 0x4a, 0x0e, 0x8e, 0x85, 0xae,
+  0x08, 0x4a, 0x87, 0xc2, 0x70, 0xe2, 0xf5, 0x90, 0x63, 0xfc, 0x6d, 0xce, 0x4e, 0x4c, 0x43, 0x55,
+  0xf9, 0x72, 0x02, 0x89, 0x05, 0xb2, 0xa6, 0xca, 0x4e, 0x27, 0xba, 0xf4, 0xa6, 0x6d, 0x4c, 0x9a,
+  0x33, 0x4c, 0xdb, 0x60, 0x9f, 0x6c, 0x7d, 0x2f, 0x83, 0xc3, 0x27, 0x92, 0x9c, 0xc2, 0xc9, 0x13,
+  0x24, 0x29, 0xdc, 0x22, 0x7e, 0x1a, 0x5e, 0x7e, 0x08, 0x15, 0x4a, 0x5d, 0x59, 0xa9, 0x79, 0x30,
+  0x4a, 0x02, 0xca, 0xa6, 0xba, 0x93, 0xa3, 0x3a, 0x39, 0xc4, 0x6c, 0x42, 0xe2, 0x75, 0x1b, 0x94,
+  0x17, 0xce, 0x32, 0xfa, 0x68, 0xce, 0xc4, 0xfa, 0x9d, 0x40, 0xff, 0x1c, 0x82, 0x1f, 0xd5, 0x91,
+  0xa9, 0x7f, 0x1e, 0xb1, 0x52, 0xfc, 0x94, 0xe3, 0xb1, 0x9b, 0xe6, 0xcc, 0x2a, 0xbb, 0x17, 0x5f,
+  0xd1, 0x4c, 0xd2, 0xb5, 0x8e, 0x4c, 0x38, 0x0f, 0xec, 0x03, 0x33, 0x1f, 0xe4, 0x53, 0x7a, 0x13,
+  0xba, 0xea, 0x6d, 0x4d, 0x25, 0x6e, 0x50, 0xf3, 0x45, 0xea, 0x46, 0x5e, 0x4f, 0x55, 0xe7, 0xb9,
+  0xba, 0x77, 0x70, 0xdc, 0xf1, 0x8e, 0x4b, 0xf1, 0x02, 0x0d, 0x46, 0x9a, 0x68, 0x1e, 0xe0, 0x9f,
+  0x76, 0xcd, 0x4e, 0x52, 0xba, 0xc5, 0xd4, 0x96, 0xb9, 0xc8, 0xaa, 0xb3, 0x92, 0x8e, 0x5d, 0x5b,
+  0x86, 0x87, 0x55, 0x59, 0x24, 0x1c, 0xab, 0xaa, 0xcc, 0xf2, 0xb5, 0xba, 0x22, 0x9d, 0xdb, 0x95,
+  0x45, 0xd2, 0xae, 0x1b, 0x1e, 0xd6, 0xca, 0x90, 0xa8, 0xea, 0xc5, 0xb5, 0x2e, 0x33, 0x3b, 0x79,
+  0x98, 0xaa, 0xbb, 0x2a, 0x4b, 0x98, 0x8a, 0x22, 0x54, 0x75, 0x95, 0x5a, 0x9c, 0x89, 0x78, 0x79,
+  0x71, 0xca, 0xfd, 0x6e, 0xba, 0x14, 0xcb, 0x81, 0xaa, 0xfa, 0x9b, 0x4a, 0x2d, 0x4e, 0x84, 0x45,
+  0x78, 0xb3, 0x10, 0x54, 0x9b, 0x15, 0xec, 0xf1, 0x1c, 0x92, 0x4b, 0x11, 0x7c, 0x90, 0x26, 0x67,
+  0x2c, 0x3e, 0x46, 0xd7, 0x57, 0x83, 0x21, 0xf2, 0x8b, 0x20, 0x22, 0x18, 0x72, 0x8d, 0x38, 0x7e,
+  0x46, 0xf9, 0xd5, 0x63, 0x7f, 0x08, 0x6b, 0x0f, 0x61, 0xa6, 0xf6, 0x24, 0x64, 0x40, 0xb5, 0x2a,
+  0x6d, 0x25, 0x9f, 0xd0, 0xb2, 0xe8, 0xa2, 0xae, 0x52, 0xc7, 0xfa, 0xf1, 0x43, 0xe8, 0xb7, 0xb7,
+  0x64, 0xf2, 0xe8, 0xe6, 0x0e, 0x7b, 0xe5, 0x2b, 0x47, 0x93, 0xca, 0xeb, 0x6e, 0xde, 0xf9, 0xb9,
+  0xea, 0x14, 0x9b, 0x64, 0x67, 0x54, 0x89, 0xcd, 0x7c, 0x3f, 0xec, 0x38, 0x00, 0x90, 0x01, 0x56,
+  0xd7, 0x8a, 0x0a, 0x57, 0x13, 0xe2, 0x1b, 0xea, 0x9e, 0xb7, 0x53, 0xd7, 0xd3, 0xff, 0x83, 0x96,
+  0xd6, 0x7f, 0x5b, 0xe8, 0x7b, 0x93, 0x61, 0x40, 0x5b, 0x97, 0xe4, 0x6f, 0x72, 0xc2, 0x1e, 0xfe,
+  0x42, 0xfd, 0x6a, 0xa1, 0x7e, 0x11, 0xd4, 0x63, 0x16, 0xa3, 0xe9, 0xdf, 0x32, 0x7a, 0xea, 0x77,
+  0x42, 0x8d, 0x97, 0xff, 0x6e, 0xa8, 0x9e, 0x2a, 0x56, 0x2e, 0x14, 0x0d, 0x0f, 0x63, 0x46, 0xa8,
+  0x03, 0x55, 0x05, 0x98, 0xae, 0x45, 0x2f, 0x61, 0xd4, 0x20, 0x58, 0xd6, 0x80, 0xc0, 0xb2, 0x2d,
+  0x00, 0xf9, 0xf3, 0xdb, 0xfa, 0x6b, 0x99, 0x22, 0x01, 0xf9, 0xd5, 0x2b, 0xcb, 0xfa, 0x4d, 0xc9,
+  0x59, 0xbf, 0x25, 0xe9, 0x47, 0x50, 0xfb, 0x95, 0xcf, 0xaa, 0x2a, 0x1f, 0x82, 0xba, 0x25, 0x5e,
+  0x03, 0xc9, 0xf0, 0xef, 0xbf, 0x15, 0x14, 0x3f, 0x07, 0xb5, 0x1f, 0x00, 0x00,
+};
+
+// index.html: 4971 bytes raw, 1308 bytes gzip
+static const char   WEB_INDEX_ETAG[] = "\"6f406863964fd83e\"";
+static const size_t WEB_INDEX_GZ_LEN = 1308;
+const uint8_t WEB_INDEX_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x58, 0xdb, 0x52, 0xe3, 0x38,
+  0x10, 0x7d, 0xe7, 0x2b, 0xb4, 0x2f, 0xeb, 0x50, 0x45, 0x6e, 0x30, 0x64, 0x59, 0x36, 0x0e, 0xc5,
+  0x86, 0x30, 0xc3, 0xd4, 0xb0, 0xa4, 0x70, 0xa6, 0xb6, 0x76, 0x5e, 0x52, 0x8a, 0xdd, 0xb1, 0x35,
+  0xf8, 0xa2, 0x92, 0xe4, 0x84, 0xf0, 0xf5, 0xdb, 0x92, 0xed, 0xc4, 0x90, 0xc4, 0x04, 0xc8, 0x3c,
+  0x60, 0x62, 0xb9, 0x2f, 0xe7, 0xa8, 0xbb, 0xd5, 0x6d, 0x77, 0x7f, 0xbb, 0xba, 0xeb, 0x8f, 0xfe,
+  0x1b, 0x0e, 0x48, 0xa0, 0xa2, 0xb0, 0xd7, 0xcd, 0xaf, 0x40, 0xbd, 0x5e, 0x37, 0x02, 0x45, 0x89,
+  0x1b, 0x50, 0x21, 0x41, 0xd9, 0x56, 0xaa, 0xa6, 0xf5, 0x33, 0xab, 0x77, 0x90, 0x2d, 0xc7, 0x34,
+  0x02, 0xdb, 0x9a, 0x31, 0x98, 0xf3, 0x44, 0x28, 0x8b, 0xb8, 0x49, 0xac, 0x20, 0x46, 0xb1, 0x39,
+  0xf3, 0x54, 0x60, 0x7b, 0x30, 0x63, 0x2e, 0xd4, 0xcd, 0xcd, 0x11, 0x8b, 0x99, 0x62, 0x34, 0xac,
+  0x4b, 0x97, 0x86, 0x60, 0xb7, 0xb5, 0x0d, 0xc5, 0x54, 0x08, 0xbd, 0x81, 0x33, 0x3c, 0x39, 0xae,
+  0xf7, 0x2f, 0x6f, 0xbb, 0xcd, 0x6c, 0xe1, 0xa0, 0x1b, 0xb2, 0xf8, 0x81, 0x08, 0x08, 0x6d, 0x8b,
+  0xa1, 0x49, 0x8b, 0xa8, 0x05, 0x47, 0x3f, 0x2c, 0xa2, 0x3e, 0x34, 0x79, 0xec, 0x5b, 0x24, 0x10,
+  0x30, 0xb5, 0xad, 0xe6, 0x94, 0xce, 0xb4, 0x40, 0x03, 0x2f, 0xd6, 0x33, 0x35, 0xa9, 0x16, 0x21,
+  0xc8, 0x00, 0x40, 0x2d, 0x65, 0x29, 0xe7, 0x0d, 0x57, 0xca, 0x8b, 0x99, 0x3d, 0x6d, 0x4d, 0x4e,
+  0x4e, 0x60, 0x7a, 0x0a, 0xee, 0x27, 0xf8, 0xb3, 0x73, 0xda, 0xd1, 0xaa, 0xd2, 0x15, 0x8c, 0x2b,
+  0x22, 0x85, 0x9b, 0x8b, 0xfe, 0xd4, 0x92, 0x6e, 0xbb, 0x73, 0x76, 0xdc, 0x6a, 0xfd, 0xd1, 0xf2,
+  0x4e, 0xda, 0x5e, 0x07, 0x90, 0x78, 0xb7, 0x99, 0x49, 0xa2, 0x4a, 0x33, 0xdb, 0x9f, 0x49, 0xe2,
+  0x2d, 0xf0, 0x4e, 0xdf, 0x80, 0xe8, 0x75, 0x3d, 0x36, 0xc3, 0x9d, 0x6b, 0x13, 0xe6, 0xd9, 0x96,
+  0xa1, 0x63, 0x95, 0x09, 0x06, 0xed, 0x5e, 0x57, 0x72, 0x1a, 0x9b, 0xc7, 0x81, 0x27, 0xc6, 0x8c,
+  0x5b, 0xbd, 0x7a, 0x1d, 0xad, 0xe2, 0x22, 0x1a, 0x37, 0xda, 0xe6, 0x62, 0xa4, 0xdc, 0x90, 0x4a,
+  0x69, 0x5b, 0x21, 0x9d, 0x40, 0x68, 0xf5, 0xfa, 0xc3, 0xef, 0x44, 0x41, 0xc4, 0xcf, 0x49, 0x21,
+  0x5f, 0x16, 0x9a, 0xd1, 0x30, 0x05, 0x6b, 0x69, 0x58, 0x0b, 0xae, 0x9b, 0x6e, 0xe6, 0x30, 0x31,
+  0x7e, 0x94, 0xc5, 0xc6, 0x55, 0xa1, 0xef, 0x0b, 0xe6, 0xe9, 0x9d, 0x28, 0x2d, 0xb9, 0x54, 0xe0,
+  0x52, 0x37, 0x38, 0xee, 0x39, 0x0b, 0x89, 0x06, 0x51, 0xfd, 0xf8, 0xb9, 0x84, 0x48, 0xe6, 0x2f,
+  0x75, 0x12, 0x44, 0x5a, 0x5e, 0xc8, 0xc1, 0x5f, 0x99, 0x5c, 0x58, 0x31, 0xdc, 0x00, 0x3b, 0x4b,
+  0x97, 0x0c, 0x74, 0x86, 0x56, 0x5f, 0x77, 0xb2, 0x7e, 0x33, 0xac, 0xb4, 0x5c, 0xec, 0x72, 0xd9,
+  0xea, 0xba, 0xf1, 0xdd, 0xc9, 0x7c, 0xe7, 0x8a, 0x45, 0xd5, 0x64, 0x52, 0x23, 0xf2, 0x2e, 0x32,
+  0xff, 0xb2, 0x6b, 0x46, 0xee, 0x1d, 0xe7, 0xa6, 0xd2, 0x81, 0x90, 0x92, 0xed, 0x97, 0xd5, 0x17,
+  0xa0, 0x9c, 0x4c, 0x05, 0x54, 0x13, 0xc3, 0x0c, 0xe2, 0xef, 0xa2, 0x35, 0x74, 0xee, 0x2f, 0x6f,
+  0x5f, 0xb7, 0xcf, 0xa5, 0xa0, 0xd1, 0x7e, 0x89, 0x8d, 0x30, 0x12, 0x4f, 0x49, 0x5c, 0xed, 0x57,
+  0x3d, 0x8d, 0x3d, 0x26, 0x79, 0x48, 0x17, 0x3b, 0xb0, 0x9b, 0xa4, 0x4a, 0x25, 0x31, 0x49, 0x62,
+  0x37, 0x64, 0xee, 0x03, 0x9e, 0x37, 0xa0, 0xfe, 0x46, 0x3c, 0x12, 0xc4, 0xe8, 0x47, 0xed, 0x10,
+  0x13, 0x44, 0x02, 0xc9, 0x17, 0xc8, 0xca, 0x7b, 0xa6, 0xb5, 0x17, 0x4a, 0xe6, 0x4c, 0x31, 0xa6,
+  0x2b, 0x49, 0x81, 0xe4, 0x63, 0x9d, 0x87, 0x6f, 0xa0, 0xb6, 0xee, 0xab, 0x4c, 0xa4, 0xd2, 0xdb,
+  0x24, 0x13, 0x1c, 0x6f, 0xce, 0xfc, 0x8f, 0xd0, 0xbd, 0x82, 0x10, 0xdb, 0x4d, 0xad, 0x40, 0x52,
+  0x27, 0x86, 0xff, 0x61, 0x75, 0x40, 0x0d, 0x6f, 0xad, 0xf8, 0x2e, 0xd6, 0xfd, 0x54, 0x08, 0xec,
+  0x65, 0x86, 0x35, 0xa9, 0xa1, 0xbf, 0x6a, 0x6f, 0x6e, 0xfa, 0x2b, 0x78, 0xeb, 0x23, 0x7f, 0x84,
+  0x27, 0x79, 0xb5, 0x6b, 0x9e, 0x9a, 0xe3, 0xfe, 0x43, 0x41, 0xee, 0xf7, 0xaf, 0xc8, 0x3d, 0x9d,
+  0x57, 0x3b, 0x72, 0xbd, 0xb1, 0xa0, 0xf3, 0x4a, 0x8a, 0xa6, 0xf3, 0xda, 0x56, 0x44, 0x85, 0xcf,
+  0xe2, 0xba, 0x4a, 0xf8, 0x79, 0x87, 0x3f, 0xfe, 0xa5, 0xe9, 0xae, 0xd5, 0xcc, 0x22, 0x76, 0xfb,
+  0x61, 0xe2, 0x3e, 0xe8, 0x82, 0x71, 0xf0, 0x86, 0x98, 0x3b, 0x52, 0x9b, 0x33, 0x15, 0x90, 0xd1,
+  0x8f, 0xc3, 0x65, 0xc1, 0x1c, 0x6c, 0xdf, 0xca, 0x55, 0x8b, 0x1a, 0x0a, 0xd0, 0x83, 0xc8, 0x7a,
+  0x8f, 0xca, 0x09, 0x7e, 0x63, 0x33, 0x20, 0xb7, 0x5f, 0x87, 0x83, 0xcf, 0xa4, 0x36, 0xa5, 0x61,
+  0x28, 0xc9, 0x84, 0xa2, 0x37, 0x95, 0x10, 0x19, 0x53, 0x2e, 0x83, 0x44, 0xc9, 0xc3, 0xc2, 0x01,
+  0x8b, 0x7c, 0x43, 0x58, 0x3f, 0xb1, 0x08, 0x0d, 0x71, 0xa2, 0xe1, 0x99, 0x79, 0xeb, 0x15, 0x14,
+  0x0e, 0x28, 0xc5, 0x62, 0x5f, 0x7e, 0xa4, 0x55, 0xea, 0x80, 0x83, 0xa0, 0x2a, 0x15, 0x08, 0x38,
+  0xf1, 0x5e, 0x39, 0xb6, 0x74, 0xe0, 0x23, 0x94, 0xfa, 0xc0, 0xe9, 0xa5, 0x12, 0xdf, 0x0f, 0x41,
+  0xbb, 0xd5, 0xee, 0x74, 0x38, 0x46, 0x66, 0x85, 0xf4, 0x9b, 0xd7, 0x7b, 0x3d, 0xb5, 0x1c, 0x25,
+  0x80, 0x46, 0xe4, 0x0a, 0xa6, 0x34, 0x0d, 0x55, 0x25, 0x2f, 0x69, 0x44, 0xb1, 0x7e, 0x8d, 0xe8,
+  0x87, 0xc9, 0x65, 0x9e, 0x73, 0xc7, 0x25, 0x86, 0x2f, 0x11, 0xed, 0x91, 0xec, 0x08, 0x4b, 0x00,
+  0x14, 0x69, 0x12, 0xea, 0xaa, 0x94, 0x86, 0xe4, 0x7a, 0xe8, 0x54, 0x32, 0x9e, 0x72, 0xf9, 0x06,
+  0x9a, 0x2c, 0xe6, 0xa9, 0xca, 0x07, 0xe3, 0x38, 0x8d, 0x26, 0x20, 0x56, 0x56, 0xcc, 0x33, 0x8b,
+  0x44, 0x2c, 0xb6, 0xad, 0x16, 0xfe, 0xa7, 0x8f, 0xb6, 0xd5, 0xc1, 0x1f, 0x79, 0x6d, 0x9a, 0x79,
+  0xfc, 0xbc, 0xd3, 0xe2, 0x8f, 0x1b, 0xcb, 0x12, 0x54, 0x86, 0xfc, 0x9a, 0x4b, 0x53, 0x99, 0xc8,
+  0xc1, 0x40, 0xdf, 0x7f, 0x1e, 0x48, 0x45, 0x15, 0xec, 0x92, 0x05, 0x46, 0xf0, 0x1d, 0xb1, 0xc7,
+  0x41, 0x3e, 0x5c, 0xf4, 0x97, 0x71, 0x37, 0x7c, 0xee, 0x01, 0x19, 0x92, 0xfe, 0x2a, 0xe8, 0x72,
+  0x47, 0x6a, 0x15, 0x47, 0xdb, 0xeb, 0xf3, 0x81, 0xa2, 0x42, 0x65, 0xac, 0xcd, 0x9e, 0xea, 0xdb,
+  0x3c, 0xf7, 0xd6, 0xbc, 0xef, 0x60, 0x2c, 0xe1, 0x65, 0x5b, 0x09, 0xdf, 0x66, 0x6a, 0xf7, 0x18,
+  0x6d, 0xc8, 0x82, 0x6b, 0x7c, 0x1e, 0xd4, 0x5a, 0xe8, 0xc2, 0xfc, 0x22, 0x77, 0xd3, 0xe9, 0x3b,
+  0xb0, 0x16, 0x76, 0x3a, 0x9f, 0x96, 0x86, 0xbe, 0x25, 0xf3, 0x5f, 0x81, 0xf4, 0xf8, 0xf4, 0x74,
+  0xe9, 0xe2, 0x0b, 0xf3, 0x83, 0xd7, 0xc1, 0xae, 0x27, 0xa6, 0xd1, 0xae, 0xae, 0x52, 0x2d, 0xb1,
+  0x2d, 0x21, 0x2b, 0xdb, 0x14, 0x71, 0x69, 0x54, 0x5f, 0x75, 0x0a, 0xcc, 0x40, 0x3c, 0xe4, 0x49,
+  0x1f, 0x5f, 0x99, 0x45, 0x12, 0x96, 0x1b, 0x86, 0x69, 0xb5, 0x98, 0xf5, 0xae, 0x12, 0xa1, 0xb4,
+  0x36, 0xc2, 0x47, 0x4b, 0xd3, 0x24, 0x51, 0x58, 0xf4, 0x1b, 0x2a, 0xb8, 0xc8, 0x7a, 0x34, 0x5f,
+  0xb4, 0x23, 0x9d, 0x28, 0x97, 0x7a, 0x99, 0xe4, 0x6e, 0x57, 0x7d, 0x6a, 0x4b, 0x8f, 0xdd, 0xd2,
+  0xe4, 0x36, 0x14, 0x41, 0xfb, 0x38, 0xaf, 0x02, 0x24, 0x70, 0x39, 0xbc, 0xd9, 0xda, 0x80, 0x31,
+  0xe9, 0x55, 0x2a, 0xc9, 0x57, 0xe7, 0xee, 0x9f, 0x0d, 0xd6, 0xb3, 0x2d, 0xee, 0x75, 0x5d, 0xec,
+  0x40, 0xbd, 0xcf, 0x83, 0x11, 0xc1, 0xb7, 0x70, 0xd6, 0x94, 0x46, 0xa7, 0xdb, 0x34, 0xab, 0x47,
+  0x24, 0x11, 0x84, 0xa7, 0xf8, 0x5a, 0xef, 0x11, 0x2a, 0xf5, 0x37, 0x89, 0xd8, 0x07, 0x89, 0xbc,
+  0x49, 0x49, 0x0b, 0x66, 0x38, 0xb4, 0x15, 0x1a, 0xa4, 0xe6, 0x80, 0x98, 0x81, 0xa8, 0x3b, 0x7a,
+  0x92, 0x1b, 0x98, 0x47, 0x87, 0x1b, 0x9c, 0x17, 0x08, 0xf3, 0x41, 0x60, 0x27, 0x78, 0xc5, 0xd4,
+  0xd0, 0xf8, 0xc9, 0xfd, 0xa5, 0xbb, 0xc1, 0x88, 0xfa, 0x47, 0x39, 0x9c, 0x8c, 0x00, 0xa8, 0x71,
+  0x21, 0x39, 0xa6, 0x3e, 0x5c, 0x44, 0xd2, 0xce, 0xa5, 0x2b, 0x80, 0x64, 0x63, 0x8a, 0xcc, 0x8b,
+  0x7a, 0x17, 0x30, 0xb9, 0x68, 0x0e, 0x43, 0x80, 0xc7, 0x04, 0xb8, 0x4a, 0xea, 0xf1, 0x46, 0x05,
+  0xc5, 0xdc, 0xa3, 0x3f, 0xd2, 0x1c, 0x91, 0xbc, 0xa5, 0x92, 0xb3, 0x76, 0x05, 0x82, 0x3c, 0x2d,
+  0xdf, 0x12, 0x28, 0xa1, 0x96, 0x71, 0x2a, 0x6f, 0x00, 0xa6, 0x48, 0xb1, 0x7e, 0x50, 0x5a, 0x37,
+  0x75, 0x74, 0x81, 0xc6, 0xec, 0x56, 0x1d, 0x2b, 0x77, 0xa3, 0x2a, 0xee, 0x1d, 0xb6, 0xb3, 0x0b,
+  0xfc, 0x43, 0xa1, 0x4e, 0x2b, 0x97, 0xd9, 0x0e, 0x5a, 0x8f, 0xea, 0xcd, 0xe7, 0x2f, 0x7b, 0xdb,
+  0xa1, 0x0f, 0xef, 0x9c, 0x02, 0x3b, 0xfa, 0x51, 0x4f, 0x17, 0xea, 0xc9, 0x6e, 0x34, 0x1a, 0x2f,
+  0xb0, 0x96, 0xa4, 0x70, 0x42, 0x1d, 0xbb, 0x7a, 0x42, 0xbd, 0x00, 0x9e, 0xb8, 0x81, 0x16, 0xfe,
+  0xfd, 0x99, 0xce, 0xcb, 0x0a, 0xca, 0x3e, 0xb1, 0x34, 0xcd, 0x07, 0x22, 0xac, 0x0a, 0xfd, 0x4d,
+  0xed, 0xe0, 0xe0, 0x7f, 0xa4, 0xe0, 0x3c, 0xee, 0x6b, 0x13, 0x00, 0x00,
+};
@@ -0,0 +1,88 @@
+"""
+Embed the web UI into firmware.
+
+Gzips the files in web/ and writes src/web_assets.h with the compressed
+bytes in PROGMEM, each with an ETag derived from its content. References
+to /app.css and /app.js in index.html get a ?v=<etag> suffix, so those two
+can be cached by browsers for a year while index.html itself is always
+revalidated and picks up new versions after an update.
+
+Output is deterministic (gzip mtime is fixed), so regenerating unchanged
+files leaves the header untouched.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+or by hand:  python tools/embed_web.py
+"""
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 -- provided by PlatformIO/SCons
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "src", "web_assets.h")
+
+# (file in web/, C identifier prefix); versioned assets first so index.html
+# can reference their ETags.
+ASSETS = [
+    ("app.css", "WEB_APP_CSS"),
+    ("app.js", "WEB_APP_JS"),
+    ("index.html", "WEB_INDEX"),
+]
+
+
+def etag_of(raw):
+    return hashlib.sha1(raw).hexdigest()[:16]
+
+
+def emit(lines, name, prefix, raw):
+    gz = gzip.compress(raw, compresslevel=9, mtime=0)
+    lines += [
+        "// %s: %d bytes raw, %d bytes gzip" % (name, len(raw), len(gz)),
+        'static const char   %s_ETAG[] = "\\"%s\\"";' % (prefix, etag_of(raw)),
+        "static const size_t %s_GZ_LEN = %d;" % (prefix, len(gz)),
+        "const uint8_t %s_GZ[] PROGMEM = {" % prefix,
+    ]
+    for i in range(0, len(gz), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    lines += ["};", ""]
+
+
+def main():
+    lines = [
+        "#pragma once",
+        "#include <pgmspace.h>",
+        "",
+        "/*",
+        " * Web UI from web/, gzip-compressed, in PROGMEM.",
+        " * Generated by tools/embed_web.py -- edit web/ and rebuild, not this file.",
+        " */",
+        "",
+    ]
+    versions = {}
+    for name, prefix in ASSETS:
+        with open(os.path.join(WEB, name), "rb") as f:
+            raw = f.read()
+        if name == "index.html":
+            for asset, tag in versions.items():
+                raw = raw.replace(("'/%s'" % asset).encode(),
+                                  ("'/%s?v=%s'" % (asset, tag)).encode())
+        versions[name] = etag_of(raw)
+        emit(lines, name, prefix, raw)
+
+    text = "\n".join(lines)
+    if os.path.exists(OUT):
+        with open(OUT) as f:
+            if f.read() == text:
+                return
+    with open(OUT, "w") as f:
+        f.write(text)
+    print("embed_web: wrote %s" % os.path.relpath(OUT, ROOT))
+
+
+main()
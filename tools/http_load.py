@@ -0,0 +1,186 @@
+"""
+HTTP load test: does web traffic slow the RTSP stream down?
+
+Plays the RTSP stream (RTP over the RTSP TCP connection) and counts frames
+per second with no HTTP load, then again while a number of HTTP clients
+hammer the web server. Each HTTP worker loops over --paths (by default
+/api/status, /api/cam_settings and /snapshot.jpg); every other worker reads
+its responses slowly (--slow-bps), like a phone on a weak link, which is
+what used to hold the synchronous server -- and everything behind it -- up.
+
+Works against the device or the host simulator (env:native), e.g.
+
+    .pio/build/native/program --frames <dir> &
+    python tools/http_load.py --host 127.0.0.1 --http-port 8080 --rtsp-port 8554 \
+        --paths /api/status,/snapshot.jpg
+
+Prints one JSON object: RTSP fps idle vs. under load, and HTTP request
+counts and latencies. Python 3 standard library only.
+"""
+
+import argparse
+import json
+import socket
+import struct
+import threading
+import time
+
+
+def rtsp_fps(host, port, path, seconds, on_frame=None):
+    """Frames per second received over RTSP/TCP (RTP marker bits).
+
+    on_frame, if given, is called with the arrival time of each frame.
+    """
+    s = socket.create_connection((host, port), timeout=5)
+    f = s.makefile("rb")
+    url = "rtsp://%s:%d/%s" % (host, port, path)
+    cseq = [0]
+
+    def request(method, target, extra=""):
+        cseq[0] += 1
+        s.sendall(("%s %s RTSP/1.0\r\nCSeq: %d\r\n%s\r\n" % (method, target, cseq[0], extra)).encode())
+        head = b""
+        while not head.endswith(b"\r\n\r\n"):
+            byte = f.read(1)
+            if not byte:
+                raise IOError("RTSP connection closed")
+            head += byte
+        text = head.decode(errors="replace")
+        length = 0
+        for line in text.split("\r\n"):
+            if line.lower().startswith("content-length:"):
+                length = int(line.split(":", 1)[1])
+        if length:
+            f.read(length)
+        if " 200 " not in text.split("\r\n", 1)[0] + " ":
+            raise IOError("RTSP %s failed: %s" % (method, text.split("\r\n", 1)[0]))
+        return text
+
+    request("DESCRIBE", url, "Accept: application/sdp\r\n")
+    reply = request("SETUP", url + "/track1", "Transport: RTP/AVP/TCP;unicast;interleaved=0-1\r\n")
+    session = ""
+    for line in reply.split("\r\n"):
+        if line.lower().startswith("session:"):
+            session = line.split(":", 1)[1].split(";")[0].strip()
+    request("PLAY", url, "Session: %s\r\n" % session)
+
+    frames = 0
+    start = time.time()
+    while time.time() - start < seconds:
+        head = f.read(4)
+        if len(head) < 4 or head[0:1] != b"$":
+            raise IOError("RTSP stream broken")
+        payload = f.read(struct.unpack(">H", head[2:4])[0])
+        if head[1] == 0 and payload[1] & 0x80:
+            frames += 1
+            if on_frame:
+                on_frame(time.time())
+    elapsed = time.time() - start
+    try:
+        s.sendall(("TEARDOWN %s RTSP/1.0\r\nCSeq: %d\r\nSession: %s\r\n\r\n"
+                   % (url, cseq[0] + 1, session)).encode())
+    except OSError:
+        pass
+    s.close()
+    return frames / elapsed
+
+
+def http_get(host, port, path, slow_bps):
+    """One GET; returns (status, bytes) after reading the whole response."""
+    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    if slow_bps:
+        # Small window, as on a lossy WiFi link: the sender has to wait for us
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+    s.settimeout(15)
+    s.connect((host, port))
+    s.sendall(("GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n" % (path, host)).encode())
+    chunk = 1024 if slow_bps else 16384
+    data = b""
+    while True:
+        block = s.recv(chunk)
+        if not block:
+            break
+        data += block
+        if slow_bps:
+            time.sleep(float(len(block)) / slow_bps)
+    s.close()
+    status = int(data.split(b" ", 2)[1]) if data.startswith(b"HTTP/") else 0
+    return status, len(data)
+
+
+class Worker(threading.Thread):
+    def __init__(self, host, port, paths, slow_bps, stop):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.host, self.port, self.paths = host, port, paths
+        self.slow_bps, self.stop = slow_bps, stop
+        self.ok = self.failed = 0
+        self.latencies = []
+
+    def run(self):
+        i = 0
+        while not self.stop.is_set():
+            path = self.paths[i % len(self.paths)]
+            i += 1
+            start = time.time()
+            try:
+                status, _ = http_get(self.host, self.port, path, self.slow_bps)
+            except OSError:
+                status = 0
+            if status in (200, 304):
+                self.ok += 1
+                self.latencies.append(time.time() - start)
+            else:
+                self.failed += 1
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * pct / 100.0))]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--http-port", type=int, default=80)
+    ap.add_argument("--rtsp-port", type=int, default=8554)
+    ap.add_argument("--rtsp-path", default="mjpeg")
+    ap.add_argument("--paths", default="/api/status,/api/cam_settings,/snapshot.jpg")
+    ap.add_argument("--clients", type=int, default=8, help="concurrent HTTP workers")
+    ap.add_argument("--slow-bps", type=int, default=20000, help="read rate of the slow half")
+    ap.add_argument("--seconds", type=float, default=10)
+    args = ap.parse_args()
+
+    idle = rtsp_fps(args.host, args.rtsp_port, args.rtsp_path, args.seconds)
+
+    stop = threading.Event()
+    paths = args.paths.split(",")
+    workers = [Worker(args.host, args.http_port, paths, args.slow_bps if i % 2 else 0, stop)
+               for i in range(args.clients)]
+    for w in workers:
+        w.start()
+    time.sleep(1)                          # let the load ramp up
+    loaded = rtsp_fps(args.host, args.rtsp_port, args.rtsp_path, args.seconds)
+    stop.set()
+    for w in workers:
+        w.join(20)
+
+    latencies = [x for w in workers for x in w.latencies]
+    ok = sum(w.ok for w in workers)
+    print(json.dumps({
+        "rtsp_fps_idle": round(idle, 2),
+        "rtsp_fps_loaded": round(loaded, 2),
+        "fps_ratio": round(loaded / idle, 3) if idle else None,
+        "http_clients": args.clients,
+        "http_ok": ok,
+        "http_failed": sum(w.failed for w in workers),
+        "http_rps": round(ok / (args.seconds + 1), 1),
+        "http_p50_ms": round(percentile(latencies, 50) * 1000, 1),
+        "http_p95_ms": round(percentile(latencies, 95) * 1000, 1),
+    }))
+
+
+if __name__ == "__main__":
+    main()
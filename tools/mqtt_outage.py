@@ -0,0 +1,158 @@
+"""
+MQTT outage test: does a broker going away stall the RTSP stream?
+
+Runs tools/mqtt_standin.py as the broker and plays the RTSP stream while the
+broker goes through a schedule of phases:
+
+    up      running normally
+    down    killed: connects are refused
+    hung    restarted and then stopped (SIGSTOP): TCP connects still
+            complete in the kernel but CONNACK never comes
+
+Reports, per phase, RTSP fps, the longest gap between frames and when the
+device (re)connected, from the stand-in's log. Point the device's
+MQTT_SERVER/MQTT_PORT (or the simulator's --mqtt-host/--mqtt-port) at this
+machine, e.g.
+
+    .pio/build/native/program --frames <dir> --mqtt-port 18830 &
+    python tools/mqtt_outage.py --mqtt-port 18830 --rtsp-port 8554
+
+Prints one JSON object. Python 3 standard library only; POSIX signals.
+"""
+
+import argparse
+import json
+import os
+import signal
+import subprocess
+import sys
+import threading
+import time
+
+from http_load import rtsp_fps
+
+STANDIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "mqtt_standin.py")
+
+
+class Broker(object):
+    """The stand-in as a child process whose events we collect."""
+
+    def __init__(self, port):
+        self.port = port
+        self.proc = None
+        self.events = []              # (host time, event dict)
+        self.listening = threading.Event()
+
+    def start(self):
+        self.listening.clear()
+        self.proc = subprocess.Popen([sys.executable, STANDIN, "--port", str(self.port)],
+                                     stdout=subprocess.PIPE, universal_newlines=True)
+        t = threading.Thread(target=self._read, args=(self.proc,))
+        t.daemon = True
+        t.start()
+        if not self.listening.wait(5):
+            raise RuntimeError("mqtt_standin did not start")
+
+    def _read(self, proc):
+        for line in proc.stdout:
+            try:
+                ev = json.loads(line)
+            except ValueError:
+                continue
+            self.events.append((time.time(), ev))
+            if ev.get("event") == "listening":
+                self.listening.set()
+
+    def kill(self):
+        if self.proc:
+            self.proc.kill()
+            self.proc.wait()
+            self.proc = None
+
+    def stop(self):
+        self.proc.send_signal(signal.SIGSTOP)
+
+    def cont(self):
+        self.proc.send_signal(signal.SIGCONT)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="127.0.0.1", help="device/simulator (RTSP)")
+    ap.add_argument("--rtsp-port", type=int, default=8554)
+    ap.add_argument("--rtsp-path", default="mjpeg")
+    ap.add_argument("--mqtt-port", type=int, default=1883, help="port for the stand-in")
+    ap.add_argument("--phases", default="up:8,down:10,up:25,hung:10,up:25",
+                    help="comma-separated state:seconds")
+    args = ap.parse_args()
+
+    phases = [(p.split(":")[0], float(p.split(":")[1])) for p in args.phases.split(",")]
+    total = sum(s for _, s in phases)
+
+    broker = Broker(args.mqtt_port)
+    frames = []
+    result = {}
+
+    def play():
+        result["fps"] = rtsp_fps(args.host, args.rtsp_port, args.rtsp_path, total,
+                                 on_frame=frames.append)
+
+    broker.start()
+    player = threading.Thread(target=play)
+    player.daemon = True
+    player.start()
+
+    bounds = []
+    state = "up"
+    try:
+        for name, seconds in phases:
+            start = time.time()
+            if name == "up":
+                if state == "hung":
+                    broker.cont()
+                elif state == "down":
+                    broker.start()
+            elif name == "down":
+                if state == "hung":
+                    broker.cont()
+                broker.kill()
+            elif name == "hung":
+                if state == "hung":
+                    broker.cont()
+                broker.kill()
+                broker.start()
+                broker.stop()
+            else:
+                raise SystemExit("unknown phase %r" % name)
+            state = name
+            time.sleep(max(0.0, seconds - (time.time() - start)))
+            bounds.append((name, start, time.time()))
+        player.join(total + 10)
+    finally:
+        if state == "hung":
+            broker.cont()
+        broker.kill()
+
+    connects = [t for t, ev in broker.events if ev.get("event") == "connect"]
+    report = []
+    for name, start, end in bounds:
+        inside = [t for t in frames if start <= t < end]
+        gaps = [b - a for a, b in zip(inside, inside[1:])]
+        report.append({
+            "phase": name,
+            "seconds": round(end - start, 1),
+            "fps": round(len(inside) / (end - start), 2),
+            "max_gap_ms": round(max(gaps) * 1000, 1) if gaps else None,
+            "connects": [round(t - start, 2) for t in connects if start <= t < end],
+        })
+    gaps = [b - a for a, b in zip(frames, frames[1:])]
+    print(json.dumps({
+        "rtsp_fps": round(result.get("fps", 0), 2),
+        "max_gap_ms": round(max(gaps) * 1000, 1) if gaps else None,
+        "connects": len(connects),
+        "phases": report,
+    }, indent=1))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+"""
+Minimal MQTT 3.1.1 broker stand-in for testing the firmware's connection
+handling without mosquitto.
+
+Accepts any client: CONNECT gets CONNACK, SUBSCRIBE gets SUBACK, PINGREQ gets
+PINGRESP, PUBLISH (QoS 0/1) is acknowledged and logged but not routed to
+other clients. Each event is printed as one JSON line on stdout, e.g.
+
+    {"t": 12.031, "event": "connect", "client": "esp32_camera", "peer": "..."}
+    {"t": 17.002, "event": "publish", "topic": "/esp32cam/telemetry", "bytes": 812}
+
+Kill it (SIGKILL: connection refused) or stop it (SIGSTOP: the kernel still
+accepts TCP but nothing answers, like a hung broker) and restart/continue it
+to replay outages; tools/mqtt_outage.py does that on a schedule.
+
+    python tools/mqtt_standin.py --port 1883
+
+Python 3 standard library only.
+"""
+
+import argparse
+import json
+import socket
+import sys
+import threading
+import time
+
+START = time.time()
+LOCK = threading.Lock()
+
+
+def emit(event, **fields):
+    fields = dict(t=round(time.time() - START, 3), event=event, **fields)
+    with LOCK:
+        sys.stdout.write(json.dumps(fields) + "\n")
+        sys.stdout.flush()
+
+
+def read_exact(sock, n):
+    data = b""
+    while len(data) < n:
+        block = sock.recv(n - len(data))
+        if not block:
+            raise EOFError
+        data += block
+    return data
+
+
+def read_packet(sock):
+    """(type, flags, body) of the next control packet."""
+    first = read_exact(sock, 1)[0]
+    length, shift = 0, 0
+    while True:
+        b = read_exact(sock, 1)[0]
+        length |= (b & 0x7F) << shift
+        if not b & 0x80:
+            break
+        shift += 7
+    return first >> 4, first & 0x0F, read_exact(sock, length)
+
+
+def utf8_field(body, pos):
+    n = (body[pos] << 8) | body[pos + 1]
+    return body[pos + 2:pos + 2 + n].decode(errors="replace"), pos + 2 + n
+
+
+def serve(sock, peer):
+    client = None
+    try:
+        while True:
+            ptype, flags, body = read_packet(sock)
+            if ptype == 1:                                   # CONNECT
+                _, pos = utf8_field(body, 0)                 # "MQTT"
+                pos += 4                                     # level, flags, keepalive
+                client, _ = utf8_field(body, pos)
+                sock.sendall(b"\x20\x02\x00\x00")
+                emit("connect", client=client, peer=peer)
+            elif ptype == 3:                                 # PUBLISH
+                topic, pos = utf8_field(body, 0)
+                qos = (flags >> 1) & 3
+                if qos:
+                    pid = body[pos:pos + 2]
+                    pos += 2
+                    sock.sendall(b"\x40\x02" + pid)
+                emit("publish", client=client, topic=topic, bytes=len(body) - pos,
+                     retained=bool(flags & 1))
+            elif ptype == 8:                                 # SUBSCRIBE
+                pid, pos, granted = body[0:2], 2, b""
+                while pos < len(body):
+                    topic, pos = utf8_field(body, pos)
+                    granted += bytes([min(body[pos], 1)])
+                    pos += 1
+                    emit("subscribe", client=client, topic=topic)
+                sock.sendall(bytes([0x90, 2 + len(granted)]) + pid + granted)
+            elif ptype == 12:                                # PINGREQ
+                sock.sendall(b"\xd0\x00")
+            elif ptype == 14:                                # DISCONNECT
+                break
+    except (EOFError, OSError, IndexError):
+        pass
+    finally:
+        sock.close()
+        emit("disconnect", client=client, peer=peer)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=1883)
+    args = ap.parse_args()
+
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind((args.host, args.port))
+    srv.listen(8)
+    emit("listening", port=args.port)
+    while True:
+        sock, addr = srv.accept()
+        t = threading.Thread(target=serve, args=(sock, "%s:%d" % addr))
+        t.daemon = True
+        t.start()
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,232 @@
+const tzMap={"America/Los_Angeles":"PST8PDT,M3.2.0/2,M11.1.0/2"};
+let lastAutoSync=0;
+async function syncClock(){
+  const epoch=Math.floor(Date.now()/1000);
+  const browserIANA=Intl.DateTimeFormat().resolvedOptions().timeZone;
+  const posix=tzMap[browserIANA]||'UTC0';
+  await fetch('/api/sync_clock?epoch='+epoch+'&tz='+encodeURIComponent(posix));
+  await refreshStatus();
+}
+let status={};
+let pollTimer=null;
+async function refreshStatus(){
+  try{
+    const r=await fetch('/api/status');
+    if(!r.ok)return;
+    renderStatus(await r.json());
+    fetch('/ccd_raw').then(r=>r.text()).then(val=>{
+        const el=document.getElementById('ccd_raw');
+        if(el)el.textContent=val;
+    }).catch(()=>{});
+  }catch(e){}
+}
+function renderStatus(j){
+  try{
+    document.title='ESP32-CAM - '+j.device;
+    document.getElementById('title').textContent='ESP32-CAM '+j.device;
+    document.getElementById('device').textContent=j.device;
+    document.getElementById('hdr_ip').textContent=j.ip;
+    document.getElementById('ip').textContent=j.ip;
+    document.getElementById('uptime').textContent=j.uptime_s+' s';
+    document.getElementById('rssi').textContent=j.rssi_dbm+' dBm';
+    document.getElementById('heap').textContent=j.heap_free+' B';
+    document.getElementById('psram').textContent=j.psram_free+' B';
+    document.getElementById('stream_state').textContent=j.stream_on?'ON':'OFF';
+    document.getElementById('flash_state').textContent=j.flash_on?'ON':'OFF';
+    if(j.fps){
+      document.getElementById('fps_display').textContent=
+      (j.fps.target?j.fps.target:'max')+' / '+j.fps.actual.toFixed(1)+' fps';
+    }
+    const temp=document.body.dataset.tempFormat==='F'
+    ?j.cpu_temp_f.toFixed(1)+' °F'
+    :j.cpu_temp_c.toFixed(1)+' °C';
+    document.getElementById('cpu_temp_display').textContent=temp;
+    document.getElementById('hdr_temp').textContent=temp;
+    if(j.ccd_raw!==undefined){
+      const el=document.getElementById('ccd_raw');
+      if(el)el.textContent=j.ccd_raw;
+    }
+    if(j.esp_time!==undefined){
+      const espDate=new Date(j.esp_time*1000);
+      const browserDate=new Date();
+      document.getElementById('esp_time_display').textContent=espDate.toLocaleString();
+      document.getElementById('browser_time').textContent=browserDate.toLocaleString();
+      const delta=(Date.now()/1000 - j.esp_time);
+      document.getElementById('time_delta').textContent=delta.toFixed(1)+' s';
+      document.getElementById('cur_time').textContent=espDate.toLocaleString();
+      const absDelta=Math.abs(delta);
+      const nowMs=Date.now();
+      if(absDelta>2){
+        if(nowMs - lastAutoSync > 60000){
+          lastAutoSync=nowMs;
+          syncClock();
+        }
+      }
+    }
+  }catch(e){}
+}
+// Status pushed over /events: the full object first, then changed members.
+// Polling takes over while the stream is down or unsupported.
+function startPolling(){
+  if(!pollTimer)pollTimer=setInterval(refreshStatus,5000);
+}
+function startEvents(){
+  if(!window.EventSource){startPolling();return;}
+  const es=new EventSource('/events');
+  es.addEventListener('status',e=>{
+    Object.assign(status,JSON.parse(e.data));
+    renderStatus(status);
+  });
+  es.onopen=()=>{
+    if(pollTimer){clearInterval(pollTimer);pollTimer=null;}
+  };
+  es.onerror=()=>startPolling();
+}
+function refreshSnap(){
+  const img=document.getElementById('snap');
+  if(!img)return;
+  img.src='/snapshot.jpg?ts='+Date.now();
+}
+let snapTimer=null;
+function startPreview(){
+  const img=document.getElementById('snap');
+  if(!img)return;
+  img.onerror=()=>{
+    img.onerror=null;
+    refreshSnap();
+    if(!snapTimer)snapTimer=setInterval(refreshSnap,3000);
+  };
+  img.src='/stream';
+}
+async function loadSettings(){
+  try{
+    const r=await fetch('/api/get_settings');
+    if(!r.ok)return;
+    const j=await r.json();
+    document.getElementById('tz_display').textContent=j.timezone||'UTC0';
+    if(j.temp_format==='F'){
+      document.body.dataset.tempFormat='F';
+      document.getElementById('temp_mode_display').textContent='Fahrenheit';
+    }else{
+      document.body.dataset.tempFormat='C';
+      document.getElementById('temp_mode_display').textContent='Celsius';
+    }
+    document.getElementById('stream_default_display').textContent=j.stream_on?'ON':'OFF';
+    document.getElementById('fps_input').value=j.target_fps;
+  }catch(e){}
+}
+async function setBrowserTZ(){
+  const browserIANA=Intl.DateTimeFormat().resolvedOptions().timeZone;
+  const posix=tzMap[browserIANA]||'UTC0';
+  await fetch('/api/set_tz?tz='+encodeURIComponent(posix));
+  await loadSettings();
+}
+async function toggleTempMode(){
+  await fetch('/toggle_temp');
+  await loadSettings();
+  await refreshStatus();
+}
+async function setTargetFps(){
+  const v=parseInt(document.getElementById('fps_input').value)||0;
+  await fetch('/api/set_fps?fps='+v);
+  await loadSettings();
+}
+async function toggleStreamDefault(){
+  await fetch('/api/toggle_stream_default');
+  await loadSettings();
+}
+async function loadCameraControls(){
+  try{
+    const r=await fetch('/api/cam_settings');
+    if(!r.ok)return;
+    const s=await r.json();
+    let html='';
+    function addSlider(name,label,min,max){
+      html+='<div class="label">'+label+'</div>';
+      html+='<input type="range" min="'+min+'" max="'+max+'" value="'+s[name]+'" id="ctl_'+name+'">';
+    }
+    function addToggle(name,label){
+      const checked=s[name]?'checked':'';
+      html+='<div class="label">'+label+'</div>';
+      html+='<input type="checkbox" id="ctl_'+name+'" '+checked+'>';
+    }
+    html+='<div class="cam-group-title">Exposure</div>';
+    addSlider('ae_level','AE level',-2,2);
+    addSlider('aec_value','AEC value',0,1200);
+    addSlider('agc_gain','AGC gain',0,30);
+    addToggle('aec2','AEC2');
+    html+='<div class="cam-group-title">Color</div>';
+    addSlider('brightness','Brightness',-2,2);
+    addSlider('contrast','Contrast',-2,2);
+    addSlider('saturation','Saturation',-2,2);
+    addSlider('denoise','Denoise',0,8);
+    addToggle('awb','AWB');
+    addToggle('awb_gain','AWB gain');
+    html+='<div class="cam-group-title">Geometry</div>';
+    addToggle('hmirror','Horizontal mirror');
+    addToggle('vflip','Vertical flip');
+    html+='<div class="cam-group-title">Quality</div>';
+    addSlider('sharpness','Sharpness',-3,3);
+    addSlider('quality','JPEG quality',5,63);
+    html+='<div class="label">Framesize</div>';
+    html+='<select id="ctl_framesize">';
+    const fsOptions=[0,1,2,3,4,5,6,7,8,9];
+    for(let i=0;i<fsOptions.length;i++){
+      const f=fsOptions[i];
+      const sel=(s.framesize==f)?' selected':'';
+      html+='<option value="'+f+'"'+sel+'>'+f+'</option>';
+    }
+    html+='</select>';
+    document.getElementById('cam_ctrls').innerHTML=html;
+  }catch(e){console.log('cam ctrl error',e);}
+}
+async function applyCameraSettings(){
+  let payload={};
+  function grab(n){
+    let el=document.getElementById('ctl_'+n);
+    if(!el)return;
+    payload[n]=(el.type==='checkbox')?(el.checked?1:0):parseInt(el.value);
+  }
+  grab('brightness');
+  grab('contrast');
+  grab('saturation');
+  grab('sharpness');
+  grab('denoise');
+  grab('ae_level');
+  grab('aec_value');
+  grab('agc_gain');
+  grab('aec2');
+  grab('awb');
+  grab('awb_gain');
+  grab('hmirror');
+  grab('vflip');
+  grab('quality');
+  let fs=document.getElementById('ctl_framesize');
+  payload['framesize']=parseInt(fs.value);
+  await fetch('/api/set_cam_params',{
+      method:'POST',
+      headers:{'Content-Type':'application/json'},
+      body:JSON.stringify(payload)
+  });
+  loadCameraControls();
+}
+async function applyCamDefaults(){
+  await fetch('/api/cam_defaults');
+  loadCameraControls();
+}
+async function setCamParam(param,value){
+  await fetch('/api/set_cam_param?param='+param+'&value='+value);
+  loadCameraControls();
+}
+function setFlash(val){
+  fetch('/flash?val='+val).then(()=>refreshStatus());
+}
+function startStream(){fetch('/start').then(()=>refreshStatus());}
+function stopStream(){fetch('/stop').then(()=>refreshStatus());}
+window.addEventListener('load',()=>{
+    loadSettings();
+    refreshStatus();
+    startEvents();
+    startPreview();
+    loadCameraControls();
+});